@@ -7,6 +7,22 @@
  *   controls amount of information, the module will send to PHP error log. Accepts the following values in order of
  *   increasing verbosity: `"FATAL"`, `"ERROR"`, `"WARN"`, `"INFO"`, `"DEBUG"`, `"TRACE"`.
  *
+ * * `couchbase.log_format` (string), default: `"text"`
+ *
+ *   layout of the log messages. `"text"` keeps the traditional `[cb,LEVEL] (subsystem L:line) message` lines,
+ *   `"json"` writes one JSON object per line with `time` (ISO 8601 in `date.timezone`, microseconds), `level`,
+ *   `subsys`, `line`, `instance` and `msg` fields. When `error_log` points to a file, the JSON lines are appended
+ *   without the timestamp prefix of the PHP error log. Syslog and the SAPI loggers still wrap every line into their
+ *   own record format.
+ *
+ * * `couchbase.log_buffer_size` (long), default: `0`
+ *
+ *   size of the buffer in bytes, where log messages are collected before writing them to the PHP error log. The buffer
+ *   is flushed at the end of each request, and when the next message does not fit into it. If `error_log` points to a
+ *   file, the whole batch is appended with single write, and the messages, which could not be written, are counted and
+ *   reported with a warning on the next flush. The default `0` writes every message immediately. Can be set only in
+ *   `php.ini`.
+ *
  * * `couchbase.encoder.format` (string), default: `"json"`
  *
  *   selects serialization format for default encoder (\Couchbase\defaultEncoder). Accepts the following values:
@@ -15,6 +31,11 @@
  *      necessary, use `new stdClass()` to persist empty JSON object. Note, that only JSON format considered supported by
  *      all Couchbase SDKs, everything else is private implementation (i.e. `"php"` format won't be readable by .NET SDK).
  *   * `"php"` - uses PHP serialize() method to encode the document.
+ *   * `"igbinary"` - uses igbinary_serialize() from pecl/igbinary, which is faster and more compact than `"php"` for
+ *     large object graphs. Available if pecl/igbinary was installed during build phase (\Couchbase\HAVE_IGBINARY).
+ *     The documents use the same flags as the legacy SDK (`COUCHBASE_VAL_IS_IGBINARY`), so both can read them.
+ *   * `"msgpack"` - uses MessagePack serializer from pecl/msgpack. Available if pecl/msgpack was installed during
+ *     build phase (\Couchbase\HAVE_MSGPACK). The documents are flagged with `COUCHBASE_VAL_IS_MSGPACK`.
  *
  * * `couchbase.encoder.compression` (string), default: `"none"`
  *
@@ -23,6 +44,12 @@
  *     othewise vendored version will be used. This algorithm is always available.
  *   * `"zlib"` - uses compression implemented by libz. Might not be available, if the system didn't have libz headers
  *     during build phase. In this case \Couchbase\HAVE_ZLIB will be false.
+ *   * `"lz4"` - uses LZ4 from liblz4. Decompression is the fastest of all methods, which suits latency-sensitive
+ *     reads. Might not be available, if the system didn't have liblz4 headers during build phase. In this case
+ *     \Couchbase\HAVE_LZ4 will be false.
+ *   * `"zstd"` - uses Zstandard from libzstd, optionally with a trained dictionary (see
+ *     `couchbase.encoder.zstd_dictionary`). Might not be available, if the system didn't have libzstd headers during
+ *     build phase. In this case \Couchbase\HAVE_ZSTD will be false.
  *   * `"off"` or `"none"` - compression will be disabled, but the library will still read compressed values.
  *
  * * `couchbase.encoder.compression_threshold` (long), default: `0`
@@ -36,6 +63,38 @@
  *   bytes. For example, the original document consists of 100 bytes. In this case factor 1.0 will require compressor
  *   to yield values not larger than 100 bytes (100/1.0), and 1.5 -- not larger than 66 bytes (100/1.5).
  *
+ * * `couchbase.encoder.compression_sample` (long), default: `0`
+ *
+ *   size in bytes of the prefix, which is compressed first to predict whether the whole value will pass
+ *   `couchbase.encoder.compression_factor` (but at least 1.0). If the prefix does not get smaller, the value is stored
+ *   uncompressed without spending the full compression pass on it. Applied to values at least twice as large as the
+ *   sample. `0` disables sampling. The decisions are counted in \Couchbase\Metrics::snapshot().
+ *
+ * * `couchbase.encoder.zstd_level` (long), default: `3`
+ *
+ *   compression level for `"zstd"` method, from 1 (fastest) to 19 (smallest).
+ *
+ * * `couchbase.encoder.zstd_dictionary` (string), default: `""`
+ *
+ *   path to the dictionary trained with `zstd --train` on sample documents. It improves the ratio for small documents
+ *   with similar structure. The same dictionary must be configured on every reader of these documents.
+ *
+ * * `couchbase.compression.snappy` (string), default: `"on"`
+ *
+ *   controls Snappy compression of the document bodies, which is negotiated with the server. Unlike
+ *   `couchbase.encoder.compression`, the documents are stored with the Snappy datatype and can be read by any SDK.
+ *   Accepts `"on"` (compress outgoing values and accept compressed ones), `"off"` and `"force"` (compress even if the
+ *   server did not advertise Snappy). The `compression` option of the connection string takes precedence.
+ *
+ * * `couchbase.compression.min_size` (long), default: `-1`
+ *
+ *   values shorter than this number of bytes are sent uncompressed. `-1` keeps the default of libcouchbase (32 bytes).
+ *
+ * * `couchbase.compression.min_ratio` (float), default: `0`
+ *
+ *   compressed value is sent only when its size divided by the original size does not exceed this ratio. `0` keeps the
+ *   default of libcouchbase (0.83).
+ *
  * * `couchbase.decoder.json_arrays` (boolean), default: `false`
  *
  *   controls the form of the documents, returned by the server if they were in JSON format. When true, it will generate
@@ -47,6 +106,37 @@
  *   operations. All connections which idle more than this interval will be closed automatically. Cleanup function
  *   executed after each request using RSHUTDOWN hook.
  *
+ * * `couchbase.pool.check_interval_sec` (long), default: `1`
+ *
+ *   controls how often the cleanup function looks for the expired idle connections. Zero means after every request.
+ *   The setting is ignored when `couchbase.pool.max_idle_time_sec` is zero.
+ *
+ * * `couchbase.pool.instances_per_key` (long), default: `2`
+ *
+ *   maximum number of pooled connections with the same connection string and credentials. The additional instances
+ *   are created only when all existing ones are busy, for example when the library is called again from a destructor
+ *   while it waits for the network. If all instances are busy, a temporary connection is created and closed as soon as
+ *   it is released.
+ *
+ * * `couchbase.pool.prewarm` (string), default: `""`
+ *
+ *   list of connections to bootstrap at the beginning of the first request of every worker process. The connections are
+ *   opened without waiting for the cluster, so that the first use by the script waits only for the rest of the
+ *   bootstrap, and the following requests find the connections in the pool. Entries are separated by `;` and have the
+ *   form `connstr|username|password`, for example `couchbase://127.0.0.1/travel-sample|Administrator|password`. Only
+ *   the cluster connection is prewarmed, the bucket is opened on it by the first `Cluster::bucket()`. The outcome is
+ *   shown by `phpinfo()`, where the passwords are masked. Prewarmed connections are subject to
+ *   `couchbase.pool.max_idle_time_sec` as any other. Ignored by CLI.
+ *
+ * * `couchbase.pool.prewarm_jitter_ms` (long), default: `50`
+ *
+ *   maximum random delay before the prewarm, so that the workers started at the same time do not bootstrap together.
+ *
+ * * `couchbase.metrics.log_on_shutdown` (boolean), default: `false`
+ *
+ *   writes the latency histograms of \Couchbase\Metrics::snapshot() into the log at the end of every request. The
+ *   lines are logged with `"INFO"` level, so `couchbase.log_level` has to be at least `"INFO"` to see them.
+ *
  * @package Couchbase
  */
 
@@ -137,6 +227,11 @@ namespace Couchbase {
 
     interface GetResult extends Result
     {
+        /**
+         * Returns the document body. It is decoded on the first call, and the later calls return the same value
+         * without parsing the body again. The result object is immutable, so the cached value is released only
+         * together with the object. Modifying the returned array does not affect the cached value.
+         */
         public function content(): ?array;
     }
 
@@ -220,6 +315,9 @@ namespace Couchbase {
         {
         }
 
+        /**
+         * Returns the document included with ViewOptions::includeDocuments(), decoding it on the first call.
+         */
         public function document()
         {
         }
@@ -379,6 +477,17 @@ namespace Couchbase {
         {
         }
 
+        /**
+         * Schedules the query without waiting for the response. The rows are collected into the result of the
+         * future, so the streaming options are ignored.
+         *
+         * @see Cluster::query()
+         * @return Future resolving to QueryResult
+         */
+        public function queryAsync(string $statement, QueryOptions $options = null): Future
+        {
+        }
+
         public function analyticsQuery(string $statement, AnalyticsOptions $options = null)
         {
         }
@@ -387,6 +496,17 @@ namespace Couchbase {
         {
         }
 
+        /**
+         * Schedules the search query without waiting for the response. The hits are collected into the result of
+         * the future, so the streaming options are ignored.
+         *
+         * @see Cluster::searchQuery()
+         * @return Future resolving to SearchResult
+         */
+        public function searchQueryAsync(string $indexName, SearchQuery $query, SearchOptions $options = null): Future
+        {
+        }
+
         public function queryIndexes(): QueryIndexManager
         {
         }
@@ -448,10 +568,36 @@ namespace Couchbase {
         {
         }
 
+        /**
+         * Schedules fetching of the document and returns immediately. The operation is sent to the network
+         * with the next Bucket::wait(), Bucket::waitAny(), Future::wait() or Future::isReady() call.
+         *
+         * @return Future resolving to GetResult
+         */
+        public function getAsync(string $id, GetOptions $options = null): Future
+        {
+        }
+
+        /**
+         * Fetches several documents using single network round trip.
+         *
+         * @return array map of document ID to GetResult, or to the exception instance for the IDs failed to fetch
+         */
+        public function getMulti(array $ids, GetOptions $options = null): array
+        {
+        }
+
         public function exists(string $id, ExistsOptions $options = null): ExistsResult
         {
         }
 
+        /**
+         * @return array map of document ID to ExistsResult, or to the exception instance for the failed IDs
+         */
+        public function existsMulti(array $ids, ExistsOptions $options = null): array
+        {
+        }
+
         public function getAndLock(string $id, int $lockTime, GetAndLockOptions $options = null): GetResult
         {
         }
@@ -480,10 +626,53 @@ namespace Couchbase {
         {
         }
 
+        /**
+         * @see Collection::getAsync()
+         * @return Future resolving to MutationResult
+         */
+        public function upsertAsync(string $id, $value, UpsertOptions $options = null): Future
+        {
+        }
+
+        /**
+         * Stores several documents using single network round trip. Expiry, durability level and timeout of the
+         * options are applied to every document, CAS is ignored. When the transcoder throws for the document, its
+         * exception becomes the result of that ID, and the rest of the batch is stored.
+         *
+         * @param array $documents map of document ID to value
+         * @return array map of document ID to StoreResult, or to the exception instance for the IDs failed to store
+         */
+        public function upsertMulti(array $documents, UpsertOptions $options = null): array
+        {
+        }
+
+        /**
+         * @see Collection::upsertMulti()
+         */
+        public function insertMulti(array $documents, InsertOptions $options = null): array
+        {
+        }
+
+        /**
+         * @see Collection::upsertMulti()
+         */
+        public function replaceMulti(array $documents, ReplaceOptions $options = null): array
+        {
+        }
+
         public function remove(string $id, RemoveOptions $options = null): MutationResult
         {
         }
 
+        /**
+         * Removes several documents using single network round trip. CAS of the options is ignored.
+         *
+         * @return array map of document ID to MutationResult, or to the exception instance for the failed IDs
+         */
+        public function removeMulti(array $ids, RemoveOptions $options = null): array
+        {
+        }
+
         public function unlock(string $id, string $cas, UnlockOptions $options = null): Result
         {
         }
@@ -492,6 +681,13 @@ namespace Couchbase {
         {
         }
 
+        /**
+         * @return array map of document ID to MutationResult, or to the exception instance for the failed IDs
+         */
+        public function touchMulti(array $ids, int $expiry, TouchOptions $options = null): array
+        {
+        }
+
         public function lookupIn(string $id, array $specs, LookupInOptions $options = null): LookupInResult
         {
         }
@@ -561,6 +757,161 @@ namespace Couchbase {
         public function diagnostics($reportId)
         {
         }
+
+        /**
+         * Waits for all given futures to complete.
+         *
+         * @param Future[] $futures
+         * @return array map of the keys of $futures to results, or to the exception instance for the failed operations
+         */
+        public function wait(array $futures): array
+        {
+        }
+
+        /**
+         * Waits for at least one of the given futures to complete.
+         *
+         * @param Future[] $futures
+         * @return int|string key of the completed future in $futures
+         */
+        public function waitAny(array $futures)
+        {
+        }
+    }
+
+    /**
+     * Persistent connections of the current process (or thread in ZTS build)
+     */
+    final class Pool
+    {
+        final private function __construct()
+        {
+        }
+
+        /**
+         * Returns counters of the connection pool:
+         *
+         * * `hits` - connections reused from the pool
+         * * `misses` - connections bootstrapped because the pool did not have one
+         * * `evictions` - connections closed after `couchbase.pool.max_idle_time_sec` of inactivity
+         * * `live` - connections currently in the pool
+         * * `idle` - connections in the pool, which are not used by any object
+         * * `busy` - lookups that skipped a pooled connection because it was waiting for the network
+         * * `shared` - buckets served by the connection of the cluster instead of a dedicated one
+         *
+         * @return array
+         */
+        public static function stats(): array
+        {
+        }
+    }
+
+    /**
+     * Latency histograms of the operations executed by the current process (or thread in ZTS build)
+     */
+    final class Metrics
+    {
+        final private function __construct()
+        {
+        }
+
+        /**
+         * Returns latency statistics keyed by operation (`get`, `upsert`, `query`, `search`, `view`, `analytics`,
+         * `http`) and then by outcome (`success`, `timeout`, `error`). Outcomes, which were not observed yet, are
+         * omitted. Every entry has `count`, `min_us`, `mean_us`, `p50_us`, `p90_us`, `p99_us`, `p999_us` and
+         * `max_us` fields, where percentiles are accurate within 12.5%.
+         *
+         * The `compression` entry counts decisions of the default encoder for the values above
+         * `couchbase.encoder.compression_threshold`: `attempts`, `compressed`, `rejected` (compressed, but the result
+         * was not small enough), `skipped` (rejected by the sample, see `couchbase.encoder.compression_sample`), and
+         * `bytes_in`/`bytes_out` of the stored compressed values.
+         *
+         * `get` and `upsert` cover Collection::get()/upsert(), their `*Multi()` variants, where every document is
+         * recorded separately, and their `*Async()` variants. The other KV operations (insert, replace, lookupIn,
+         * etc.) are not recorded. `query` and `search` include Cluster::queryAsync() and searchQueryAsync().
+         *
+         * The latency of asynchronous operations covers the time until the response is received, regardless when
+         * the application waits for the future. The latency of streaming results covers the time until the last row
+         * is received, including the time the application spent iterating over the rows.
+         *
+         * @param bool $reset clear the histograms after taking the snapshot
+         * @return array
+         */
+        public static function snapshot(bool $reset = false): array
+        {
+        }
+    }
+
+    /**
+     * Pending result of the asynchronous operation, like Collection::getAsync()
+     */
+    final class Future
+    {
+        final private function __construct()
+        {
+        }
+
+        /**
+         * Checks the completion without blocking, giving the network a chance to make progress.
+         */
+        public function isReady(): bool
+        {
+        }
+
+        /**
+         * Blocks until the operation completes.
+         *
+         * @return mixed result of the operation
+         * @throws BaseException if the operation has failed
+         */
+        public function wait()
+        {
+        }
+    }
+
+    /**
+     * Rows of the streaming result, fetched from the network while iterating.
+     *
+     * The stream keeps at most the configured window of decoded rows in memory. Metadata of the result becomes
+     * available once the last row has been consumed.
+     *
+     * @see QueryOptions::streaming()
+     */
+    final class RowStream implements \Iterator
+    {
+        final private function __construct()
+        {
+        }
+
+        /**
+         * The stream can be traversed only once, so rewinding after the first row throws.
+         */
+        public function rewind()
+        {
+        }
+
+        public function valid(): bool
+        {
+        }
+
+        public function current()
+        {
+        }
+
+        public function key(): int
+        {
+        }
+
+        public function next()
+        {
+        }
+
+        /**
+         * Whether the server has sent all rows and the metadata of the result.
+         */
+        public function isCompleted(): bool
+        {
+        }
     }
 
     class MutationState
@@ -607,6 +958,17 @@ namespace Couchbase {
         public function scanConsistency(string $arg): AnalyticsOptions
         {
         }
+
+        /**
+         * Do not buffer rows of the result, but fetch them while the result is iterated.
+         *
+         * @param bool $enabled
+         * @param int $rowWindow maximum number of decoded rows kept in memory
+         * @see QueryOptions::streaming()
+         */
+        public function streaming(bool $enabled, int $rowWindow = 0): AnalyticsOptions
+        {
+        }
     }
 
     interface LookupInSpec
@@ -832,6 +1194,19 @@ namespace Couchbase {
         public function highlight(string $style = null, array $fields = null): SearchOptions
         {
         }
+
+        /**
+         * Do not buffer hits of the result, but fetch them while the result is iterated.
+         *
+         * Metadata and facets become available once the last hit has been consumed.
+         *
+         * @param bool $enabled
+         * @param int $rowWindow maximum number of decoded hits kept in memory
+         * @see QueryOptions::streaming()
+         */
+        public function streaming(bool $enabled, int $rowWindow = 0): SearchOptions
+        {
+        }
     }
 
     interface SearchHighlightMode
@@ -2045,6 +2420,21 @@ namespace Couchbase {
         public function raw(string $key, $value): ViewOptions
         {
         }
+
+        /**
+         * Do not buffer rows of the result, but fetch them while the result is iterated.
+         *
+         * Unlike queries, views are streamed on the connection of the bucket. Any other blocking operation on the
+         * same bucket (or on the cluster, which shares its connection) executed inside the loop receives the rest of
+         * the rows, and they are buffered regardless of the window.
+         *
+         * @param bool $enabled
+         * @param int $rowWindow maximum number of decoded rows kept in memory
+         * @see QueryOptions::streaming()
+         */
+        public function streaming(bool $enabled, int $rowWindow = 0): ViewOptions
+        {
+        }
     }
 
     interface ViewConsistency
@@ -2121,6 +2511,22 @@ namespace Couchbase {
         public function metrics(bool $arg): QueryOptions
         {
         }
+
+        /**
+         * Do not buffer rows of the result, but fetch them while the result is iterated.
+         *
+         * In streaming mode QueryResult::rows() returns null, and rows have to be consumed with foreach.
+         *
+         * Streamed query, search and analytics results use a pooled connection of their own, which is not shared
+         * with buckets or other requests. Operations executed inside the loop, like Collection::upsert() for every
+         * row, therefore do not fetch the rest of the result, and the window still bounds the memory.
+         *
+         * @param bool $enabled
+         * @param int $rowWindow maximum number of decoded rows kept in memory
+         */
+        public function streaming(bool $enabled, int $rowWindow = 0): QueryOptions
+        {
+        }
     }
 
     interface QueryScanConsistency
@@ -4,6 +4,12 @@ PHP_ARG_WITH(couchbase, whether to enable Couchbase support,
 PHP_ARG_WITH(system-fastlz, wheter to use system FastLZ library,
     [  --with-system-fastlz   Use system FastLZ library], no, no)
 
+PHP_ARG_ENABLE(couchbase-igbinary, whether to enable igbinary serializer,
+    [  --disable-couchbase-igbinary   Do not use igbinary serializer even if it is installed], yes, no)
+
+PHP_ARG_ENABLE(couchbase-msgpack, whether to enable msgpack serializer,
+    [  --disable-couchbase-msgpack   Do not use msgpack serializer even if it is installed], yes, no)
+
 if test "$PHP_COUCHBASE" != "no"; then
   AC_MSG_CHECKING(for libcouchbase in default path and $PHP_COUCHBASE)
   if test -r $PHP_COUCHBASE/include/libcouchbase/couchbase.h; then
@@ -77,7 +83,9 @@ COUCHBASE_FILES=" \
     src/couchbase/cluster_manager/user_settings.c \
     src/couchbase/cluster_options.c \
     src/couchbase/collection.c \
+    src/couchbase/future.c \
     src/couchbase/log_formatter.c \
+    src/couchbase/metrics.c \
     src/couchbase/lookup_spec.c \
     src/couchbase/mutate_spec.c \
     src/couchbase/mutation_state.c \
@@ -89,6 +97,7 @@ COUCHBASE_FILES=" \
     src/couchbase/query_index_manager/n1ix_drop.c \
     src/couchbase/query_index_manager/n1ix_list.c \
     src/couchbase/result.c \
+    src/couchbase/row_stream.c \
     src/couchbase/search/boolean_field_query.c \
     src/couchbase/search/boolean_query.c \
     src/couchbase/search/conjunction_query.c \
@@ -131,6 +140,45 @@ COUCHBASE_FILES=" \
     PHP_ADD_LIBRARY(z, 1, COUCHBASE_SHARED_LIBADD)],
     [AC_MSG_WARN(zlib library not found)])
 
+  dnl LZ4 and zstd are enabled only when both the header and the library are installed, the runtime package alone
+  dnl is not enough to build the extension
+  AC_CHECK_HEADER([lz4.h], [
+    PHP_CHECK_LIBRARY(lz4, LZ4_compress_default, [
+      AC_DEFINE(HAVE_COUCHBASE_LZ4,1,[Whether LZ4 compressor is enabled])
+      PHP_ADD_LIBRARY(lz4, 1, COUCHBASE_SHARED_LIBADD)],
+      [AC_MSG_WARN(LZ4 library not found)])],
+    [AC_MSG_WARN(LZ4 header not found)])
+
+  AC_CHECK_HEADER([zstd.h], [
+    PHP_CHECK_LIBRARY(zstd, ZSTD_createCDict, [
+      AC_DEFINE(HAVE_COUCHBASE_ZSTD,1,[Whether zstd compressor is enabled])
+      PHP_ADD_LIBRARY(zstd, 1, COUCHBASE_SHARED_LIBADD)],
+      [AC_MSG_WARN(zstd library not found)])],
+    [AC_MSG_WARN(zstd header not found)])
+
+  dnl igbinary and msgpack are PHP extensions, so their headers are installed along with PHP headers
+  if test "$PHP_COUCHBASE_IGBINARY" != "no"; then
+    AC_MSG_CHECKING([for igbinary headers])
+    if test -f "$phpincludedir/ext/igbinary/igbinary.h" || test -f "$abs_srcdir/ext/igbinary/igbinary.h"; then
+      AC_MSG_RESULT([found])
+      AC_DEFINE(HAVE_COUCHBASE_IGBINARY,1,[Whether igbinary serializer is enabled])
+      PHP_ADD_EXTENSION_DEP(couchbase, igbinary)
+    else
+      AC_MSG_RESULT([not found])
+    fi
+  fi
+
+  if test "$PHP_COUCHBASE_MSGPACK" != "no"; then
+    AC_MSG_CHECKING([for msgpack headers])
+    if test -f "$phpincludedir/ext/msgpack/php_msgpack.h" || test -f "$abs_srcdir/ext/msgpack/php_msgpack.h"; then
+      AC_MSG_RESULT([found])
+      AC_DEFINE(HAVE_COUCHBASE_MSGPACK,1,[Whether msgpack serializer is enabled])
+      PHP_ADD_EXTENSION_DEP(couchbase, msgpack)
+    else
+      AC_MSG_RESULT([not found])
+    fi
+  fi
+
   if test "$PHP_SYSTEM_FASTLZ" != "no"; then
     AC_CHECK_HEADERS([fastlz.h])
     PHP_CHECK_LIBRARY(fastlz, fastlz_compress,
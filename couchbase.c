@@ -16,6 +16,8 @@
 
 #include "couchbase.h"
 #include <ext/standard/info.h>
+#include <ext/standard/html.h>
+#include <main/SAPI.h>
 
 #ifdef HAVE_FASTLZ_H
 #include <fastlz.h>
@@ -23,8 +25,16 @@
 #include "fastlz/fastlz.h"
 #endif
 
-#if HAVE_COUCHBASE_ZLIB
-#include <zlib.h>
+#if HAVE_COUCHBASE_LZ4
+#include <lz4.h>
+#endif
+
+#if HAVE_COUCHBASE_IGBINARY
+#include <ext/igbinary/igbinary.h>
+#endif
+
+#if HAVE_COUCHBASE_MSGPACK
+#include <ext/msgpack/php_msgpack.h>
 #endif
 
 #define LOGARGS(lvl) LCB_LOG_##lvl, NULL, "pcbc/ext", __FILE__, __LINE__
@@ -44,11 +54,14 @@ ZEND_DECLARE_MODULE_GLOBALS(couchbase)
 #define COUCHBASE_SERTYPE_JSON 0
 #define COUCHBASE_SERTYPE_IGBINARY 1
 #define COUCHBASE_SERTYPE_PHP 2
+#define COUCHBASE_SERTYPE_MSGPACK 3
 #define DEFAULT_COUCHBASE_SERTYPE COUCHBASE_SERTYPE_JSON
 
 #define COUCHBASE_CMPRTYPE_NONE 0
 #define COUCHBASE_CMPRTYPE_ZLIB 1
 #define COUCHBASE_CMPRTYPE_FASTLZ 2
+#define COUCHBASE_CMPRTYPE_LZ4 3
+#define COUCHBASE_CMPRTYPE_ZSTD 4
 #define DEFAULT_COUCHBASE_CMPRTYPE COUCHBASE_CMPRTYPE_NONE
 
 #define DEFAULT_COUCHBASE_CMPRTHRESH 0
@@ -62,11 +75,14 @@ ZEND_DECLARE_MODULE_GLOBALS(couchbase)
 #define COUCHBASE_VAL_IS_SERIALIZED 0x04
 #define COUCHBASE_VAL_IS_IGBINARY 0x05
 #define COUCHBASE_VAL_IS_JSON 0x06
+#define COUCHBASE_VAL_IS_MSGPACK 0x07
 
 #define COUCHBASE_COMPRESSION_MASK 0x07 << 5
 #define COUCHBASE_COMPRESSION_NONE 0x00 << 5
 #define COUCHBASE_COMPRESSION_ZLIB 0x01 << 5
 #define COUCHBASE_COMPRESSION_FASTLZ 0x02 << 5
+#define COUCHBASE_COMPRESSION_LZ4 0x03 << 5
+#define COUCHBASE_COMPRESSION_ZSTD 0x04 << 5
 #define COUCHBASE_COMPRESSION_MCISCOMPRESSED 0x01 << 4
 
 #define COUCHBASE_CFFMT_MASK 0xFF << 24
@@ -104,6 +120,22 @@ static PHP_INI_MH(OnUpdateLogLevel)
     return OnUpdateString(entry, new_value, mh_arg1, mh_arg2, mh_arg3, stage);
 }
 
+static PHP_INI_MH(OnUpdateLogFormat)
+{
+    const char *str_val = ZSTR_VAL(new_value);
+    if (!new_value) {
+        PCBCG(log_json) = 0;
+    } else if (!strcmp(str_val, "text") || !strcmp(str_val, "TEXT")) {
+        PCBCG(log_json) = 0;
+    } else if (!strcmp(str_val, "json") || !strcmp(str_val, "JSON")) {
+        PCBCG(log_json) = 1;
+    } else {
+        return FAILURE;
+    }
+
+    return OnUpdateString(entry, new_value, mh_arg1, mh_arg2, mh_arg3, stage);
+}
+
 static PHP_INI_MH(OnUpdateFormat)
 {
     const char *str_val = ZSTR_VAL(new_value);
@@ -113,6 +145,14 @@ static PHP_INI_MH(OnUpdateFormat)
         PCBCG(enc_format_i) = COUCHBASE_SERTYPE_JSON;
     } else if (!strcmp(str_val, "php") || !strcmp(str_val, "PHP")) {
         PCBCG(enc_format_i) = COUCHBASE_SERTYPE_PHP;
+#if HAVE_COUCHBASE_IGBINARY
+    } else if (!strcmp(str_val, "igbinary") || !strcmp(str_val, "IGBINARY")) {
+        PCBCG(enc_format_i) = COUCHBASE_SERTYPE_IGBINARY;
+#endif
+#if HAVE_COUCHBASE_MSGPACK
+    } else if (!strcmp(str_val, "msgpack") || !strcmp(str_val, "MSGPACK")) {
+        PCBCG(enc_format_i) = COUCHBASE_SERTYPE_MSGPACK;
+#endif
     } else {
         return FAILURE;
     }
@@ -134,21 +174,107 @@ static PHP_INI_MH(OnUpdateCmpr)
 #endif
     } else if (!strcmp(str_val, "fastlz") || !strcmp(str_val, "FASTLZ")) {
         PCBCG(enc_cmpr_i) = COUCHBASE_CMPRTYPE_FASTLZ;
+#if HAVE_COUCHBASE_LZ4
+    } else if (!strcmp(str_val, "lz4") || !strcmp(str_val, "LZ4")) {
+        PCBCG(enc_cmpr_i) = COUCHBASE_CMPRTYPE_LZ4;
+#endif
+#if HAVE_COUCHBASE_ZSTD
+    } else if (!strcmp(str_val, "zstd") || !strcmp(str_val, "ZSTD")) {
+        PCBCG(enc_cmpr_i) = COUCHBASE_CMPRTYPE_ZSTD;
+#endif
     } else {
         return FAILURE;
     }
 
     return OnUpdateString(entry, new_value, mh_arg1, mh_arg2, mh_arg3, stage);
 }
+static PHP_INI_MH(OnUpdateSnappy)
+{
+    const char *str_val = ZSTR_VAL(new_value);
+    if (!new_value) {
+        PCBCG(snappy_mode) = LCB_COMPRESS_INOUT;
+    } else if (!strcmp(str_val, "on") || !strcmp(str_val, "ON")) {
+        PCBCG(snappy_mode) = LCB_COMPRESS_INOUT;
+    } else if (!strcmp(str_val, "off") || !strcmp(str_val, "OFF")) {
+        PCBCG(snappy_mode) = LCB_COMPRESS_NONE;
+    } else if (!strcmp(str_val, "force") || !strcmp(str_val, "FORCE")) {
+        PCBCG(snappy_mode) = LCB_COMPRESS_INOUT | LCB_COMPRESS_FORCE;
+    } else {
+        return FAILURE;
+    }
+
+    return OnUpdateString(entry, new_value, mh_arg1, mh_arg2, mh_arg3, stage);
+}
+
+/* phpinfo() shows couchbase.pool.prewarm with the passwords masked */
+static PHP_INI_DISP(DisplayPrewarm)
+{
+    zend_string *value = ini_entry->value;
+    smart_str masked = {0};
+    const char *entry, *end;
+
+    if (type == ZEND_INI_DISPLAY_ORIGINAL && ini_entry->modified) {
+        value = ini_entry->orig_value;
+    }
+    if (value == NULL || ZSTR_LEN(value) == 0) {
+        PUTS(sapi_module.phpinfo_as_text ? "no value" : "<i>no value</i>");
+        return;
+    }
+    for (entry = ZSTR_VAL(value); *entry; entry = *end ? end + 1 : end) {
+        const char *username, *password = NULL;
+
+        end = strchr(entry, ';');
+        if (end == NULL) {
+            end = entry + strlen(entry);
+        }
+        username = memchr(entry, '|', end - entry);
+        if (username) {
+            password = memchr(username + 1, '|', end - username - 1);
+        }
+        if (password) {
+            smart_str_appendl(&masked, entry, password - entry + 1);
+            smart_str_appendl(&masked, "***", 3);
+        } else {
+            smart_str_appendl(&masked, entry, end - entry);
+        }
+        if (*end) {
+            smart_str_appendc(&masked, ';');
+        }
+    }
+    smart_str_0(&masked);
+    if (sapi_module.phpinfo_as_text) {
+        PHPWRITE(PCBC_SMARTSTR_VAL(masked), PCBC_SMARTSTR_LEN(masked));
+    } else {
+        zend_string *escaped = php_escape_html_entities((unsigned char *)PCBC_SMARTSTR_VAL(masked),
+                                                        PCBC_SMARTSTR_LEN(masked), 0, ENT_QUOTES, NULL);
+        PHPWRITE(ZSTR_VAL(escaped), ZSTR_LEN(escaped));
+        zend_string_release(escaped);
+    }
+    smart_str_free(&masked);
+}
+
 // clang-format off
 PHP_INI_BEGIN()
 STD_PHP_INI_ENTRY("couchbase.log_level",                     "WARN", PHP_INI_ALL, OnUpdateLogLevel,   log_level,           zend_couchbase_globals, couchbase_globals)
+STD_PHP_INI_ENTRY("couchbase.log_format",                    "text", PHP_INI_ALL, OnUpdateLogFormat,  log_format,          zend_couchbase_globals, couchbase_globals)
+STD_PHP_INI_ENTRY("couchbase.log_buffer_size",               "0",    PHP_INI_SYSTEM, OnUpdateLongGEZero, log_buffer_size,  zend_couchbase_globals, couchbase_globals)
 STD_PHP_INI_ENTRY("couchbase.encoder.format",                "json", PHP_INI_ALL, OnUpdateFormat,     enc_format,          zend_couchbase_globals, couchbase_globals)
 STD_PHP_INI_ENTRY("couchbase.encoder.compression",           "off",  PHP_INI_ALL, OnUpdateCmpr,       enc_cmpr ,           zend_couchbase_globals, couchbase_globals)
 STD_PHP_INI_ENTRY("couchbase.encoder.compression_threshold", "0",    PHP_INI_ALL, OnUpdateLongGEZero, enc_cmpr_threshold,  zend_couchbase_globals, couchbase_globals)
 STD_PHP_INI_ENTRY("couchbase.encoder.compression_factor",    "0.0",  PHP_INI_ALL, OnUpdateReal,       enc_cmpr_factor,     zend_couchbase_globals, couchbase_globals)
+STD_PHP_INI_ENTRY("couchbase.compression.snappy",            "on",   PHP_INI_SYSTEM, OnUpdateSnappy,  snappy,              zend_couchbase_globals, couchbase_globals)
+STD_PHP_INI_ENTRY("couchbase.compression.min_size",          "-1",   PHP_INI_SYSTEM, OnUpdateLong,    snappy_min_size,     zend_couchbase_globals, couchbase_globals)
+STD_PHP_INI_ENTRY("couchbase.compression.min_ratio",         "0",    PHP_INI_SYSTEM, OnUpdateReal,    snappy_min_ratio,    zend_couchbase_globals, couchbase_globals)
+STD_PHP_INI_ENTRY("couchbase.encoder.compression_sample",    "0",    PHP_INI_ALL, OnUpdateLongGEZero, enc_cmpr_sample,     zend_couchbase_globals, couchbase_globals)
+STD_PHP_INI_ENTRY("couchbase.encoder.zstd_level",            "3",    PHP_INI_SYSTEM, OnUpdateLong,    enc_zstd_level,      zend_couchbase_globals, couchbase_globals)
+STD_PHP_INI_ENTRY("couchbase.encoder.zstd_dictionary",       "",     PHP_INI_SYSTEM, OnUpdateString,  enc_zstd_dict,       zend_couchbase_globals, couchbase_globals)
 STD_PHP_INI_ENTRY("couchbase.decoder.json_arrays",           "0",    PHP_INI_ALL, OnUpdateBool,       dec_json_array,      zend_couchbase_globals, couchbase_globals)
 STD_PHP_INI_ENTRY("couchbase.pool.max_idle_time_sec",        "60",   PHP_INI_ALL, OnUpdateLongGEZero, pool_max_idle_time,  zend_couchbase_globals, couchbase_globals)
+STD_PHP_INI_ENTRY("couchbase.pool.check_interval_sec",       "1",    PHP_INI_ALL, OnUpdateLongGEZero, pool_check_interval, zend_couchbase_globals, couchbase_globals)
+STD_PHP_INI_ENTRY("couchbase.pool.instances_per_key",        "2",    PHP_INI_ALL, OnUpdateLongGEZero, pool_instances_per_key, zend_couchbase_globals, couchbase_globals)
+STD_PHP_INI_ENTRY_EX("couchbase.pool.prewarm",               "",     PHP_INI_SYSTEM, OnUpdateString,  pool_prewarm,        zend_couchbase_globals, couchbase_globals, DisplayPrewarm)
+STD_PHP_INI_ENTRY("couchbase.pool.prewarm_jitter_ms",        "50",   PHP_INI_SYSTEM, OnUpdateLongGEZero, pool_prewarm_jitter, zend_couchbase_globals, couchbase_globals)
+STD_PHP_INI_ENTRY("couchbase.metrics.log_on_shutdown",       "0",    PHP_INI_ALL, OnUpdateBool,       metrics_log,         zend_couchbase_globals, couchbase_globals)
 PHP_INI_END()
 // clang-format on
 
@@ -165,7 +291,7 @@ PHP_INI_END()
 #define ZEND_TSRMLS_CACHE_UPDATE()
 #endif
 
-static void php_extname_init_globals(zend_couchbase_globals *couchbase_globals)
+static PHP_GINIT_FUNCTION(couchbase)
 {
 #if defined(COMPILE_DL_COUCHBASE) && defined(ZTS)
     ZEND_TSRMLS_CACHE_UPDATE();
@@ -173,18 +299,110 @@ static void php_extname_init_globals(zend_couchbase_globals *couchbase_globals)
 
     couchbase_globals->enc_format = "json";
     couchbase_globals->enc_format_i = COUCHBASE_SERTYPE_JSON;
+    couchbase_globals->log_format = "text";
+    couchbase_globals->log_json = 0;
+    couchbase_globals->log_buffer_size = 0;
+    couchbase_globals->log_buf = NULL;
+    couchbase_globals->log_buf_len = 0;
+    couchbase_globals->log_dropped = 0;
+    couchbase_globals->log_dropped_reported = 0;
+    memset(couchbase_globals->metrics, 0, sizeof(couchbase_globals->metrics));
+    couchbase_globals->metrics_log = 0;
+    couchbase_globals->cmpr_attempts = 0;
+    couchbase_globals->cmpr_compressed = 0;
+    couchbase_globals->cmpr_rejected = 0;
+    couchbase_globals->cmpr_skipped = 0;
+    couchbase_globals->cmpr_bytes_in = 0;
+    couchbase_globals->cmpr_bytes_out = 0;
     couchbase_globals->enc_cmpr = "off";
     couchbase_globals->enc_cmpr_i = COUCHBASE_CMPRTYPE_NONE;
     couchbase_globals->enc_cmpr_threshold = 0;
     couchbase_globals->enc_cmpr_factor = 0.0;
+    couchbase_globals->enc_cmpr_sample = 0;
+    couchbase_globals->enc_zstd_level = 3;
+    couchbase_globals->enc_zstd_dict = NULL;
+#if HAVE_COUCHBASE_ZLIB
+    couchbase_globals->zlib_deflate_ready = 0;
+    couchbase_globals->zlib_inflate_ready = 0;
+#endif
+#if HAVE_COUCHBASE_ZSTD
+    couchbase_globals->zstd_cctx = NULL;
+    couchbase_globals->zstd_dctx = NULL;
+    couchbase_globals->zstd_cdict = NULL;
+    couchbase_globals->zstd_ddict = NULL;
+    couchbase_globals->zstd_dict_loaded = 0;
+#endif
+    couchbase_globals->snappy = "on";
+    couchbase_globals->snappy_mode = LCB_COMPRESS_INOUT;
+    couchbase_globals->snappy_min_size = -1;
+    couchbase_globals->snappy_min_ratio = 0.0;
     couchbase_globals->dec_json_array = 0;
     couchbase_globals->pool_max_idle_time = 60;
+    couchbase_globals->pool_check_interval = 1;
+    couchbase_globals->pool_instances_per_key = 2;
+    couchbase_globals->json_buf = NULL;
+    couchbase_globals->json_buf_size = 0;
+    couchbase_globals->pool_idle_head = NULL;
+    couchbase_globals->pool_idle_tail = NULL;
+    couchbase_globals->pool_checked_at = 0;
+    couchbase_globals->pool_hits = 0;
+    couchbase_globals->pool_misses = 0;
+    couchbase_globals->pool_evictions = 0;
+    couchbase_globals->pool_live = 0;
+    couchbase_globals->pool_idle = 0;
+    couchbase_globals->pool_busy = 0;
+    couchbase_globals->pool_shared = 0;
+    couchbase_globals->pool_open_status = LCB_SUCCESS;
+    couchbase_globals->pool_prewarm = NULL;
+    couchbase_globals->pool_prewarm_jitter = 50;
+    couchbase_globals->pool_prewarmed = 0;
+    couchbase_globals->pool_prewarm_status = NULL;
+    couchbase_globals->future_wait_instance = NULL;
+}
+
+/*
+ * Releases the state, which is kept between the requests. In ZTS build it is called for every thread, so the streams
+ * and buffers of the worker threads are not leaked.
+ */
+static PHP_GSHUTDOWN_FUNCTION(couchbase)
+{
+    if (couchbase_globals->pool_prewarm_status) {
+        zend_string_release(couchbase_globals->pool_prewarm_status);
+        couchbase_globals->pool_prewarm_status = NULL;
+    }
+#if HAVE_COUCHBASE_ZLIB
+    if (couchbase_globals->zlib_deflate_ready) {
+        deflateEnd(&couchbase_globals->zlib_deflate);
+        couchbase_globals->zlib_deflate_ready = 0;
+    }
+    if (couchbase_globals->zlib_inflate_ready) {
+        inflateEnd(&couchbase_globals->zlib_inflate);
+        couchbase_globals->zlib_inflate_ready = 0;
+    }
+#endif
+#if HAVE_COUCHBASE_ZSTD
+    ZSTD_freeCCtx(couchbase_globals->zstd_cctx);
+    ZSTD_freeDCtx(couchbase_globals->zstd_dctx);
+    ZSTD_freeCDict(couchbase_globals->zstd_cdict);
+    ZSTD_freeDDict(couchbase_globals->zstd_ddict);
+    couchbase_globals->zstd_cctx = NULL;
+    couchbase_globals->zstd_dctx = NULL;
+    couchbase_globals->zstd_cdict = NULL;
+    couchbase_globals->zstd_ddict = NULL;
+#endif
+    if (couchbase_globals->log_buf) {
+        pefree(couchbase_globals->log_buf, 1);
+        couchbase_globals->log_buf = NULL;
+    }
 }
 
 PHP_MINIT_FUNCTION(Result);
 PHP_MINIT_FUNCTION(CouchbasePool);
+PHP_MINIT_FUNCTION(Metrics);
 PHP_MINIT_FUNCTION(CouchbaseException);
 PHP_MINIT_FUNCTION(Collection);
+PHP_MINIT_FUNCTION(Future);
+PHP_MINIT_FUNCTION(RowStream);
 PHP_MINIT_FUNCTION(Cluster);
 PHP_MINIT_FUNCTION(ClusterManager);
 PHP_MINIT_FUNCTION(UserSettings);
@@ -248,7 +466,6 @@ PHP_MINIT_FUNCTION(ClusterOptions);
 
 PHP_MINIT_FUNCTION(couchbase)
 {
-    ZEND_INIT_MODULE_GLOBALS(couchbase, php_extname_init_globals, NULL);
     REGISTER_INI_ENTRIES();
 
     pcbc_json_serializable_ce = NULL;
@@ -263,9 +480,12 @@ PHP_MINIT_FUNCTION(couchbase)
     PHP_MINIT(Result)(INIT_FUNC_ARGS_PASSTHRU);
 
     PHP_MINIT(CouchbasePool)(INIT_FUNC_ARGS_PASSTHRU);
+    PHP_MINIT(Metrics)(INIT_FUNC_ARGS_PASSTHRU);
     PHP_MINIT(CouchbaseException)(INIT_FUNC_ARGS_PASSTHRU);
     PHP_MINIT(Cluster)(INIT_FUNC_ARGS_PASSTHRU);
     PHP_MINIT(Collection)(INIT_FUNC_ARGS_PASSTHRU);
+    PHP_MINIT(Future)(INIT_FUNC_ARGS_PASSTHRU);
+    PHP_MINIT(RowStream)(INIT_FUNC_ARGS_PASSTHRU);
     PHP_MINIT(ClusterManager)(INIT_FUNC_ARGS_PASSTHRU);
     PHP_MINIT(UserSettings)(INIT_FUNC_ARGS_PASSTHRU);
     PHP_MINIT(Bucket)(INIT_FUNC_ARGS_PASSTHRU);
@@ -377,18 +597,26 @@ PHP_MINIT_FUNCTION(couchbase)
     PCBC_REGISTER_CONST_RAW(COUCHBASE_VAL_IS_DOUBLE);
     PCBC_REGISTER_CONST_RAW(COUCHBASE_VAL_IS_BOOL);
     PCBC_REGISTER_CONST_RAW(COUCHBASE_VAL_IS_SERIALIZED);
+    PCBC_REGISTER_CONST_RAW(COUCHBASE_VAL_IS_IGBINARY);
     PCBC_REGISTER_CONST_RAW(COUCHBASE_VAL_IS_JSON);
+    PCBC_REGISTER_CONST_RAW(COUCHBASE_VAL_IS_MSGPACK);
     PCBC_REGISTER_CONST_RAW(COUCHBASE_COMPRESSION_MASK);
     PCBC_REGISTER_CONST_RAW(COUCHBASE_COMPRESSION_NONE);
     PCBC_REGISTER_CONST_RAW(COUCHBASE_COMPRESSION_ZLIB);
     PCBC_REGISTER_CONST_RAW(COUCHBASE_COMPRESSION_FASTLZ);
+    PCBC_REGISTER_CONST_RAW(COUCHBASE_COMPRESSION_LZ4);
+    PCBC_REGISTER_CONST_RAW(COUCHBASE_COMPRESSION_ZSTD);
     PCBC_REGISTER_CONST_RAW(COUCHBASE_COMPRESSION_MCISCOMPRESSED);
 
     PCBC_REGISTER_CONST_RAW(COUCHBASE_SERTYPE_JSON);
+    PCBC_REGISTER_CONST_RAW(COUCHBASE_SERTYPE_IGBINARY);
     PCBC_REGISTER_CONST_RAW(COUCHBASE_SERTYPE_PHP);
+    PCBC_REGISTER_CONST_RAW(COUCHBASE_SERTYPE_MSGPACK);
     PCBC_REGISTER_CONST_RAW(COUCHBASE_CMPRTYPE_NONE);
     PCBC_REGISTER_CONST_RAW(COUCHBASE_CMPRTYPE_ZLIB);
     PCBC_REGISTER_CONST_RAW(COUCHBASE_CMPRTYPE_FASTLZ);
+    PCBC_REGISTER_CONST_RAW(COUCHBASE_CMPRTYPE_LZ4);
+    PCBC_REGISTER_CONST_RAW(COUCHBASE_CMPRTYPE_ZSTD);
 
     PCBC_REGISTER_CONST_RAW(COUCHBASE_CFFMT_MASK);
     PCBC_REGISTER_CONST_RAW(COUCHBASE_CFFMT_PRIVATE);
@@ -398,6 +626,10 @@ PHP_MINIT_FUNCTION(couchbase)
 
     REGISTER_NS_LONG_CONSTANT("Couchbase", "ENCODER_FORMAT_JSON", COUCHBASE_SERTYPE_JSON, CONST_CS | CONST_PERSISTENT);
     REGISTER_NS_LONG_CONSTANT("Couchbase", "ENCODER_FORMAT_PHP", COUCHBASE_SERTYPE_PHP, CONST_CS | CONST_PERSISTENT);
+    REGISTER_NS_LONG_CONSTANT("Couchbase", "ENCODER_FORMAT_IGBINARY", COUCHBASE_SERTYPE_IGBINARY,
+                              CONST_CS | CONST_PERSISTENT);
+    REGISTER_NS_LONG_CONSTANT("Couchbase", "ENCODER_FORMAT_MSGPACK", COUCHBASE_SERTYPE_MSGPACK,
+                              CONST_CS | CONST_PERSISTENT);
 
     REGISTER_NS_LONG_CONSTANT("Couchbase", "ENCODER_COMPRESSION_NONE", COUCHBASE_CMPRTYPE_NONE,
                               CONST_CS | CONST_PERSISTENT);
@@ -405,13 +637,36 @@ PHP_MINIT_FUNCTION(couchbase)
                               CONST_CS | CONST_PERSISTENT);
     REGISTER_NS_LONG_CONSTANT("Couchbase", "ENCODER_COMPRESSION_FASTLZ", COUCHBASE_CMPRTYPE_FASTLZ,
                               CONST_CS | CONST_PERSISTENT);
+    REGISTER_NS_LONG_CONSTANT("Couchbase", "ENCODER_COMPRESSION_LZ4", COUCHBASE_CMPRTYPE_LZ4,
+                              CONST_CS | CONST_PERSISTENT);
+    REGISTER_NS_LONG_CONSTANT("Couchbase", "ENCODER_COMPRESSION_ZSTD", COUCHBASE_CMPRTYPE_ZSTD,
+                              CONST_CS | CONST_PERSISTENT);
 
+#ifdef HAVE_COUCHBASE_IGBINARY
+    REGISTER_NS_LONG_CONSTANT("Couchbase", "HAVE_IGBINARY", 1, CONST_CS | CONST_PERSISTENT);
+#else
     REGISTER_NS_LONG_CONSTANT("Couchbase", "HAVE_IGBINARY", 0, CONST_CS | CONST_PERSISTENT);
+#endif
+#ifdef HAVE_COUCHBASE_MSGPACK
+    REGISTER_NS_LONG_CONSTANT("Couchbase", "HAVE_MSGPACK", 1, CONST_CS | CONST_PERSISTENT);
+#else
+    REGISTER_NS_LONG_CONSTANT("Couchbase", "HAVE_MSGPACK", 0, CONST_CS | CONST_PERSISTENT);
+#endif
 
 #ifdef HAVE_COUCHBASE_ZLIB
     REGISTER_NS_LONG_CONSTANT("Couchbase", "HAVE_ZLIB", 1, CONST_CS | CONST_PERSISTENT);
 #else
     REGISTER_NS_LONG_CONSTANT("Couchbase", "HAVE_ZLIB", 0, CONST_CS | CONST_PERSISTENT);
+#endif
+#ifdef HAVE_COUCHBASE_LZ4
+    REGISTER_NS_LONG_CONSTANT("Couchbase", "HAVE_LZ4", 1, CONST_CS | CONST_PERSISTENT);
+#else
+    REGISTER_NS_LONG_CONSTANT("Couchbase", "HAVE_LZ4", 0, CONST_CS | CONST_PERSISTENT);
+#endif
+#ifdef HAVE_COUCHBASE_ZSTD
+    REGISTER_NS_LONG_CONSTANT("Couchbase", "HAVE_ZSTD", 1, CONST_CS | CONST_PERSISTENT);
+#else
+    REGISTER_NS_LONG_CONSTANT("Couchbase", "HAVE_ZSTD", 0, CONST_CS | CONST_PERSISTENT);
 #endif
     return SUCCESS;
 }
@@ -419,6 +674,8 @@ PHP_MINIT_FUNCTION(couchbase)
 PHP_MSHUTDOWN_FUNCTION(couchbase)
 {
     UNREGISTER_INI_ENTRIES();
+    /* the buffers and the compression streams are released in GSHUTDOWN */
+    pcbc_log_flush(TSRMLS_C);
 
     return SUCCESS;
 }
@@ -426,20 +683,400 @@ PHP_MSHUTDOWN_FUNCTION(couchbase)
 PHP_RSHUTDOWN_FUNCTION(couchbase)
 {
     pcbc_connection_cleanup();
+    if (PCBCG(json_buf)) {
+        efree(PCBCG(json_buf));
+        PCBCG(json_buf) = NULL;
+        PCBCG(json_buf_size) = 0;
+    }
+    if (PCBCG(metrics_log)) {
+        pcbc_metrics_log(TSRMLS_C);
+    }
+    pcbc_log_flush(TSRMLS_C);
     return SUCCESS;
 }
 
 PHP_RINIT_FUNCTION(couchbase)
 {
+    if (!PCBCG(pool_prewarmed)) {
+        PCBCG(pool_prewarmed) = 1;
+        pcbc_connection_prewarm(TSRMLS_C);
+    }
     return SUCCESS;
 }
 
-static void basic_encoder_v1(zval *value, int sertype, int cmprtype, long cmprthresh, double cmprfactor,
-                             zval *return_value TSRMLS_DC)
+/* the smallest size of the JSON scratch buffer, enough for the most of the rows */
+#define PCBC_JSON_BUF_MIN_SIZE 4096
+/* the largest size of the JSON scratch buffer kept between the calls */
+#define PCBC_JSON_BUF_MAX_SIZE (1024 * 1024)
+
+/*
+ * The JSON scanner of PHP treats zero byte as end of input, but buffers of libcouchbase (rows, documents, HTTP
+ * bodies) are not zero-terminated. Instead of allocating new copy for every value, stage it in the scratch buffer,
+ * which lives until the end of the request. The buffer grows with the values, but once it exceeds
+ * PCBC_JSON_BUF_MAX_SIZE, it is released right after decoding, so that a single huge document does not stay
+ * allocated for the rest of the request.
+ */
+int pcbc_json_decode(zval *return_value, const char *src, size_t len, int options TSRMLS_DC)
+{
+    if (len + 1 > PCBCG(json_buf_size)) {
+        size_t size = PCBCG(json_buf_size) * 2;
+        if (size < PCBC_JSON_BUF_MIN_SIZE) {
+            size = PCBC_JSON_BUF_MIN_SIZE;
+        }
+        if (size < len + 1) {
+            size = len + 1;
+        }
+        if (PCBCG(json_buf)) {
+            efree(PCBCG(json_buf));
+        }
+        PCBCG(json_buf) = emalloc(size);
+        PCBCG(json_buf_size) = size;
+    }
+    memcpy(PCBCG(json_buf), src, len);
+    PCBCG(json_buf)[len] = '\0';
+
+    PCBC_JSON_RESET_STATE;
+    php_json_decode_ex(return_value, PCBCG(json_buf), len, options, PHP_JSON_PARSER_DEFAULT_DEPTH TSRMLS_CC);
+    if (PCBCG(json_buf_size) > PCBC_JSON_BUF_MAX_SIZE) {
+        efree(PCBCG(json_buf));
+        PCBCG(json_buf) = NULL;
+        PCBCG(json_buf_size) = 0;
+    }
+    return JSON_G(error_code);
+}
+
+zend_string *pcbc_cas_encode(uint64_t cas)
+{
+    return php_base64_encode((unsigned char *)&cas, sizeof(cas));
+}
+
+static int pcbc_base64_value(unsigned char c)
+{
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A';
+    }
+    if (c >= 'a' && c <= 'z') {
+        return c - 'a' + 26;
+    }
+    if (c >= '0' && c <= '9') {
+        return c - '0' + 52;
+    }
+    if (c == '+') {
+        return 62;
+    }
+    if (c == '/') {
+        return 63;
+    }
+    return -1;
+}
+
+/* length of base64 of eight bytes, the last character is always padding */
+#define PCBC_CAS_ENCODED_LEN 12
+
+zend_bool pcbc_cas_decode(zend_string *encoded, uint64_t *cas)
+{
+    if (ZSTR_LEN(encoded) == PCBC_CAS_ENCODED_LEN && ZSTR_VAL(encoded)[PCBC_CAS_ENCODED_LEN - 1] == '=') {
+        const unsigned char *src = (const unsigned char *)ZSTR_VAL(encoded);
+        unsigned char buf[9];
+        int i, valid = 1;
+
+        for (i = 0; i < 3 && valid; i++) {
+            int a = pcbc_base64_value(src[4 * i]);
+            int b = pcbc_base64_value(src[4 * i + 1]);
+            int c = pcbc_base64_value(src[4 * i + 2]);
+            int d = i == 2 ? 0 : pcbc_base64_value(src[4 * i + 3]);
+            if (a < 0 || b < 0 || c < 0 || d < 0) {
+                valid = 0;
+                break;
+            }
+            buf[3 * i] = (unsigned char)((a << 2) | (b >> 4));
+            buf[3 * i + 1] = (unsigned char)((b << 4) | (c >> 2));
+            buf[3 * i + 2] = (unsigned char)((c << 6) | d);
+        }
+        if (valid) {
+            memcpy(cas, buf, sizeof(*cas));
+            return 1;
+        }
+    }
+
+    /* not canonical form, let the lenient decoder of PHP deal with it */
+    zend_string *decoded = php_base64_decode_str(encoded);
+    if (decoded == NULL) {
+        return 0;
+    }
+    zend_bool ok = ZSTR_LEN(decoded) == sizeof(*cas);
+    if (ok) {
+        memcpy(cas, ZSTR_VAL(decoded), sizeof(*cas));
+    }
+    zend_string_free(decoded);
+    return ok;
+}
+
+#if HAVE_COUCHBASE_ZSTD
+/*
+ * The dictionary is loaded on the first use, and kept for the lifetime of the process together with the contexts.
+ * Documents compressed with the dictionary record its ID in the frame header, and cannot be read without it.
+ */
+static void pcbc_zstd_load_dictionary(TSRMLS_D)
+{
+    php_stream *stream;
+    zend_string *dict;
+
+    if (PCBCG(zstd_dict_loaded)) {
+        return;
+    }
+    PCBCG(zstd_dict_loaded) = 1;
+    if (PCBCG(enc_zstd_dict) == NULL || PCBCG(enc_zstd_dict)[0] == '\0') {
+        return;
+    }
+    stream = php_stream_open_wrapper(PCBCG(enc_zstd_dict), "rb", 0, NULL);
+    if (stream == NULL) {
+        pcbc_log(LOGARGS(WARN), "Failed to open zstd dictionary \"%s\"", PCBCG(enc_zstd_dict));
+        return;
+    }
+    dict = php_stream_copy_to_mem(stream, PHP_STREAM_COPY_ALL, 0);
+    php_stream_close(stream);
+    if (dict == NULL) {
+        pcbc_log(LOGARGS(WARN), "Failed to read zstd dictionary \"%s\"", PCBCG(enc_zstd_dict));
+        return;
+    }
+    PCBCG(zstd_cdict) = ZSTD_createCDict(ZSTR_VAL(dict), ZSTR_LEN(dict), (int)PCBCG(enc_zstd_level));
+    PCBCG(zstd_ddict) = ZSTD_createDDict(ZSTR_VAL(dict), ZSTR_LEN(dict));
+    zend_string_release(dict);
+}
+
+static size_t pcbc_zstd_compress(void *output, size_t output_size, const void *input, size_t input_size TSRMLS_DC)
+{
+    pcbc_zstd_load_dictionary(TSRMLS_C);
+    if (PCBCG(zstd_cctx) == NULL) {
+        PCBCG(zstd_cctx) = ZSTD_createCCtx();
+    }
+    if (PCBCG(zstd_cdict)) {
+        return ZSTD_compress_usingCDict(PCBCG(zstd_cctx), output, output_size, input, input_size, PCBCG(zstd_cdict));
+    }
+    return ZSTD_compressCCtx(PCBCG(zstd_cctx), output, output_size, input, input_size, (int)PCBCG(enc_zstd_level));
+}
+
+static size_t pcbc_zstd_decompress(void *output, size_t output_size, const void *input, size_t input_size TSRMLS_DC)
+{
+    pcbc_zstd_load_dictionary(TSRMLS_C);
+    if (PCBCG(zstd_dctx) == NULL) {
+        PCBCG(zstd_dctx) = ZSTD_createDCtx();
+    }
+    if (PCBCG(zstd_ddict)) {
+        return ZSTD_decompress_usingDDict(PCBCG(zstd_dctx), output, output_size, input, input_size, PCBCG(zstd_ddict));
+    }
+    return ZSTD_decompressDCtx(PCBCG(zstd_dctx), output, output_size, input, input_size);
+}
+#endif
+
+#if HAVE_COUCHBASE_ZLIB
+/*
+ * The one-shot compress() and uncompress() set up and tear down the whole zlib state (deflate allocates about 256KB)
+ * for every value. The streams below are initialized once per process (or thread) and only reset between the
+ * values. The output is the same zlib format, so the documents stay readable by the older versions.
+ */
+static int pcbc_zlib_compress(char *output, unsigned long *output_size, const char *input, size_t input_size TSRMLS_DC)
+{
+    z_stream *stream = &PCBCG(zlib_deflate);
+    int rv;
+
+    if (PCBCG(zlib_deflate_ready)) {
+        deflateReset(stream);
+    } else {
+        memset(stream, 0, sizeof(z_stream));
+        rv = deflateInit(stream, Z_DEFAULT_COMPRESSION);
+        if (rv != Z_OK) {
+            return rv;
+        }
+        PCBCG(zlib_deflate_ready) = 1;
+    }
+    stream->next_in = (Bytef *)input;
+    stream->avail_in = (uInt)input_size;
+    stream->next_out = (Bytef *)output;
+    stream->avail_out = (uInt)*output_size;
+    rv = deflate(stream, Z_FINISH);
+    if (rv != Z_STREAM_END) {
+        return rv == Z_OK ? Z_BUF_ERROR : rv;
+    }
+    *output_size = stream->total_out;
+    return Z_OK;
+}
+
+static int pcbc_zlib_uncompress(char *output, unsigned long *output_size, const char *input,
+                                size_t input_size TSRMLS_DC)
+{
+    z_stream *stream = &PCBCG(zlib_inflate);
+    int rv;
+
+    if (PCBCG(zlib_inflate_ready)) {
+        inflateReset(stream);
+    } else {
+        memset(stream, 0, sizeof(z_stream));
+        rv = inflateInit(stream);
+        if (rv != Z_OK) {
+            return rv;
+        }
+        PCBCG(zlib_inflate_ready) = 1;
+    }
+    stream->next_in = (Bytef *)input;
+    stream->avail_in = (uInt)input_size;
+    stream->next_out = (Bytef *)output;
+    stream->avail_out = (uInt)*output_size;
+    rv = inflate(stream, Z_FINISH);
+    if (rv != Z_STREAM_END) {
+        return rv == Z_OK ? Z_BUF_ERROR : rv;
+    }
+    *output_size = stream->total_out;
+    return Z_OK;
+}
+#endif
+
+/*
+ * Compresses the input with the given method, and prepends 4 bytes with the original size, which is used by the
+ * decoder to allocate the output. Returns NULL when the method is not available or failed.
+ */
+static zend_string *pcbc_compress(int cmprtype, const char *input, size_t input_size, int *cmprflags TSRMLS_DC)
+{
+    zend_string *output = NULL;
+    size_t output_bound;
+
+    switch (cmprtype) {
+    case COUCHBASE_CMPRTYPE_ZLIB: {
+#if HAVE_COUCHBASE_ZLIB
+        unsigned long output_size = compressBound(input_size);
+        int rv;
+
+        output_bound = 4 + output_size;
+        output = zend_string_alloc(output_bound, 0);
+        rv = pcbc_zlib_compress(ZSTR_VAL(output) + 4, &output_size, input, input_size TSRMLS_CC);
+        if (rv != Z_OK) {
+            zend_string_free(output);
+            pcbc_log(LOGARGS(WARN), "Failed to compress data with zlib. rv=%d", rv);
+            return NULL;
+        }
+        ZSTR_LEN(output) = 4 + output_size;
+        *cmprflags = COUCHBASE_COMPRESSION_ZLIB;
+#else
+        pcbc_log(LOGARGS(WARN), "The zlib library was not available when the couchbase extension was built.");
+        return NULL;
+#endif
+    } break;
+    case COUCHBASE_CMPRTYPE_FASTLZ: {
+        /* The output buffer must be at least 5% larger than the input buffer and can not be smaller than 66 bytes. */
+        size_t output_size = input_size + input_size / 20;
+
+        output_bound = 4 + (output_size > 66 ? output_size : 66);
+        output = zend_string_alloc(output_bound, 0);
+        ZSTR_LEN(output) = 4 + fastlz_compress(input, (int)input_size, ZSTR_VAL(output) + 4);
+        *cmprflags = COUCHBASE_COMPRESSION_FASTLZ;
+    } break;
+    case COUCHBASE_CMPRTYPE_LZ4: {
+#if HAVE_COUCHBASE_LZ4
+        int output_size = LZ4_compressBound((int)input_size);
+
+        output_bound = 4 + output_size;
+        output = zend_string_alloc(output_bound, 0);
+        output_size = LZ4_compress_default(input, ZSTR_VAL(output) + 4, (int)input_size, output_size);
+        if (output_size <= 0) {
+            zend_string_free(output);
+            pcbc_log(LOGARGS(WARN), "Failed to compress data with LZ4");
+            return NULL;
+        }
+        ZSTR_LEN(output) = 4 + output_size;
+        *cmprflags = COUCHBASE_COMPRESSION_LZ4;
+#else
+        pcbc_log(LOGARGS(WARN), "The LZ4 library was not available when the couchbase extension was built.");
+        return NULL;
+#endif
+    } break;
+    case COUCHBASE_CMPRTYPE_ZSTD: {
+#if HAVE_COUCHBASE_ZSTD
+        size_t output_size = ZSTD_compressBound(input_size);
+
+        output_bound = 4 + output_size;
+        output = zend_string_alloc(output_bound, 0);
+        output_size = pcbc_zstd_compress(ZSTR_VAL(output) + 4, output_size, input, input_size TSRMLS_CC);
+        if (ZSTD_isError(output_size)) {
+            zend_string_free(output);
+            pcbc_log(LOGARGS(WARN), "Failed to compress data with zstd: %s", ZSTD_getErrorName(output_size));
+            return NULL;
+        }
+        ZSTR_LEN(output) = 4 + output_size;
+        *cmprflags = COUCHBASE_COMPRESSION_ZSTD;
+#else
+        pcbc_log(LOGARGS(WARN), "The zstd library was not available when the couchbase extension was built.");
+        return NULL;
+#endif
+    } break;
+    default:
+        pcbc_log(LOGARGS(WARN), "Unsupported compression method: %d", cmprtype);
+        return NULL;
+    }
+    /* the buffer is allocated for the worst case, do not keep the unused part in the value cached by the application */
+    if (ZSTR_LEN(output) < output_bound - output_bound / 4) {
+        output = zend_string_truncate(output, ZSTR_LEN(output), 0);
+    }
+    *(uint32_t *)ZSTR_VAL(output) = (uint32_t)input_size;
+    ZSTR_VAL(output)[ZSTR_LEN(output)] = '\0';
+    return output;
+}
+
+/*
+ * Reads the size of the uncompressed data from the preamble written by pcbc_compress(). The values come from the
+ * network, so the size is accepted only if the compressed data could actually expand to it, and the caller does
+ * not allocate whatever a corrupted preamble claims.
+ */
+static int pcbc_uncompressed_size(int cmprflags, const char *input, size_t input_size, size_t *output_size)
+{
+    size_t size;
+
+    if (input_size < 4) {
+        return FAILURE;
+    }
+    size = *(uint32_t *)input;
+    input += 4;
+    input_size -= 4;
+    switch (cmprflags) {
+    case COUCHBASE_COMPRESSION_ZLIB:
+        /* deflate cannot encode more than 258 bytes in two bits, so the ratio is limited by 1032:1 */
+        if (size > input_size * 1032) {
+            return FAILURE;
+        }
+        break;
+    case COUCHBASE_COMPRESSION_FASTLZ:
+        /* the length of the match grows at most by 255 per byte of the instruction, as in LZ4 */
+        if (size > INT_MAX || size > input_size * 255) {
+            return FAILURE;
+        }
+        break;
+#if HAVE_COUCHBASE_LZ4
+    case COUCHBASE_COMPRESSION_LZ4:
+        /* every byte of LZ4 block expands to at most 255 bytes */
+        if (size > INT_MAX || size > input_size * 255) {
+            return FAILURE;
+        }
+        break;
+#endif
+#if HAVE_COUCHBASE_ZSTD
+    case COUCHBASE_COMPRESSION_ZSTD:
+        /* the frame header of the single-shot compression records the size of the content */
+        if (ZSTD_getFrameContentSize(input, input_size) != size) {
+            return FAILURE;
+        }
+        break;
+#endif
+    default:
+        break;
+    }
+    *output_size = size;
+    return SUCCESS;
+}
+
+void pcbc_basic_encoder_v1(zval *value, int sertype, int cmprtype, long cmprthresh, double cmprfactor, zval *bytes,
+                           uint32_t *out_flags TSRMLS_DC)
 {
     zval res;
-    zval flg;
-    zval dtype;
     unsigned int flags = 0;
 
     ZVAL_UNDEF(&res);
@@ -447,7 +1084,7 @@ static void basic_encoder_v1(zval *value, int sertype, int cmprtype, long cmprth
     switch (Z_TYPE_P(value)) {
     case IS_STRING:
         flags = COUCHBASE_VAL_IS_STRING | COUCHBASE_CFFMT_STRING;
-        PCBC_STRINGL(res, PCBC_STRVAL_ZP(value), PCBC_STRLEN_ZP(value));
+        ZVAL_STR_COPY(&res, Z_STR_P(value));
         break;
     case IS_LONG:
         flags = COUCHBASE_VAL_IS_LONG | COUCHBASE_CFFMT_JSON;
@@ -499,7 +1136,7 @@ static void basic_encoder_v1(zval *value, int sertype, int cmprtype, long cmprth
                     ZVAL_NULL(&res);
                 } else {
                     smart_str_0(&buf);
-                    PCBC_STRINGS(res, buf);
+                    PCBC_STRING_FROM_SMARTSTR(res, buf);
                 }
                 smart_str_free(&buf);
             }
@@ -517,107 +1154,122 @@ static void basic_encoder_v1(zval *value, int sertype, int cmprtype, long cmprth
                 if (EG(exception)) {
                     pcbc_log(LOGARGS(WARN), "Failed to serialize value");
                 } else {
-                    PCBC_STRINGS(res, buf);
+                    smart_str_0(&buf);
+                    PCBC_STRING_FROM_SMARTSTR(res, buf);
+                }
+                smart_str_free(&buf);
+            }
+            break;
+#if HAVE_COUCHBASE_IGBINARY
+        case COUCHBASE_SERTYPE_IGBINARY:
+            flags = COUCHBASE_VAL_IS_IGBINARY | COUCHBASE_CFFMT_PRIVATE;
+            {
+                uint8_t *data = NULL;
+                size_t data_len = 0;
+
+                if (igbinary_serialize(&data, &data_len, value) != 0) {
+                    pcbc_log(LOGARGS(WARN), "Failed to serialize value with igbinary");
+                    ZVAL_NULL(&res);
+                } else {
+                    PCBC_STRINGL(res, (char *)data, data_len);
+                    efree(data);
+                }
+            }
+            break;
+#endif
+#if HAVE_COUCHBASE_MSGPACK
+        case COUCHBASE_SERTYPE_MSGPACK:
+            flags = COUCHBASE_VAL_IS_MSGPACK | COUCHBASE_CFFMT_PRIVATE;
+            {
+                smart_str buf = {0};
+
+                php_msgpack_serialize(&buf, value);
+                if (EG(exception)) {
+                    pcbc_log(LOGARGS(WARN), "Failed to serialize value with msgpack");
+                    ZVAL_NULL(&res);
+                } else {
+                    smart_str_0(&buf);
+                    PCBC_STRING_FROM_SMARTSTR(res, buf);
                 }
                 smart_str_free(&buf);
             }
             break;
+#endif
+        default:
+            pcbc_log(LOGARGS(WARN), "Unsupported serialization type: %d", sertype);
+            ZVAL_NULL(&res);
+            break;
         }
     }
 
     do {
+        zend_string *compressed;
         size_t datalen = 0;
+        int cmprflags = COUCHBASE_COMPRESSION_NONE;
+
         if (Z_TYPE_P(&res) == IS_NULL) {
             break;
         }
         datalen = PCBC_STRLEN_P(res);
-        if (datalen < cmprthresh) {
-            cmprtype = COUCHBASE_CMPRTYPE_NONE;
+        if (datalen < cmprthresh || cmprtype == COUCHBASE_CMPRTYPE_NONE) {
+            break;
         }
-        if (cmprtype != COUCHBASE_CMPRTYPE_NONE) {
-            int cmprflags = COUCHBASE_COMPRESSION_NONE;
-            zval compressed;
-            if (cmprtype == COUCHBASE_CMPRTYPE_ZLIB) {
-#if HAVE_COUCHBASE_ZLIB
-                void *input, *output;
-                unsigned long input_size, output_size;
-                int rv;
-
-                input_size = datalen;
-                input = PCBC_STRVAL_P(res);
-                /* 4 bytes for original size in preamble and 1 byte for zero terminator */
-                output_size = 4 + compressBound(input_size) + 1;
-                output = emalloc(output_size);
-
-                rv = compress((uint8_t *)output + 4, &output_size, input, input_size);
-                if (rv != Z_OK) {
-                    efree(output);
-                    pcbc_log(LOGARGS(WARN), "Failed to compress data with zlib. rv=%d", rv);
-                    break;
-                }
-                *((uint32_t *)output) = input_size;
-                output_size += 4;
-                *((uint8_t *)output + output_size) = '\0';
-                cmprflags = COUCHBASE_COMPRESSION_ZLIB;
-                ZVAL_UNDEF(&compressed);
-                PCBC_STRINGL(compressed, output, output_size);
-                efree(output);
-#else
-                pcbc_log(LOGARGS(WARN), "The zlib library was not available when the couchbase extension was built.");
-                break;
-#endif
-            } else if (cmprtype == COUCHBASE_CMPRTYPE_FASTLZ) {
-                void *input, *output;
-                unsigned long input_size, output_size;
-
-                input_size = (unsigned long)datalen;
-                input = PCBC_STRVAL_P(res);
-                /* The output buffer must be at least 5% larger than the input buffer and can not be smaller than 66
-                 * bytes. */
-                output_size = input_size + input_size / 20;
-                /* 4 bytes for original size in preamble and 1 byte for zero terminator */
-                output_size = 4 + (output_size > 66 ? output_size : 66) + 1;
-                output = emalloc(output_size);
-                output_size = fastlz_compress(input, input_size, (uint8_t *)output + 4);
-                *(uint32_t *)output = input_size;
-                output_size += 4;
-                *((uint8_t *)output + output_size) = '\0';
-                cmprflags = COUCHBASE_COMPRESSION_FASTLZ;
-                ZVAL_UNDEF(&compressed);
-                PCBC_STRINGL(compressed, output, output_size);
-                efree(output);
-            } else {
-                pcbc_log(LOGARGS(WARN), "Unsupported compression method: %d", cmprtype);
+        PCBCG(cmpr_attempts)++;
+        if (PCBCG(enc_cmpr_sample) > 0 && datalen >= 2 * (size_t)PCBCG(enc_cmpr_sample)) {
+            /* the prefix is a cheap predictor for high-entropy payloads, like base64 images or encrypted blobs */
+            size_t sample_len = (size_t)PCBCG(enc_cmpr_sample);
+            double factor = cmprfactor > 1.0 ? cmprfactor : 1.0;
+            compressed = pcbc_compress(cmprtype, PCBC_STRVAL_P(res), sample_len, &cmprflags TSRMLS_CC);
+            if (compressed == NULL) {
                 break;
             }
-            if (cmprflags != COUCHBASE_COMPRESSION_NONE) {
-                if (PCBC_STRLEN_P(res) > PCBC_STRLEN_P(compressed) * cmprfactor) {
-                    zval_dtor(&res);
-                    res = compressed;
-
-                    flags |= cmprflags;
-                    flags |= COUCHBASE_COMPRESSION_MCISCOMPRESSED;
-
-                    /* compression considered private format */
-                    flags &= ~((unsigned int)COUCHBASE_CFFMT_MASK);
-                    flags |= COUCHBASE_CFFMT_PRIVATE;
-                } else {
-                    zval_dtor(&compressed);
-                }
+            if (sample_len <= ZSTR_LEN(compressed) * factor) {
+                zend_string_release(compressed);
+                PCBCG(cmpr_skipped)++;
+                break;
             }
+            zend_string_release(compressed);
+        }
+        compressed = pcbc_compress(cmprtype, PCBC_STRVAL_P(res), datalen, &cmprflags TSRMLS_CC);
+        if (compressed == NULL) {
+            break;
+        }
+        if (datalen > ZSTR_LEN(compressed) * cmprfactor) {
+            PCBCG(cmpr_compressed)++;
+            PCBCG(cmpr_bytes_in) += datalen;
+            PCBCG(cmpr_bytes_out) += ZSTR_LEN(compressed);
+            zval_ptr_dtor(&res);
+            ZVAL_STR(&res, compressed);
+
+            flags |= cmprflags;
+            flags |= COUCHBASE_COMPRESSION_MCISCOMPRESSED;
+
+            /* compression considered private format */
+            flags &= ~((unsigned int)COUCHBASE_CFFMT_MASK);
+            flags |= COUCHBASE_CFFMT_PRIVATE;
+        } else {
+            PCBCG(cmpr_rejected)++;
+            zend_string_release(compressed);
         }
     } while (0);
 
-    array_init_size(return_value, 3);
-    add_index_zval(return_value, 0, &res);
+    ZVAL_COPY_VALUE(bytes, &res);
+    *out_flags = flags;
+}
 
-    ZVAL_UNDEF(&flg);
-    ZVAL_LONG(&flg, flags);
-    add_index_zval(return_value, 1, &flg);
+static void basic_encoder_v1(zval *value, int sertype, int cmprtype, long cmprthresh, double cmprfactor,
+                             zval *return_value TSRMLS_DC)
+{
+    zval res;
+    uint32_t flags = 0;
 
-    ZVAL_UNDEF(&dtype);
-    ZVAL_LONG(&dtype, 0);
-    add_index_zval(return_value, 2, &dtype);
+    ZVAL_UNDEF(&res);
+    pcbc_basic_encoder_v1(value, sertype, cmprtype, cmprthresh, cmprfactor, &res, &flags TSRMLS_CC);
+
+    array_init_size(return_value, 3);
+    add_index_zval(return_value, 0, &res);
+    add_index_long(return_value, 1, flags);
+    add_index_long(return_value, 2, 0);
 }
 
 static void basic_decoder_v1(char *bytes, size_t bytes_len, unsigned long flags, unsigned long datatype,
@@ -656,14 +1308,22 @@ static void basic_decoder_v1(char *bytes, size_t bytes_len, unsigned long flags,
     case COUCHBASE_CFFMT_EMPTY:
         if (sertype & COUCHBASE_COMPRESSION_MCISCOMPRESSED) {
             sertype &= ~((unsigned int)COUCHBASE_COMPRESSION_MCISCOMPRESSED);
+            size_t declared_size = 0;
+            if (cmprtype != 0 && pcbc_uncompressed_size(cmprtype, bytes, bytes_len, &declared_size) != SUCCESS) {
+                pcbc_log(LOGARGS(WARN), "Invalid size of the compressed data. cmprtype=%d, len=%d", cmprtype,
+                         (int)bytes_len);
+                ZVAL_NULL(&res);
+                break;
+            }
             if (cmprtype == COUCHBASE_COMPRESSION_ZLIB) {
 #if HAVE_COUCHBASE_ZLIB
-                unsigned long output_size = *(uint32_t *)bytes;
+                unsigned long output_size = declared_size;
                 char *output = emalloc(output_size);
-                rv = uncompress((uint8_t *)output, &output_size, (uint8_t *)bytes + 4, bytes_len - 4);
+                rv = pcbc_zlib_uncompress(output, &output_size, bytes + 4, bytes_len - 4 TSRMLS_CC);
                 if (rv != Z_OK) {
                     efree(output);
                     pcbc_log(LOGARGS(WARN), "Failed to uncompress data with zlib. rv=%d", rv);
+                    ZVAL_NULL(&res);
                     break;
                 }
                 need_free = 1;
@@ -671,20 +1331,60 @@ static void basic_decoder_v1(char *bytes, size_t bytes_len, unsigned long flags,
                 bytes_len = output_size;
 #else
                 pcbc_log(LOGARGS(WARN), "The zlib library was not available when the couchbase extension was built.");
+                ZVAL_NULL(&res);
                 break;
 #endif
             } else if (cmprtype == COUCHBASE_COMPRESSION_FASTLZ) {
-                unsigned long output_size = *(uint32_t *)bytes;
+                unsigned long output_size = declared_size;
                 char *output = emalloc(output_size);
                 output_size = fastlz_decompress((uint8_t *)bytes + 4, (int)bytes_len - 4, output, (int)output_size);
                 if (output_size == 0) {
                     efree(output);
                     pcbc_log(LOGARGS(WARN), "Failed to uncompress data with fastlz");
+                    ZVAL_NULL(&res);
+                    break;
+                }
+                need_free = 1;
+                bytes = output;
+                bytes_len = output_size;
+            } else if (cmprtype == COUCHBASE_COMPRESSION_LZ4) {
+#if HAVE_COUCHBASE_LZ4
+                int output_size = (int)declared_size;
+                char *output = emalloc(output_size);
+                output_size = LZ4_decompress_safe(bytes + 4, output, (int)bytes_len - 4, output_size);
+                if (output_size < 0) {
+                    efree(output);
+                    pcbc_log(LOGARGS(WARN), "Failed to uncompress data with LZ4. rv=%d", output_size);
+                    ZVAL_NULL(&res);
+                    break;
+                }
+                need_free = 1;
+                bytes = output;
+                bytes_len = output_size;
+#else
+                pcbc_log(LOGARGS(WARN), "The LZ4 library was not available when the couchbase extension was built.");
+                ZVAL_NULL(&res);
+                break;
+#endif
+            } else if (cmprtype == COUCHBASE_COMPRESSION_ZSTD) {
+#if HAVE_COUCHBASE_ZSTD
+                size_t output_size = declared_size;
+                char *output = emalloc(output_size);
+                output_size = pcbc_zstd_decompress(output, output_size, bytes + 4, bytes_len - 4 TSRMLS_CC);
+                if (ZSTD_isError(output_size)) {
+                    efree(output);
+                    pcbc_log(LOGARGS(WARN), "Failed to uncompress data with zstd: %s", ZSTD_getErrorName(output_size));
+                    ZVAL_NULL(&res);
                     break;
                 }
                 need_free = 1;
                 bytes = output;
                 bytes_len = output_size;
+#else
+                pcbc_log(LOGARGS(WARN), "The zstd library was not available when the couchbase extension was built.");
+                ZVAL_NULL(&res);
+                break;
+#endif
             } else if (cmprtype != 0) {
                 pcbc_log(LOGARGS(WARN), "Unsupported compression method: %d", cmprtype);
                 RETURN_NULL();
@@ -738,8 +1438,27 @@ static void basic_decoder_v1(char *bytes, size_t bytes_len, unsigned long flags,
             PHP_VAR_UNSERIALIZE_DESTROY(var_hash);
         } break;
         case COUCHBASE_VAL_IS_IGBINARY:
+#if HAVE_COUCHBASE_IGBINARY
+            if (igbinary_unserialize((const uint8_t *)bytes, bytes_len, &res) != 0) {
+                if (!EG(exception)) {
+                    pcbc_log(LOGARGS(WARN), "Failed to unserialize value with igbinary");
+                }
+                zval_ptr_dtor(&res);
+                ZVAL_NULL(&res);
+            }
+#else
             pcbc_log(LOGARGS(WARN), "The igbinary serialization is not supported.");
-            RETURN_NULL();
+            ZVAL_NULL(&res);
+#endif
+            break;
+        case COUCHBASE_VAL_IS_MSGPACK:
+#if HAVE_COUCHBASE_MSGPACK
+            php_msgpack_unserialize(&res, bytes, bytes_len);
+#else
+            pcbc_log(LOGARGS(WARN), "The msgpack serialization is not supported.");
+            ZVAL_NULL(&res);
+#endif
+            break;
         default:
             pcbc_log(LOGARGS(WARN), "Unknown serialization type: %d", cffmt);
             ZVAL_NULL(&res);
@@ -792,13 +1511,13 @@ PHP_FUNCTION(basicEncoderV1)
     if (options != NULL) {
         if (php_array_existsc(options, "sertype")) {
             long tmp = php_array_fetchc_long(options, "sertype");
-            if (tmp <= COUCHBASE_SERTYPE_PHP && tmp >= COUCHBASE_SERTYPE_JSON) {
+            if (tmp <= COUCHBASE_SERTYPE_MSGPACK && tmp >= COUCHBASE_SERTYPE_JSON) {
                 sertype = tmp;
             }
         }
         if (php_array_existsc(options, "cmprtype")) {
             long tmp = php_array_fetchc_long(options, "cmprtype");
-            if (tmp >= COUCHBASE_CMPRTYPE_NONE && tmp <= COUCHBASE_CMPRTYPE_FASTLZ) {
+            if (tmp >= COUCHBASE_CMPRTYPE_NONE && tmp <= COUCHBASE_CMPRTYPE_ZSTD) {
                 cmprtype = tmp;
             }
         }
@@ -908,22 +1627,20 @@ PHP_FUNCTION(zlibCompress)
 {
 #if HAVE_COUCHBASE_ZLIB
     zval *zdata;
-    void *dataIn, *dataOut;
-    unsigned long dataSize, dataOutSize;
+    zend_string *compressed;
+    int cmprflags;
 
     if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "z", &zdata) == FAILURE) {
         RETURN_NULL();
     }
 
-    dataIn = PCBC_STRVAL_ZP(zdata);
-    dataSize = PCBC_STRLEN_ZP(zdata);
-    dataOutSize = compressBound(dataSize);
-    dataOut = emalloc(dataOutSize);
-    compress((uint8_t *)dataOut + 4, &dataOutSize, dataIn, dataSize);
-    *(uint32_t *)dataOut = dataSize;
-
-    ZVAL_STRINGL(return_value, dataOut, 4 + dataOutSize);
-    efree(dataOut);
+    compressed =
+        pcbc_compress(COUCHBASE_CMPRTYPE_ZLIB, PCBC_STRVAL_ZP(zdata), PCBC_STRLEN_ZP(zdata), &cmprflags TSRMLS_CC);
+    if (compressed == NULL) {
+        zend_throw_exception(NULL, "Failed to compress data with zlib", 0 TSRMLS_CC);
+        return;
+    }
+    RETURN_STR(compressed);
 #else
     zend_throw_exception(NULL, "The zlib library was not available when the couchbase extension was built.",
                          0 TSRMLS_CC);
@@ -936,6 +1653,8 @@ PHP_FUNCTION(zlibDecompress)
     zval *zdata;
     void *dataIn, *dataOut;
     unsigned long dataSize, dataOutSize;
+    size_t declaredSize;
+    int rv;
 
     if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "z", &zdata) == FAILURE) {
         RETURN_NULL();
@@ -943,9 +1662,18 @@ PHP_FUNCTION(zlibDecompress)
 
     dataIn = PCBC_STRVAL_ZP(zdata);
     dataSize = PCBC_STRLEN_ZP(zdata);
-    dataOutSize = *(uint32_t *)dataIn;
+    if (pcbc_uncompressed_size(COUCHBASE_COMPRESSION_ZLIB, dataIn, dataSize, &declaredSize) != SUCCESS) {
+        zend_throw_exception(NULL, "Invalid size of the zlib compressed data", 0 TSRMLS_CC);
+        return;
+    }
+    dataOutSize = declaredSize;
     dataOut = emalloc(dataOutSize);
-    uncompress(dataOut, &dataOutSize, (uint8_t *)dataIn + 4, dataSize - 4);
+    rv = pcbc_zlib_uncompress(dataOut, &dataOutSize, (char *)dataIn + 4, dataSize - 4 TSRMLS_CC);
+    if (rv != Z_OK) {
+        efree(dataOut);
+        zend_throw_exception(NULL, "Failed to uncompress data with zlib", rv TSRMLS_CC);
+        return;
+    }
 
     ZVAL_STRINGL(return_value, dataOut, dataOutSize);
     efree(dataOut);
@@ -956,10 +1684,30 @@ PHP_FUNCTION(zlibDecompress)
 }
 
 PHP_FUNCTION(fastlzCompress)
+{
+    zval *zdata;
+    zend_string *compressed;
+    int cmprflags;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "z", &zdata) == FAILURE) {
+        RETURN_NULL();
+    }
+
+    compressed =
+        pcbc_compress(COUCHBASE_CMPRTYPE_FASTLZ, PCBC_STRVAL_ZP(zdata), PCBC_STRLEN_ZP(zdata), &cmprflags TSRMLS_CC);
+    if (compressed == NULL) {
+        zend_throw_exception(NULL, "Failed to compress data with fastlz", 0 TSRMLS_CC);
+        return;
+    }
+    RETURN_STR(compressed);
+}
+
+PHP_FUNCTION(fastlzDecompress)
 {
     zval *zdata;
     void *dataIn, *dataOut;
     unsigned long dataSize, dataOutSize;
+    size_t declaredSize;
 
     if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "z", &zdata) == FAILURE) {
         RETURN_NULL();
@@ -967,35 +1715,138 @@ PHP_FUNCTION(fastlzCompress)
 
     dataIn = PCBC_STRVAL_ZP(zdata);
     dataSize = (unsigned long)PCBC_STRLEN_ZP(zdata);
-    dataOutSize = 4 + (dataSize + dataSize / 20);
+    if (pcbc_uncompressed_size(COUCHBASE_COMPRESSION_FASTLZ, dataIn, dataSize, &declaredSize) != SUCCESS) {
+        zend_throw_exception(NULL, "Invalid size of the fastlz compressed data", 0 TSRMLS_CC);
+        return;
+    }
+    dataOutSize = declaredSize;
     dataOut = emalloc(dataOutSize);
-    dataOutSize = fastlz_compress(dataIn, dataSize, (uint8_t *)dataOut + 4);
-    *(uint32_t *)dataOut = dataSize;
+    dataOutSize = fastlz_decompress((uint8_t *)dataIn + 4, dataSize - 4, dataOut, dataOutSize);
+    if (dataOutSize == 0 && declaredSize > 0) {
+        efree(dataOut);
+        zend_throw_exception(NULL, "Failed to uncompress data with fastlz", 0 TSRMLS_CC);
+        return;
+    }
 
-    ZVAL_STRINGL(return_value, dataOut, 4 + dataOutSize);
+    ZVAL_STRINGL(return_value, dataOut, dataOutSize);
 
     efree(dataOut);
 }
 
-PHP_FUNCTION(fastlzDecompress)
+PHP_FUNCTION(lz4Compress)
 {
+#if HAVE_COUCHBASE_LZ4
     zval *zdata;
-    void *dataIn, *dataOut;
-    unsigned long dataSize, dataOutSize;
+    zend_string *compressed;
+    int cmprflags;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "z", &zdata) == FAILURE) {
+        RETURN_NULL();
+    }
+
+    compressed =
+        pcbc_compress(COUCHBASE_CMPRTYPE_LZ4, PCBC_STRVAL_ZP(zdata), PCBC_STRLEN_ZP(zdata), &cmprflags TSRMLS_CC);
+    if (compressed == NULL) {
+        zend_throw_exception(NULL, "Failed to compress data with LZ4", 0 TSRMLS_CC);
+        return;
+    }
+    RETURN_STR(compressed);
+#else
+    zend_throw_exception(NULL, "The LZ4 library was not available when the couchbase extension was built.",
+                         0 TSRMLS_CC);
+#endif
+}
+
+PHP_FUNCTION(lz4Decompress)
+{
+#if HAVE_COUCHBASE_LZ4
+    zval *zdata;
+    char *dataIn, *dataOut;
+    int dataSize, dataOutSize;
+    size_t declaredSize;
 
     if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "z", &zdata) == FAILURE) {
         RETURN_NULL();
     }
 
     dataIn = PCBC_STRVAL_ZP(zdata);
-    dataSize = (unsigned long)PCBC_STRLEN_ZP(zdata);
-    dataOutSize = *(uint32_t *)dataIn;
+    dataSize = (int)PCBC_STRLEN_ZP(zdata);
+    if (pcbc_uncompressed_size(COUCHBASE_COMPRESSION_LZ4, dataIn, PCBC_STRLEN_ZP(zdata), &declaredSize) != SUCCESS) {
+        zend_throw_exception(NULL, "Invalid size of the LZ4 compressed data", 0 TSRMLS_CC);
+        return;
+    }
+    dataOutSize = (int)declaredSize;
     dataOut = emalloc(dataOutSize);
-    dataOutSize = fastlz_decompress((uint8_t *)dataIn + 4, dataSize - 4, dataOut, dataOutSize);
+    dataOutSize = LZ4_decompress_safe(dataIn + 4, dataOut, dataSize - 4, dataOutSize);
+    if (dataOutSize < 0) {
+        efree(dataOut);
+        zend_throw_exception(NULL, "Failed to uncompress data with LZ4", 0 TSRMLS_CC);
+        return;
+    }
 
     ZVAL_STRINGL(return_value, dataOut, dataOutSize);
+    efree(dataOut);
+#else
+    zend_throw_exception(NULL, "The LZ4 library was not available when the couchbase extension was built.",
+                         0 TSRMLS_CC);
+#endif
+}
+
+PHP_FUNCTION(zstdCompress)
+{
+#if HAVE_COUCHBASE_ZSTD
+    zval *zdata;
+    zend_string *compressed;
+    int cmprflags;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "z", &zdata) == FAILURE) {
+        RETURN_NULL();
+    }
+
+    compressed =
+        pcbc_compress(COUCHBASE_CMPRTYPE_ZSTD, PCBC_STRVAL_ZP(zdata), PCBC_STRLEN_ZP(zdata), &cmprflags TSRMLS_CC);
+    if (compressed == NULL) {
+        zend_throw_exception(NULL, "Failed to compress data with zstd", 0 TSRMLS_CC);
+        return;
+    }
+    RETURN_STR(compressed);
+#else
+    zend_throw_exception(NULL, "The zstd library was not available when the couchbase extension was built.",
+                         0 TSRMLS_CC);
+#endif
+}
+
+PHP_FUNCTION(zstdDecompress)
+{
+#if HAVE_COUCHBASE_ZSTD
+    zval *zdata;
+    char *dataIn, *dataOut;
+    size_t dataSize, dataOutSize;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "z", &zdata) == FAILURE) {
+        RETURN_NULL();
+    }
+
+    dataIn = PCBC_STRVAL_ZP(zdata);
+    dataSize = PCBC_STRLEN_ZP(zdata);
+    if (pcbc_uncompressed_size(COUCHBASE_COMPRESSION_ZSTD, dataIn, dataSize, &dataOutSize) != SUCCESS) {
+        zend_throw_exception(NULL, "Invalid size of the zstd compressed data", 0 TSRMLS_CC);
+        return;
+    }
+    dataOut = emalloc(dataOutSize);
+    dataOutSize = pcbc_zstd_decompress(dataOut, dataOutSize, dataIn + 4, dataSize - 4 TSRMLS_CC);
+    if (ZSTD_isError(dataOutSize)) {
+        efree(dataOut);
+        zend_throw_exception(NULL, ZSTD_getErrorName(dataOutSize), 0 TSRMLS_CC);
+        return;
+    }
 
+    ZVAL_STRINGL(return_value, dataOut, dataOutSize);
     efree(dataOut);
+#else
+    zend_throw_exception(NULL, "The zstd library was not available when the couchbase extension was built.",
+                         0 TSRMLS_CC);
+#endif
 }
 
 static PHP_MINFO_FUNCTION(couchbase)
@@ -1020,6 +1871,32 @@ static PHP_MINFO_FUNCTION(couchbase)
 #else
     php_info_print_table_row(2, "zlib compressor", "disabled (install zlib headers and rebuild pecl/couchbase)");
 #endif
+#ifdef HAVE_COUCHBASE_LZ4
+    php_info_print_table_row(2, "LZ4 compressor", "enabled");
+#else
+    php_info_print_table_row(2, "LZ4 compressor", "disabled (install liblz4 headers and rebuild pecl/couchbase)");
+#endif
+#ifdef HAVE_COUCHBASE_ZSTD
+    php_info_print_table_row(2, "zstd compressor", "enabled");
+#else
+    php_info_print_table_row(2, "zstd compressor", "disabled (install libzstd headers and rebuild pecl/couchbase)");
+#endif
+#ifdef HAVE_COUCHBASE_IGBINARY
+    php_info_print_table_row(2, "igbinary serializer", "enabled");
+#else
+    php_info_print_table_row(2, "igbinary serializer", "disabled (install pecl/igbinary and rebuild pecl/couchbase)");
+#endif
+#ifdef HAVE_COUCHBASE_MSGPACK
+    php_info_print_table_row(2, "msgpack serializer", "enabled");
+#else
+    php_info_print_table_row(2, "msgpack serializer", "disabled (install pecl/msgpack and rebuild pecl/couchbase)");
+#endif
+    if (PCBCG(pool_prewarm) && PCBCG(pool_prewarm)[0] != '\0') {
+        php_info_print_table_row(2, "connection pool prewarm",
+                                 PCBCG(pool_prewarm_status) ? ZSTR_VAL(PCBCG(pool_prewarm_status)) : "pending");
+    } else {
+        php_info_print_table_row(2, "connection pool prewarm", "disabled");
+    }
     php_info_print_table_end();
     DISPLAY_INI_ENTRIES();
 }
@@ -1060,6 +1937,10 @@ static zend_function_entry couchbase_functions[] = {
     ZEND_NS_FE("Couchbase", fastlzDecompress, ai_Couchbase_decompress)
     ZEND_NS_FE("Couchbase", zlibCompress, ai_Couchbase_compress)
     ZEND_NS_FE("Couchbase", zlibDecompress, ai_Couchbase_decompress)
+    ZEND_NS_FE("Couchbase", lz4Compress, ai_Couchbase_compress)
+    ZEND_NS_FE("Couchbase", lz4Decompress, ai_Couchbase_decompress)
+    ZEND_NS_FE("Couchbase", zstdCompress, ai_Couchbase_compress)
+    ZEND_NS_FE("Couchbase", zstdDecompress, ai_Couchbase_decompress)
     ZEND_NS_FE("Couchbase", passthruEncoder, ai_Couchbase_passthruEncoder)
     ZEND_NS_FE("Couchbase", passthruDecoder, ai_Couchbase_passthruDecoder)
     ZEND_NS_FE("Couchbase", defaultEncoder, ai_Couchbase_passthruEncoder)
@@ -1084,6 +1965,12 @@ static zend_function_entry couchbase_functions[] = {
 #if ZEND_MODULE_API_NO >= 20050617
 static zend_module_dep php_couchbase_deps[] = {
     ZEND_MOD_REQUIRED("json")
+#if HAVE_COUCHBASE_IGBINARY
+    ZEND_MOD_REQUIRED("igbinary")
+#endif
+#if HAVE_COUCHBASE_MSGPACK
+    ZEND_MOD_REQUIRED("msgpack")
+#endif
     ZEND_MOD_END
 };
 #endif
@@ -1106,7 +1993,11 @@ zend_module_entry couchbase_module_entry = {
 #if ZEND_MODULE_API_NO >= 20010901
     PHP_COUCHBASE_VERSION,
 #endif
-    STANDARD_MODULE_PROPERTIES
+    PHP_MODULE_GLOBALS(couchbase),
+    PHP_GINIT(couchbase),
+    PHP_GSHUTDOWN(couchbase),
+    NULL,
+    STANDARD_MODULE_PROPERTIES_EX
 };
 // clang-format on
 
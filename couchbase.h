@@ -40,6 +40,14 @@
 #include "log.h"
 #include "contrib/php_array.h"
 #include <string.h>
+
+#if HAVE_COUCHBASE_ZLIB
+#include <zlib.h>
+#endif
+
+#if HAVE_COUCHBASE_ZSTD
+#include <zstd.h>
+#endif
 // clang-format on
 
 #define PCBC_ARG_VARIADIC_INFO(__pcbc_pass_by_ref, __pcbc_name)                                                        \
@@ -63,16 +71,79 @@ struct pcbc_connection {
     lcb_INSTANCE *lcb;
     int refs;
     time_t idle_at;
+    zend_string *plist_key;
+    /* cluster instance, which has bucketname opened with lcb_open() and serves Bucket objects too */
+    zend_bool shared;
+    /* lcb_connect() was called by the prewarm without lcb_wait(), the first user waits for the rest of the bootstrap */
+    zend_bool bootstrapping;
+    /* connections without references, ordered by idle_at, so the oldest one is always at the head */
+    struct pcbc_connection *idle_prev;
+    struct pcbc_connection *idle_next;
 };
 typedef struct pcbc_connection pcbc_connection_t;
 lcb_STATUS pcbc_connection_get(pcbc_connection_t **result, lcb_INSTANCE_TYPE type, const char *connstr,
                                const char *bucketname, const char *username, const char *password TSRMLS_DC);
+lcb_STATUS pcbc_connection_get_exclusive(pcbc_connection_t **result, lcb_INSTANCE_TYPE type, const char *connstr,
+                                         const char *bucketname, const char *username,
+                                         const char *password TSRMLS_DC);
+lcb_STATUS pcbc_connection_get_bucket(pcbc_connection_t **result, pcbc_connection_t *cluster, const char *connstr,
+                                      const char *bucketname, const char *username, const char *password TSRMLS_DC);
 void pcbc_connection_addref(pcbc_connection_t *conn TSRMLS_DC);
 void pcbc_connection_delref(pcbc_connection_t *conn TSRMLS_DC);
 void pcbc_connection_cleanup();
+void pcbc_connection_prewarm(TSRMLS_D);
+void pcbc_log_flush(TSRMLS_D);
+
+/* operations with latency histograms, see metrics.c */
+typedef enum {
+    PCBC_METRICS_GET = 0,
+    PCBC_METRICS_UPSERT,
+    PCBC_METRICS_QUERY,
+    PCBC_METRICS_SEARCH,
+    PCBC_METRICS_VIEW,
+    PCBC_METRICS_ANALYTICS,
+    PCBC_METRICS_HTTP,
+    PCBC_METRICS_NUM_OPS
+} pcbc_metrics_op_t;
+
+#define PCBC_METRICS_NUM_OUTCOMES 3 /* success, timeout, other error */
+#define PCBC_METRICS_PRECISION 3
+#define PCBC_METRICS_MAX_MAGNITUDE 40 /* latencies above 2^41us go into the last bucket */
+#define PCBC_METRICS_NUM_BUCKETS ((PCBC_METRICS_MAX_MAGNITUDE - PCBC_METRICS_PRECISION + 2) << PCBC_METRICS_PRECISION)
+
+/* latencies in microseconds */
+typedef struct {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint64_t buckets[PCBC_METRICS_NUM_BUCKETS];
+} pcbc_histogram_t;
+
+void pcbc_metrics_record(pcbc_metrics_op_t op, uint64_t started_at, lcb_STATUS rc TSRMLS_DC);
+void pcbc_metrics_log(TSRMLS_D);
 
 ZEND_BEGIN_MODULE_GLOBALS(couchbase)
 char *log_level;
+char *log_format;
+zend_bool log_json;
+long log_buffer_size;
+
+/* lines waiting for pcbc_log_flush(), persistent because libcouchbase might log outside of the request */
+char *log_buf;
+size_t log_buf_len;
+zend_long log_dropped;
+zend_long log_dropped_reported;
+
+pcbc_histogram_t metrics[PCBC_METRICS_NUM_OPS][PCBC_METRICS_NUM_OUTCOMES];
+/* decisions of the encoder for the values above compression threshold, see pcbc_basic_encoder_v1() */
+zend_long cmpr_attempts;
+zend_long cmpr_compressed;
+zend_long cmpr_rejected; /* compressed in full, but the result was not small enough */
+zend_long cmpr_skipped;  /* the sample predicted, that compression will not pay off */
+zend_long cmpr_bytes_in;
+zend_long cmpr_bytes_out;
+zend_bool metrics_log;
 
 char *enc_format;
 char *enc_cmpr;
@@ -80,8 +151,54 @@ int enc_format_i;
 int enc_cmpr_i;
 long enc_cmpr_threshold;
 long pool_max_idle_time;
+long pool_check_interval;
+long pool_instances_per_key;
 double enc_cmpr_factor;
+long enc_cmpr_sample;
+long enc_zstd_level;
+char *enc_zstd_dict;
+#if HAVE_COUCHBASE_ZLIB
+/* reused between the documents, see pcbc_zlib_compress() */
+z_stream zlib_deflate;
+z_stream zlib_inflate;
+zend_bool zlib_deflate_ready;
+zend_bool zlib_inflate_ready;
+#endif
+#if HAVE_COUCHBASE_ZSTD
+/* reused between the documents, see pcbc_zstd_compress() */
+ZSTD_CCtx *zstd_cctx;
+ZSTD_DCtx *zstd_dctx;
+ZSTD_CDict *zstd_cdict;
+ZSTD_DDict *zstd_ddict;
+zend_bool zstd_dict_loaded;
+#endif
+char *snappy;
+int snappy_mode; /* lcb_COMPRESSOPTS */
+long snappy_min_size;
+double snappy_min_ratio;
 zend_bool dec_json_array;
+
+char *json_buf; /* scratch buffer for zero-terminating the JSON input, see pcbc_json_decode() */
+size_t json_buf_size;
+
+/* registry of the persistent connections, see pool.c */
+pcbc_connection_t *pool_idle_head;
+pcbc_connection_t *pool_idle_tail;
+time_t pool_checked_at;
+zend_long pool_hits;
+zend_long pool_misses;
+zend_long pool_evictions;
+zend_long pool_live;
+zend_long pool_idle;
+zend_long pool_busy;
+zend_long pool_shared;
+lcb_STATUS pool_open_status; /* result of the last lcb_open(), see open_callback() */
+char *pool_prewarm;
+long pool_prewarm_jitter;
+zend_bool pool_prewarmed;
+zend_string *pool_prewarm_status; /* persistent, shown by phpinfo() */
+
+lcb_INSTANCE *future_wait_instance; /* Bucket::waitAny() runs the event loop of this instance */
 ZEND_END_MODULE_GLOBALS(couchbase)
 ZEND_EXTERN_MODULE_GLOBALS(couchbase)
 
@@ -124,6 +241,8 @@ extern zend_class_entry *pcbc_crypto_provider_ce;
 
 extern zend_class_entry *pcbc_collection_ce;
 extern zend_class_entry *pcbc_binary_collection_ce;
+extern zend_class_entry *pcbc_future_ce;
+extern zend_class_entry *pcbc_row_stream_ce;
 
 #define PCBC_RESOLVE_COLLECTION_EX(class_entry)                                                                        \
     const char *collection_str = NULL, *scope_str = NULL;                                                              \
@@ -152,6 +271,8 @@ extern zend_class_entry *pcbc_binary_collection_ce;
 void pcbc_create_lcb_exception(zval *return_value, long code, zend_string *context, zend_string *ref, int http_code,
                                const char *http_msg TSRMLS_DC);
 
+void pcbc_multi_result_add(zval *results, zend_string *id, zval *result, lcb_STATUS code TSRMLS_DC);
+
 void pcbc_exception_init(zval *return_value, long code, const char *message TSRMLS_DC);
 #define throw_pcbc_exception(__pcbc_message, __pcbc_code)                                                              \
     do {                                                                                                               \
@@ -164,16 +285,10 @@ void pcbc_exception_init(zval *return_value, long code, const char *message TSRM
 #define throw_lcb_exception(code, result_ce)                                                                           \
     do {                                                                                                               \
         zend_string *ctx = NULL, *ref = NULL;                                                                          \
-        zval *zref, __rv1, *zctx, __rv2;                                                                               \
         if (result_ce) {                                                                                               \
-            zref = zend_read_property(result_ce, return_value, ZEND_STRL("err_ref"), 0, &__rv1);                       \
-            if (Z_TYPE_P(zref) == IS_STRING) {                                                                         \
-                ref = Z_STR_P(zref);                                                                                   \
-            }                                                                                                          \
-            zctx = zend_read_property(result_ce, return_value, ZEND_STRL("err_ctx"), 0, &__rv2);                       \
-            if (Z_TYPE_P(zctx) == IS_STRING) {                                                                         \
-                ctx = Z_STR_P(zctx);                                                                                   \
-            }                                                                                                          \
+            pcbc_kv_result_t *__pcbc_result = Z_KV_RESULT_OBJ_P(return_value);                                         \
+            ref = __pcbc_result->err_ref;                                                                              \
+            ctx = __pcbc_result->err_ctx;                                                                              \
         }                                                                                                              \
         zval __pcbc_error;                                                                                             \
         ZVAL_UNDEF(&__pcbc_error);                                                                                     \
@@ -213,6 +328,17 @@ void pcbc_exception_init(zval *return_value, long code, const char *message TSRM
 #define PCBC_STRINGS(__pcbc_zval, __pcbc_smart_str)                                                                    \
     ZVAL_STRINGL(&(__pcbc_zval), ZSTR_VAL((__pcbc_smart_str).s), ZSTR_LEN((__pcbc_smart_str).s))
 #define PCBC_STRING(__pcbc_zval, __pcbc_str) ZVAL_STRING(&(__pcbc_zval), (__pcbc_str))
+/* moves buffer of the smart string into the zval without copying, the smart string becomes empty */
+#define PCBC_STRING_FROM_SMARTSTR(__pcbc_zval, __pcbc_smart_str)                                                       \
+    do {                                                                                                               \
+        if ((__pcbc_smart_str).s) {                                                                                    \
+            ZVAL_STR(&(__pcbc_zval), (__pcbc_smart_str).s);                                                            \
+            (__pcbc_smart_str).s = NULL;                                                                               \
+            (__pcbc_smart_str).a = 0;                                                                                  \
+        } else {                                                                                                       \
+            ZVAL_EMPTY_STRING(&(__pcbc_zval));                                                                         \
+        }                                                                                                              \
+    } while (0)
 
 #define pcbc_make_printable_zval(__pcbc_expr, __pcbc_expr_copy, __pcbc_use_copy)                                       \
     do {                                                                                                               \
@@ -233,16 +359,21 @@ void pcbc_exception_init(zval *return_value, long code, const char *message TSRM
         (__pcbc_error_code) = JSON_G(error_code);                                                                      \
     } while (0)
 
+int pcbc_json_decode(zval *return_value, const char *src, size_t len, int options TSRMLS_DC);
+
 #define PCBC_JSON_COPY_DECODE(__pcbc_zval, __pcbc_src, __pcbc_len, __options, __pcbc_error_code)                       \
     do {                                                                                                               \
-        char *__copy = estrndup((__pcbc_src), (__pcbc_len));                                                           \
-        PCBC_JSON_RESET_STATE;                                                                                         \
-        php_json_decode_ex((__pcbc_zval), (__copy), (__pcbc_len), (__options),                                         \
-                           PHP_JSON_PARSER_DEFAULT_DEPTH TSRMLS_CC);                                                   \
-        efree(__copy);                                                                                                 \
-        (__pcbc_error_code) = JSON_G(error_code);                                                                      \
+        (__pcbc_error_code) = pcbc_json_decode((__pcbc_zval), (__pcbc_src), (__pcbc_len), (__options)TSRMLS_CC);       \
     } while (0)
 
+/*
+ * CAS travels through PHP as base64 of its eight bytes, and is kept as native 64-bit integer everywhere else, see
+ * pcbc_kv_result_t. The decoder works on the stack, so guarded mutations do not allocate to unpack it. Partition UUID
+ * and sequence number of the mutation tokens use the same encoding.
+ */
+zend_string *pcbc_cas_encode(uint64_t cas);
+zend_bool pcbc_cas_decode(zend_string *encoded, uint64_t *cas);
+
 #define PCBC_SMARTSTR_DUP(__pcbc_smart_str, __pcbc_receiver_buf)                                                       \
     do {                                                                                                               \
         (__pcbc_receiver_buf) = estrndup(ZSTR_VAL((__pcbc_smart_str).s), ZSTR_LEN((__pcbc_smart_str).s));              \
@@ -297,6 +428,7 @@ typedef struct {
     pcbc_connection_t *conn;
     zval encoder;
     zval decoder;
+    zend_bool default_encoder; /* encoder is \Couchbase\defaultEncoder, so it can be called natively */
     lcb_BTYPE type;
     pcbc_crypto_id_t *crypto_head; /* registered crypto providers */
     pcbc_crypto_id_t *crypto_tail; /* registered crypto providers */
@@ -322,6 +454,114 @@ typedef struct {
     zend_object std;
 } pcbc_user_settings_t;
 
+typedef struct pcbc_row_stream pcbc_row_stream_t;
+typedef struct pcbc_future pcbc_future_t;
+
+/* cookie of the row-based services (N1QL, analytics, search and views) */
+typedef struct {
+    lcb_STATUS rc;
+    zval *return_value;
+    pcbc_row_stream_t *stream; /* when set, rows are queued into the stream instead of "rows" property */
+    pcbc_future_t *future;     /* when set, the future is completed by the final row */
+} pcbc_row_cookie_t;
+
+typedef void (*pcbc_row_stream_cancel_fn)(lcb_INSTANCE *instance, void *handle);
+typedef void (*pcbc_row_stream_error_fn)(zval *result, lcb_STATUS err TSRMLS_DC);
+
+/*
+ * Pending result of the operation, which has been scheduled without waiting for completion. For KV operations the
+ * first three fields repeat layout of the cookies used by the KV callbacks (rc, return_value, started_at), so that the
+ * future itself is passed to libcouchbase as the cookie of the operation. Queries pass the embedded row cookie
+ * instead, and their callbacks complete the future with the final row.
+ */
+struct pcbc_future {
+    lcb_STATUS rc;
+    zval *return_value;
+    uint64_t started_at; /* zero when the latency should not be recorded */
+    pcbc_metrics_op_t metrics_op;
+    zval result;
+    zend_class_entry *result_ce;
+    pcbc_connection_t *conn;
+    lcbtrace_SPAN *span;
+    pcbc_row_cookie_t row;          /* used only by the row-based services */
+    pcbc_row_stream_error_fn error; /* throws the error of the row-based service */
+    zend_object std;
+};
+
+#define PCBC_FUTURE_PENDING ((lcb_STATUS)-1)
+
+pcbc_future_t *pcbc_future_init(zval *return_value, pcbc_connection_t *conn, zend_class_entry *result_ce,
+                                lcbtrace_SPAN *span TSRMLS_DC);
+void pcbc_future_init_rows(pcbc_future_t *future, pcbc_row_stream_error_fn error TSRMLS_DC);
+void pcbc_future_fail(pcbc_future_t *future, lcb_STATUS err TSRMLS_DC);
+void pcbc_future_complete(pcbc_future_t *future, lcb_STATUS err TSRMLS_DC);
+void pcbc_future_notify(lcb_INSTANCE *instance TSRMLS_DC);
+
+/*
+ * Native storage of the key/value results (GetResultImpl, MutationResultImpl, LookupInResultImpl etc.). The callbacks
+ * fill the fields directly, and the accessors read them without going through the property tables.
+ */
+typedef struct {
+    lcb_STATUS status;
+    zend_string *err_ctx;
+    zend_string *err_ref;
+    uint64_t cas;
+    uint32_t flags;
+    uint8_t datatype;
+    zend_bool is_found;
+    zend_bool is_replica;
+    zend_string *data; /* document body for GetResultImpl and GetReplicaResultImpl */
+    zval content;      /* counter value, entries of the subdocument operations, or decoded body of GetResultImpl */
+    zval mutation_token;
+    zend_object std;
+} pcbc_kv_result_t;
+
+/* MutationTokenImpl keeps the token in binary form, the getters encode uuid and sequence number on demand */
+typedef struct {
+    uint16_t partition_id;
+    uint64_t partition_uuid;
+    uint64_t sequence_number;
+    zend_string *bucket_name;
+    zend_object std;
+} pcbc_mutation_token_t;
+
+void pcbc_mutation_token_init(zval *return_value, lcb_INSTANCE *instance, const lcb_MUTATION_TOKEN *token TSRMLS_DC);
+
+/*
+ * Iterator over the rows of the request, which yields them as libcouchbase delivers them. The event loop runs only
+ * while the stream has no buffered rows, and it is interrupted once the window is filled, so the memory stays bounded
+ * for large results.
+ */
+struct pcbc_row_stream {
+    pcbc_row_cookie_t cookie;
+    zval result; /* result object receiving status and metadata, its "rows" property is not used */
+    pcbc_connection_t *conn;
+    HashTable rows; /* received, but not yet consumed rows, keyed by position */
+    zend_ulong head;
+    zend_ulong tail;
+    zend_long window;
+    zend_bool done;
+    zend_bool error_thrown;
+    zend_bool waiting; /* lcb_wait() is running for this stream, and the callbacks may break out of it */
+    void *handle;
+    pcbc_row_stream_cancel_fn cancel;
+    pcbc_row_stream_error_fn error;
+    lcbtrace_SPAN *span;
+    pcbc_metrics_op_t metrics_op;
+    uint64_t started_at; /* zero when the latency should not be recorded */
+    zend_object std;
+};
+
+#define PCBC_ROW_STREAM_DEFAULT_WINDOW 1000
+
+pcbc_row_stream_t *pcbc_row_stream_init(zval *result, pcbc_connection_t *conn, zend_class_entry *result_ce,
+                                        zend_long window TSRMLS_DC);
+void pcbc_row_stream_push(pcbc_row_stream_t *stream, zval *row);
+void pcbc_row_stream_finish(pcbc_row_stream_t *stream);
+void pcbc_result_get_iterator(zval *result, zend_class_entry *result_ce, zval *return_value TSRMLS_DC);
+zval *pcbc_result_read_property(zval *result, zend_class_entry *result_ce, const char *name, size_t name_len,
+                                zval *rv TSRMLS_DC);
+
 typedef struct {
     void *next;
     lcb_STATUS err;
@@ -333,14 +573,21 @@ typedef struct {
 
 int pcbc_decode_value(zval *return_value, pcbc_bucket_t *bucket, const char *bytes, int bytes_len, uint32_t flags,
                       uint8_t datatype TSRMLS_DC);
-int pcbc_encode_value(pcbc_bucket_t *bucket, zval *value, void **bytes, lcb_size_t *nbytes, lcb_uint32_t *flags,
+int pcbc_encode_value(pcbc_bucket_t *bucket, zval *value, zend_string **bytes, lcb_uint32_t *flags,
                       uint8_t *datatype TSRMLS_DC);
+void pcbc_bucket_set_transcoder(pcbc_bucket_t *bucket, zval *encoder, zval *decoder TSRMLS_DC);
+void pcbc_basic_encoder_v1(zval *value, int sertype, int cmprtype, long cmprthresh, double cmprfactor, zval *bytes,
+                           uint32_t *flags TSRMLS_DC);
+PHP_FUNCTION(defaultEncoder);
 
 void pcbc_http_request(zval *return_value, lcb_INSTANCE *conn, lcb_CMDHTTP *cmd, int json_response TSRMLS_DC);
 
 void pcbc_query_index_manager_init(zval *return_value, zval *cluster TSRMLS_DC);
 
-void pcbc_mutation_state_export_for_n1ql(zval *obj, zval *scan_vectors TSRMLS_DC);
+/* vbucket IDs are below 1024, so MutationState keeps at most that many positions per bucket */
+#define PCBC_MAX_PARTITIONS 1024
+
+void pcbc_mutation_state_export_for_n1ql(zval *mutation_state, smart_str *scan_vectors TSRMLS_DC);
 void pcbc_mutation_state_export_for_search(zval *mutation_state, zval *scan_vectors TSRMLS_DC);
 
 void pcbc_search_index_manager_init(zval *return_value, pcbc_bucket_manager_t *bucket_manager TSRMLS_DC);
@@ -364,6 +611,22 @@ static inline pcbc_bucket_t *pcbc_bucket_fetch_object(zend_object *obj)
 {
     return (pcbc_bucket_t *)((char *)obj - XtOffsetOf(pcbc_bucket_t, std));
 }
+static inline pcbc_future_t *pcbc_future_fetch_object(zend_object *obj)
+{
+    return (pcbc_future_t *)((char *)obj - XtOffsetOf(pcbc_future_t, std));
+}
+static inline pcbc_row_stream_t *pcbc_row_stream_fetch_object(zend_object *obj)
+{
+    return (pcbc_row_stream_t *)((char *)obj - XtOffsetOf(pcbc_row_stream_t, std));
+}
+static inline pcbc_kv_result_t *pcbc_kv_result_fetch_object(zend_object *obj)
+{
+    return (pcbc_kv_result_t *)((char *)obj - XtOffsetOf(pcbc_kv_result_t, std));
+}
+static inline pcbc_mutation_token_t *pcbc_mutation_token_fetch_object(zend_object *obj)
+{
+    return (pcbc_mutation_token_t *)((char *)obj - XtOffsetOf(pcbc_mutation_token_t, std));
+}
 static inline pcbc_password_authenticator_t *pcbc_password_authenticator_fetch_object(zend_object *obj)
 {
     return (pcbc_password_authenticator_t *)((char *)obj - XtOffsetOf(pcbc_password_authenticator_t, std));
@@ -378,6 +641,14 @@ static inline pcbc_user_settings_t *pcbc_user_settings_fetch_object(zend_object
 #define Z_CLUSTER_MANAGER_OBJ_P(zv) (pcbc_cluster_manager_fetch_object(Z_OBJ_P(zv)))
 #define Z_BUCKET_OBJ(zo) (pcbc_bucket_fetch_object(zo))
 #define Z_BUCKET_OBJ_P(zv) (pcbc_bucket_fetch_object(Z_OBJ_P(zv)))
+#define Z_FUTURE_OBJ(zo) (pcbc_future_fetch_object(zo))
+#define Z_FUTURE_OBJ_P(zv) (pcbc_future_fetch_object(Z_OBJ_P(zv)))
+#define Z_ROW_STREAM_OBJ(zo) (pcbc_row_stream_fetch_object(zo))
+#define Z_ROW_STREAM_OBJ_P(zv) (pcbc_row_stream_fetch_object(Z_OBJ_P(zv)))
+#define Z_KV_RESULT_OBJ(zo) (pcbc_kv_result_fetch_object(zo))
+#define Z_KV_RESULT_OBJ_P(zv) (pcbc_kv_result_fetch_object(Z_OBJ_P(zv)))
+#define Z_MUTATION_TOKEN_OBJ(zo) (pcbc_mutation_token_fetch_object(zo))
+#define Z_MUTATION_TOKEN_OBJ_P(zv) (pcbc_mutation_token_fetch_object(Z_OBJ_P(zv)))
 #define Z_PASSWORD_AUTHENTICATOR_OBJ(zo) (pcbc_password_authenticator_fetch_object(zo))
 #define Z_PASSWORD_AUTHENTICATOR_OBJ_P(zv) (pcbc_password_authenticator_fetch_object(Z_OBJ_P(zv)))
 #define Z_USER_SETTINGS_OBJ(zo) (pcbc_user_settings_fetch_object(zo))
@@ -407,21 +678,17 @@ opcookie_res *opcookie_next_res(opcookie *cookie, opcookie_res *cur);
 
 #define PCBC_DELREF_P(__pcbc_zval) Z_TRY_DELREF_P((__pcbc_zval))
 
-#define set_property_str(target, getter, class_entry, prop)                                                            \
+#define set_result_str(target, getter, field)                                                                          \
     do {                                                                                                               \
         const char *data = NULL;                                                                                       \
         size_t ndata = 0;                                                                                              \
         getter(target, &data, &ndata);                                                                                 \
         if (ndata && data) {                                                                                           \
-            zend_update_property_stringl(class_entry, return_value, ZEND_STRL(prop), data, ndata TSRMLS_CC);           \
+            if (field) {                                                                                               \
+                zend_string_release(field);                                                                            \
+            }                                                                                                          \
+            (field) = zend_string_init(data, ndata, 0);                                                                \
         }                                                                                                              \
     } while (0);
 
-#define set_property_num(type, getter, class_entry, prop)                                                              \
-    do {                                                                                                               \
-        type data = 0;                                                                                                 \
-        getter(resp, &data);                                                                                           \
-        zend_update_property_long(class_entry, return_value, ZEND_STRL(prop), data TSRMLS_CC);                         \
-    } while (0);
-
 #endif /* COUCHBASE_H_ */
@@ -0,0 +1,49 @@
+<?php
+/**
+ * Measures the cost of the key/value results on the client side: time per
+ * get() including the accessors, and memory retained by each result object.
+ *
+ * The retained memory is measured by keeping all results of the second run in
+ * an array, so it includes the document body but not the transient
+ * allocations of the callback.
+ *
+ *   php get_benchmark.php [connection-string] [bucket] [iterations]
+ */
+
+$connstr = isset($argv[1]) ? $argv[1] : 'couchbase://localhost';
+$bucketName = isset($argv[2]) ? $argv[2] : 'default';
+$iterations = isset($argv[3]) ? (int)$argv[3] : 10000;
+
+$options = new \Couchbase\ClusterOptions();
+$options->credentials('Administrator', 'password');
+$cluster = new \Couchbase\Cluster($connstr, $options);
+$bucket = $cluster->bucket($bucketName);
+$collection = $bucket->defaultCollection();
+
+$key = 'get-benchmark';
+$collection->upsert($key, ['name' => 'Couchbase', 'type' => 'benchmark', 'counter' => 42]);
+
+$start = microtime(true);
+for ($i = 0; $i < $iterations; $i++) {
+    $collection->get($key);
+}
+$get = (microtime(true) - $start) / $iterations * 1e9;
+
+$start = microtime(true);
+for ($i = 0; $i < $iterations; $i++) {
+    $res = $collection->get($key);
+    $res->cas();
+    $res->content();
+}
+$accessors = (microtime(true) - $start) / $iterations * 1e9 - $get;
+
+$results = [];
+$memory = memory_get_usage();
+for ($i = 0; $i < $iterations; $i++) {
+    $results[] = $collection->get($key);
+}
+$retained = (memory_get_usage() - $memory) / $iterations;
+
+printf("get():             %10.0f ns/op\n", $get);
+printf("cas() + content(): %10.0f ns/op\n", $accessors);
+printf("retained result:   %10.0f bytes\n", $retained);
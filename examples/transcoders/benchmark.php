@@ -0,0 +1,53 @@
+<?php
+/**
+ * Measures per-document cost of the encoder for small documents.
+ *
+ * The default encoder is invoked natively by the extension. Wrapping it into
+ * a userland closure forces the generic path, where each document goes
+ * through call_user_function(), so the difference of the two runs shows the
+ * overhead of calling the encoder through the engine. GetResult::content()
+ * decodes the document itself, so the decoder is not measured.
+ *
+ *   php benchmark.php [connection-string] [bucket] [iterations]
+ */
+
+$connstr = isset($argv[1]) ? $argv[1] : 'couchbase://localhost';
+$bucketName = isset($argv[2]) ? $argv[2] : 'default';
+$iterations = isset($argv[3]) ? (int)$argv[3] : 10000;
+
+$options = new \Couchbase\ClusterOptions();
+$options->credentials('Administrator', 'password');
+$cluster = new \Couchbase\Cluster($connstr, $options);
+$bucket = $cluster->bucket($bucketName);
+$collection = $bucket->defaultCollection();
+
+$document = ['name' => 'Couchbase', 'type' => 'benchmark', 'tags' => ['a', 'b', 'c'], 'counter' => 42];
+
+function run($name, $collection, $document, $iterations)
+{
+    $key = 'transcoder-benchmark';
+    $collection->upsert($key, $document);
+
+    $start = microtime(true);
+    for ($i = 0; $i < $iterations; $i++) {
+        $collection->upsert($key, $document);
+    }
+    $upsert = (microtime(true) - $start) / $iterations * 1e6;
+
+    printf("%-10s upsert: %8.2f us/doc\n", $name, $upsert);
+    return $upsert;
+}
+
+$nativeUpsert = run('native', $collection, $document, $iterations);
+
+$bucket->setTranscoder(
+    function ($value) {
+        return \Couchbase\defaultEncoder($value);
+    },
+    function ($bytes, $flags, $datatype) {
+        return \Couchbase\defaultDecoder($bytes, $flags, $datatype);
+    }
+);
+$userUpsert = run('userland', $collection, $document, $iterations);
+
+printf("saving     upsert: %8.2f us/doc\n", $userUpsert - $nativeUpsert);
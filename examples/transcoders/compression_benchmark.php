@@ -0,0 +1,83 @@
+<?php
+/**
+ * Compares the compression methods of the default encoder on a sample corpus:
+ * compression ratio and throughput of encoding and decoding. The server is not
+ * involved, the documents only go through basicEncoderV1/basicDecoderV1.
+ *
+ * The corpus is a file with one JSON document per line. When the file does not
+ * exist, it is generated with the given number of synthetic documents of
+ * similar structure. To see the effect of a zstd dictionary, train it on the
+ * corpus and run the script with couchbase.encoder.zstd_dictionary:
+ *
+ *   split -l 1 corpus.jsonl /tmp/sample- && zstd --train /tmp/sample-* -o corpus.dict
+ *   php -d couchbase.encoder.zstd_dictionary=corpus.dict compression_benchmark.php corpus.jsonl
+ *
+ *   php compression_benchmark.php [corpus] [documents]
+ */
+
+$corpus = isset($argv[1]) ? $argv[1] : sys_get_temp_dir() . '/couchbase-corpus.jsonl';
+$numDocuments = isset($argv[2]) ? (int)$argv[2] : 10000;
+
+if (!file_exists($corpus)) {
+    $fp = fopen($corpus, 'w');
+    for ($i = 0; $i < $numDocuments; $i++) {
+        fwrite($fp, json_encode([
+            'id' => "airline_$i",
+            'type' => 'airline',
+            'name' => "Airline number $i",
+            'callsign' => strtoupper(substr(md5($i), 0, 8)),
+            'country' => ['United States', 'France', 'United Kingdom'][$i % 3],
+            'routes' => range($i % 7, $i % 7 + $i % 32),
+        ]) . "\n");
+    }
+    fclose($fp);
+}
+
+$documents = [];
+foreach (file($corpus, FILE_IGNORE_NEW_LINES | FILE_SKIP_EMPTY_LINES) as $line) {
+    $documents[] = json_decode($line, true);
+}
+
+$methods = ['none' => COUCHBASE_CMPRTYPE_NONE, 'fastlz' => COUCHBASE_CMPRTYPE_FASTLZ];
+if (\Couchbase\HAVE_ZLIB) {
+    $methods['zlib'] = COUCHBASE_CMPRTYPE_ZLIB;
+}
+if (\Couchbase\HAVE_LZ4) {
+    $methods['lz4'] = COUCHBASE_CMPRTYPE_LZ4;
+}
+if (\Couchbase\HAVE_ZSTD) {
+    $methods['zstd'] = COUCHBASE_CMPRTYPE_ZSTD;
+}
+
+$original = 0;
+foreach ($documents as $document) {
+    $original += strlen(json_encode($document));
+}
+
+printf("%d documents, %.1f KiB of JSON\n\n", count($documents), $original / 1024);
+printf("%-8s %8s %14s %14s\n", 'method', 'ratio', 'encode MiB/s', 'decode MiB/s');
+foreach ($methods as $name => $cmprtype) {
+    // cmprfactor 0 keeps the compressed form even when it is larger, so every document is measured
+    $options = ['cmprtype' => $cmprtype, 'cmprthresh' => 0, 'cmprfactor' => 0];
+
+    $encoded = [];
+    $start = microtime(true);
+    foreach ($documents as $document) {
+        $encoded[] = \Couchbase\basicEncoderV1($document, $options);
+    }
+    $encode = microtime(true) - $start;
+
+    $compressed = 0;
+    foreach ($encoded as $item) {
+        $compressed += strlen($item[0]);
+    }
+
+    $start = microtime(true);
+    foreach ($encoded as $item) {
+        \Couchbase\basicDecoderV1($item[0], $item[1], $item[2], ['jsonassoc' => true]);
+    }
+    $decode = microtime(true) - $start;
+
+    printf("%-8s %8.2f %14.1f %14.1f\n", $name, $original / $compressed, $original / 1048576 / $encode,
+           $original / 1048576 / $decode);
+}
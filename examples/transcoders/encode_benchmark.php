@@ -0,0 +1,64 @@
+<?php
+/**
+ * Measures the per-value cost of the default encoder on many small documents,
+ * where allocation and setup of the compressor dominate over the compression
+ * itself. The server is not involved, the documents only go through
+ * basicEncoderV1/basicDecoderV1.
+ *
+ *   php encode_benchmark.php [documents] [rounds]
+ */
+
+$numDocuments = isset($argv[1]) ? (int)$argv[1] : 10000;
+$numRounds = isset($argv[2]) ? (int)$argv[2] : 5;
+
+$documents = [];
+for ($i = 0; $i < $numDocuments; $i++) {
+    $documents[] = [
+        'id' => "user_$i",
+        'type' => 'user',
+        'name' => "User number $i",
+        'email' => "user$i@example.com",
+        'active' => $i % 2 == 0,
+    ];
+}
+
+$methods = ['none' => COUCHBASE_CMPRTYPE_NONE, 'fastlz' => COUCHBASE_CMPRTYPE_FASTLZ];
+if (\Couchbase\HAVE_ZLIB) {
+    $methods['zlib'] = COUCHBASE_CMPRTYPE_ZLIB;
+}
+if (\Couchbase\HAVE_LZ4) {
+    $methods['lz4'] = COUCHBASE_CMPRTYPE_LZ4;
+}
+if (\Couchbase\HAVE_ZSTD) {
+    $methods['zstd'] = COUCHBASE_CMPRTYPE_ZSTD;
+}
+
+printf("%d documents, %d rounds\n\n", $numDocuments, $numRounds);
+printf("%-8s %14s %14s %14s\n", 'method', 'encode ns/op', 'decode ns/op', 'peak KiB');
+foreach ($methods as $name => $cmprtype) {
+    // cmprfactor 0 keeps the compressed form even when it is larger, so every document is compressed
+    $options = ['cmprtype' => $cmprtype, 'cmprthresh' => 0, 'cmprfactor' => 0];
+    $encode = 0;
+    $decode = 0;
+    $peak = memory_get_usage();
+
+    for ($round = 0; $round < $numRounds; $round++) {
+        $encoded = [];
+        $start = microtime(true);
+        foreach ($documents as $document) {
+            $encoded[] = \Couchbase\basicEncoderV1($document, $options);
+        }
+        $encode += microtime(true) - $start;
+        $peak = max($peak, memory_get_usage());
+
+        $start = microtime(true);
+        foreach ($encoded as $item) {
+            \Couchbase\basicDecoderV1($item[0], $item[1], $item[2], ['jsonassoc' => true]);
+        }
+        $decode += microtime(true) - $start;
+    }
+
+    $ops = $numDocuments * $numRounds;
+    printf("%-8s %14.0f %14.0f %14.1f\n", $name, $encode * 1e9 / $ops, $decode * 1e9 / $ops, $peak / 1024);
+    unset($encoded);
+}
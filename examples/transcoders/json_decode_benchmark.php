@@ -0,0 +1,51 @@
+<?php
+/**
+ * Replays a recorded query result through the JSON decoding path of the
+ * extension, which is shared by N1QL, analytics, search and view rows.
+ *
+ * The fixture is a file with one JSON row per line. When it does not exist,
+ * it is recorded first by running the query against the cluster, so that the
+ * benchmark works on real documents of travel-sample rather than on rows of
+ * uniform shape. Each document is returned several times to get 100k rows.
+ * The recorded file can be kept and replayed without the cluster later.
+ *
+ *   php json_decode_benchmark.php [fixture] [connection-string] [rows]
+ */
+
+$fixture = isset($argv[1]) ? $argv[1] : sys_get_temp_dir() . '/couchbase-rows.jsonl';
+$connstr = isset($argv[2]) ? $argv[2] : 'couchbase://localhost';
+$numRows = isset($argv[3]) ? (int)$argv[3] : 100000;
+
+if (!file_exists($fixture)) {
+    $options = new \Couchbase\ClusterOptions();
+    $options->credentials('Administrator', 'password');
+    $cluster = new \Couchbase\Cluster($connstr, $options);
+
+    $statement = sprintf('SELECT d.* FROM `travel-sample` d UNNEST ARRAY_RANGE(0, 10) AS r LIMIT %d', $numRows);
+    $result = $cluster->query($statement, (new \Couchbase\QueryOptions())->streaming(true));
+    $fp = fopen($fixture, 'w');
+    $recorded = 0;
+    foreach ($result as $row) {
+        fwrite($fp, json_encode($row, JSON_UNESCAPED_SLASHES | JSON_UNESCAPED_UNICODE) . "\n");
+        $recorded++;
+    }
+    fclose($fp);
+    printf("recorded:     %d rows into %s\n", $recorded, $fixture);
+}
+
+$rows = file($fixture, FILE_IGNORE_NEW_LINES | FILE_SKIP_EMPTY_LINES);
+$flags = COUCHBASE_VAL_IS_JSON | COUCHBASE_CFFMT_JSON;
+$bytes = 0;
+
+$memory = memory_get_usage();
+$start = microtime(true);
+foreach ($rows as $row) {
+    $value = \Couchbase\basicDecoderV1($row, $flags, 0, ['jsonassoc' => true]);
+    $bytes += strlen($row);
+}
+$elapsed = microtime(true) - $start;
+
+printf("rows:         %d (%.1f MiB)\n", count($rows), $bytes / 1048576);
+printf("total:        %.3f s\n", $elapsed);
+printf("per row:      %.3f us\n", $elapsed / count($rows) * 1e6);
+printf("peak growth:  %.1f KiB\n", (memory_get_peak_usage() - $memory) / 1024);
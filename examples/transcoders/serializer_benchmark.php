@@ -0,0 +1,53 @@
+<?php
+/**
+ * Compares the serialization formats of the default encoder on a PHP object
+ * graph: size of the encoded value and time of encoding and decoding. The
+ * server is not involved, the value only goes through
+ * basicEncoderV1/basicDecoderV1. The "igbinary" and "msgpack" formats are
+ * measured when the extension was built with them.
+ *
+ *   php serializer_benchmark.php [objects] [iterations]
+ */
+
+$numObjects = isset($argv[1]) ? (int)$argv[1] : 1000;
+$iterations = isset($argv[2]) ? (int)$argv[2] : 100;
+
+$graph = [];
+for ($i = 0; $i < $numObjects; $i++) {
+    $item = new stdClass();
+    $item->id = $i;
+    $item->name = "Item number $i";
+    $item->price = $i * 1.25;
+    $item->tags = ['catalog', 'item', $i % 2 ? 'odd' : 'even'];
+    $item->parent = $i > 0 ? $graph[intdiv($i - 1, 2)] : null;
+    $graph[] = $item;
+}
+
+$formats = ['json' => COUCHBASE_SERTYPE_JSON, 'php' => COUCHBASE_SERTYPE_PHP];
+if (\Couchbase\HAVE_IGBINARY) {
+    $formats['igbinary'] = COUCHBASE_SERTYPE_IGBINARY;
+}
+if (\Couchbase\HAVE_MSGPACK) {
+    $formats['msgpack'] = COUCHBASE_SERTYPE_MSGPACK;
+}
+
+printf("%d objects, %d iterations\n\n", $numObjects, $iterations);
+printf("%-10s %12s %14s %14s\n", 'format', 'size KiB', 'encode us/op', 'decode us/op');
+foreach ($formats as $name => $sertype) {
+    $options = ['sertype' => $sertype, 'cmprtype' => COUCHBASE_CMPRTYPE_NONE];
+
+    $start = microtime(true);
+    for ($i = 0; $i < $iterations; $i++) {
+        $encoded = \Couchbase\basicEncoderV1($graph, $options);
+    }
+    $encode = microtime(true) - $start;
+
+    $start = microtime(true);
+    for ($i = 0; $i < $iterations; $i++) {
+        \Couchbase\basicDecoderV1($encoded[0], $encoded[1], $encoded[2]);
+    }
+    $decode = microtime(true) - $start;
+
+    printf("%-10s %12.1f %14.1f %14.1f\n", $name, strlen($encoded[0]) / 1024, $encode * 1e6 / $iterations,
+           $decode * 1e6 / $iterations);
+}
@@ -370,6 +370,26 @@ void pcbc_create_lcb_exception(zval *return_value, long code, zend_string *conte
     }
 }
 
+/*
+ * Stores outcome of single operation from the batch into the array of results. Successful results are stored as is,
+ * failed ones are replaced with exception object, which would be thrown by the single-document counterpart.
+ * Ownership of the result is transferred to the array.
+ */
+void pcbc_multi_result_add(zval *results, zend_string *id, zval *result, lcb_STATUS code TSRMLS_DC)
+{
+    if (code == LCB_SUCCESS) {
+        zend_symtable_update(Z_ARRVAL_P(results), id, result);
+        return;
+    }
+
+    pcbc_kv_result_t *obj = Z_KV_RESULT_OBJ_P(result);
+    zval error;
+    ZVAL_UNDEF(&error);
+    pcbc_create_lcb_exception(&error, code, obj->err_ctx, obj->err_ref, 0, NULL TSRMLS_CC);
+    zend_symtable_update(Z_ARRVAL_P(results), id, &error);
+    zval_ptr_dtor(result);
+}
+
 PHP_METHOD(BaseException, context)
 {
     if (zend_parse_parameters_none_throw() == FAILURE) {
@@ -14,10 +14,16 @@
  *   limitations under the License.
  */
 
-#include <libcouchbase/couchbase.h>
-#include <php.h>
+#include "couchbase.h"
 
-#include "log.h"
+#include <main/php_globals.h>
+#include <ext/date/php_date.h>
+#include <fcntl.h>
+#ifdef PHP_WIN32
+#include "win32/time.h"
+#else
+#include <sys/time.h>
+#endif
 
 static const char *level_to_string(int severity)
 {
@@ -40,6 +46,127 @@ static const char *level_to_string(int severity)
 }
 
 #define PCBC_LOG_MSG_SIZE 1024
+/* room for the JSON envelope or the timestamp prefix around the message */
+#define PCBC_LOG_LINE_SIZE (PCBC_LOG_MSG_SIZE + 256)
+
+/* opens error_log for appending, if it points to a file */
+static int pcbc_log_open_file(TSRMLS_D)
+{
+    if (PG(error_log) == NULL || strcmp(PG(error_log), "syslog") == 0) {
+        return -1;
+    }
+    return VCWD_OPEN_MODE(PG(error_log), O_CREAT | O_APPEND | O_WRONLY, 0644);
+}
+
+/**
+ * Writes out the buffered lines. When error_log points to a file, the whole batch goes there with single write(),
+ * otherwise every line is passed to php_log_err() as if it was not buffered.
+ */
+void pcbc_log_flush(TSRMLS_D)
+{
+    char *line, *end, *eol, *prefix_end;
+    int fd;
+
+    if (PCBCG(log_buf_len) > 0) {
+        fd = pcbc_log_open_file(TSRMLS_C);
+        if (fd != -1) {
+            ssize_t written = write(fd, PCBCG(log_buf), PCBCG(log_buf_len));
+            close(fd);
+            if (written < 0) {
+                written = 0;
+            }
+            for (line = PCBCG(log_buf) + written, end = PCBCG(log_buf) + PCBCG(log_buf_len); line < end; line++) {
+                if (*line == '\n') {
+                    PCBCG(log_dropped)++;
+                }
+            }
+        } else {
+            line = PCBCG(log_buf);
+            end = PCBCG(log_buf) + PCBCG(log_buf_len);
+            while (line < end) {
+                eol = memchr(line, '\n', end - line);
+                *eol = '\0';
+                /* php_log_err() adds its own timestamp */
+                if (*line == '[' && strncmp(line, "[cb,", 4) != 0 && (prefix_end = strstr(line, "] ")) != NULL) {
+                    line = prefix_end + 2;
+                }
+                php_log_err(line TSRMLS_CC);
+                line = eol + 1;
+            }
+        }
+        PCBCG(log_buf_len) = 0;
+    }
+
+    if (PCBCG(log_dropped) > PCBCG(log_dropped_reported)) {
+        char buf[128];
+        snprintf(buf, sizeof(buf), "[cb,WARN] (pcbc/log L:%d) " ZEND_LONG_FMT " log messages were dropped",
+                 __LINE__, PCBCG(log_dropped) - PCBCG(log_dropped_reported));
+        PCBCG(log_dropped_reported) = PCBCG(log_dropped);
+        php_log_err(buf TSRMLS_CC);
+    }
+}
+
+static void pcbc_log_write(int severity, const char *subsys, int srcline, int instance_id, void *instance_ptr,
+                           int is_lcb, const char *fmt, va_list ap TSRMLS_DC)
+{
+    char buf[PCBC_LOG_LINE_SIZE] = {0};
+    char format[64];
+    struct timeval tv;
+    zend_string *date;
+    size_t prefix_len = 0, len;
+
+    /* the times are formatted by the date extension in date.timezone, like php_log_err() does for its prefix */
+    gettimeofday(&tv, NULL);
+    if (PCBCG(log_json)) {
+        /* the digits are not format characters, so the microseconds pass through php_format_date() as is */
+        snprintf(format, sizeof(format), "Y-m-d\\TH:i:s.%06ldP", (long)tv.tv_usec);
+        date = php_format_date(format, strlen(format), tv.tv_sec, 1);
+        pcbc_log_formatter_json(buf, PCBC_LOG_LINE_SIZE, ZSTR_VAL(date), level_to_string(severity), subsys, srcline,
+                                instance_id, instance_ptr, is_lcb, fmt, ap);
+        zend_string_release(date);
+    } else {
+        if (PCBCG(log_buffer_size) > 0) {
+            /* same layout as php_log_err() uses for error_log files */
+            date = php_format_date(ZEND_STRL("d-M-Y H:i:s e"), tv.tv_sec, 1);
+            prefix_len = snprintf(buf, sizeof(buf), "[%s] ", ZSTR_VAL(date));
+            zend_string_release(date);
+        }
+        pcbc_log_formatter(buf + prefix_len, PCBC_LOG_MSG_SIZE, level_to_string(severity), subsys, srcline,
+                           instance_id, instance_ptr, is_lcb, fmt, ap);
+    }
+
+    if (PCBCG(log_buffer_size) <= 0) {
+        int fd;
+
+        /* php_log_err() would prepend its timestamp to the JSON object in the error_log file */
+        if (PCBCG(log_json) && (fd = pcbc_log_open_file(TSRMLS_C)) != -1) {
+            len = strlen(buf);
+            buf[len] = '\n';
+            if (write(fd, buf, len + 1) < 0) {
+                PCBCG(log_dropped)++;
+            }
+            close(fd);
+            return;
+        }
+        php_log_err(buf TSRMLS_CC);
+        return;
+    }
+
+    len = strlen(buf);
+    if (PCBCG(log_buf_len) + len + 1 > (size_t)PCBCG(log_buffer_size)) {
+        pcbc_log_flush(TSRMLS_C);
+    }
+    if (len + 1 > (size_t)PCBCG(log_buffer_size)) {
+        php_log_err(buf + prefix_len TSRMLS_CC);
+        return;
+    }
+    if (PCBCG(log_buf) == NULL) {
+        PCBCG(log_buf) = pemalloc(PCBCG(log_buffer_size), 1);
+    }
+    memcpy(PCBCG(log_buf) + PCBCG(log_buf_len), buf, len);
+    PCBCG(log_buf)[PCBCG(log_buf_len) + len] = '\n';
+    PCBCG(log_buf_len) += len + 1;
+}
 
 static void log_handler(const lcb_LOGGER *logger, uint64_t iid, const char *subsys, lcb_LOG_SEVERITY severity,
                         const char *srcfile, int srcline, const char *fmt, va_list ap)
@@ -51,11 +178,9 @@ static void log_handler(const lcb_LOGGER *logger, uint64_t iid, const char *subs
         return;
     }
 
-    char buf[PCBC_LOG_MSG_SIZE] = {0};
     TSRMLS_FETCH();
 
-    pcbc_log_formatter(buf, PCBC_LOG_MSG_SIZE, level_to_string(severity), subsys, srcline, iid, NULL, 1, fmt, ap);
-    php_log_err(buf TSRMLS_CC);
+    pcbc_log_write(severity, subsys, srcline, iid, NULL, 1, fmt, ap TSRMLS_CC);
 }
 
 struct pcbc_logger_st pcbc_logger = {LCB_LOG_INFO, log_handler};
@@ -64,7 +189,6 @@ void pcbc_log(int severity, lcb_INSTANCE *instance, const char *subsys, const ch
               const char *fmt, ...)
 {
     va_list ap;
-    char buf[PCBC_LOG_MSG_SIZE] = {0};
     TSRMLS_FETCH();
 
     if (severity < pcbc_logger.minlevel) {
@@ -72,9 +196,6 @@ void pcbc_log(int severity, lcb_INSTANCE *instance, const char *subsys, const ch
     }
 
     va_start(ap, fmt);
-    pcbc_log_formatter(buf, PCBC_LOG_MSG_SIZE, level_to_string(severity), subsys, srcline, 0, (void *)instance, 0, fmt,
-                       ap);
+    pcbc_log_write(severity, subsys, srcline, 0, (void *)instance, 0, fmt, ap TSRMLS_CC);
     va_end(ap);
-
-    php_log_err(buf TSRMLS_CC);
 }
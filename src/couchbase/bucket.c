@@ -23,6 +23,8 @@ extern zend_class_entry *pcbc_scope_ce;
 
 PHP_METHOD(Bucket, ping);
 PHP_METHOD(Bucket, diagnostics);
+PHP_METHOD(Bucket, wait);
+PHP_METHOD(Bucket, waitAny);
 
 PHP_METHOD(Bucket, viewQuery);
 
@@ -42,17 +44,7 @@ PHP_METHOD(Bucket, setTranscoder)
         RETURN_NULL();
     }
 
-    if (!Z_ISUNDEF(obj->encoder)) {
-        zval_ptr_dtor(&obj->encoder);
-        ZVAL_UNDEF(&obj->encoder);
-    }
-    ZVAL_ZVAL(&obj->encoder, encoder, 1, 0);
-
-    if (!Z_ISUNDEF(obj->decoder)) {
-        zval_ptr_dtor(&obj->decoder);
-        ZVAL_UNDEF(&obj->decoder);
-    }
-    ZVAL_ZVAL(&obj->decoder, decoder, 1, 0);
+    pcbc_bucket_set_transcoder(obj, encoder, decoder TSRMLS_CC);
 
     RETURN_NULL();
 }
@@ -253,6 +245,14 @@ ZEND_BEGIN_ARG_INFO_EX(ai_Bucket_diag, 0, 0, 1)
 ZEND_ARG_INFO(0, reportId)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(ai_Bucket_wait, IS_ARRAY, 0)
+ZEND_ARG_TYPE_INFO(0, futures, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(ai_Bucket_waitAny, 0, 0, 1)
+ZEND_ARG_TYPE_INFO(0, futures, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
 PHP_METHOD(Bucket, defaultCollection);
 ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_Bucket_defaultCollection, 0, 0, \\Couchbase\\Collection, 0)
 ZEND_END_ARG_INFO()
@@ -276,6 +276,8 @@ zend_function_entry bucket_methods[] = {
     PHP_ME(Bucket, viewQuery, ai_Bucket_viewQuery, ZEND_ACC_PUBLIC)
     PHP_ME(Bucket, ping, ai_Bucket_ping, ZEND_ACC_PUBLIC)
     PHP_ME(Bucket, diagnostics, ai_Bucket_diag, ZEND_ACC_PUBLIC)
+    PHP_ME(Bucket, wait, ai_Bucket_wait, ZEND_ACC_PUBLIC)
+    PHP_ME(Bucket, waitAny, ai_Bucket_waitAny, ZEND_ACC_PUBLIC)
     PHP_ME(Bucket, defaultCollection, ai_Bucket_defaultCollection, ZEND_ACC_PUBLIC)
     PHP_ME(Bucket, defaultScope, ai_Bucket_defaultScope, ZEND_ACC_PUBLIC)
     PHP_ME(Bucket, scope, ai_Bucket_scope, ZEND_ACC_PUBLIC)
@@ -22,16 +22,11 @@ extern zend_class_entry *pcbc_analytics_result_impl_ce;
 extern zend_class_entry *pcbc_query_meta_data_impl_ce;
 zend_class_entry *pcbc_analytics_options_ce;
 
-struct query_cookie {
-    lcb_STATUS rc;
-    zval *return_value;
-};
-
 static void analytics_callback(lcb_INSTANCE *instance, int ignoreme, const lcb_RESPANALYTICS *resp)
 {
     TSRMLS_FETCH();
 
-    struct query_cookie *cookie;
+    pcbc_row_cookie_t *cookie;
     lcb_respanalytics_cookie(resp, (void **)&cookie);
     cookie->rc = lcb_respanalytics_status(resp);
     zval *return_value = cookie->return_value;
@@ -87,12 +82,51 @@ static void analytics_callback(lcb_INSTANCE *instance, int ignoreme, const lcb_R
                 zend_update_property(pcbc_query_meta_data_impl_ce, &meta, ZEND_STRL("metrics"), mval TSRMLS_CC);
             }
             zend_update_property(pcbc_analytics_result_impl_ce, return_value, ZEND_STRL("meta"), &meta TSRMLS_CC);
+            Z_DELREF(meta);
+            zval_dtor(&value);
+        } else if (cookie->stream) {
+            pcbc_row_stream_push(cookie->stream, &value);
         } else {
             zval *rows, rv;
             rows = zend_read_property(pcbc_analytics_result_impl_ce, return_value, ZEND_STRL("rows"), 0, &rv);
             add_next_index_zval(rows, &value);
         }
     }
+    if (cookie->stream && lcb_respanalytics_is_final(resp)) {
+        pcbc_row_stream_finish(cookie->stream);
+    }
+}
+
+static void pcbc_analytics_cancel(lcb_INSTANCE *instance, void *handle)
+{
+    lcb_analytics_cancel(instance, (lcb_ANALYTICS_HANDLE *)handle);
+}
+
+static void pcbc_analytics_throw_error(zval *result, lcb_STATUS err TSRMLS_DC)
+{
+    int code = 0;
+    char msg[200] = {0};
+    zval *meta = NULL, mret;
+    meta = zend_read_property(pcbc_analytics_result_impl_ce, result, ZEND_STRL("meta"), 0, &mret);
+    if (meta && Z_TYPE_P(meta) == IS_OBJECT) {
+        zval *prop, ret;
+        prop = zend_read_property(pcbc_query_meta_data_impl_ce, meta, ZEND_STRL("errors"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_ARRAY) {
+            zval *entry = zend_hash_index_find(Z_ARRVAL_P(prop), 0);
+            if (entry && Z_TYPE_P(entry) == IS_ARRAY) {
+                zval *val;
+                val = zend_symtable_str_find(Z_ARRVAL_P(entry), ZEND_STRL("code"));
+                if (val && Z_TYPE_P(val) == IS_LONG) {
+                    code = Z_LVAL_P(val);
+                }
+                val = zend_symtable_str_find(Z_ARRVAL_P(entry), ZEND_STRL("msg"));
+                if (val && Z_TYPE_P(val) == IS_STRING) {
+                    strncpy(msg, Z_STRVAL_P(val), sizeof(msg) - 1);
+                }
+            }
+        }
+    }
+    throw_http_exception(err, code, msg[0] ? msg : NULL);
 }
 
 PHP_METHOD(AnalyticsOptions, timeout)
@@ -245,6 +279,21 @@ PHP_METHOD(AnalyticsOptions, readonly)
     RETURN_ZVAL(getThis(), 1, 0);
 }
 
+PHP_METHOD(AnalyticsOptions, streaming)
+{
+    zend_bool arg;
+    zend_long window = 0;
+    int rv = zend_parse_parameters_throw(ZEND_NUM_ARGS() TSRMLS_CC, "b|l", &arg, &window);
+    if (rv == FAILURE) {
+        RETURN_NULL();
+    }
+    zend_update_property_bool(pcbc_analytics_options_ce, getThis(), ZEND_STRL("streaming"), arg TSRMLS_CC);
+    if (window > 0) {
+        zend_update_property_long(pcbc_analytics_options_ce, getThis(), ZEND_STRL("stream_window"), window TSRMLS_CC);
+    }
+    RETURN_ZVAL(getThis(), 1, 0);
+}
+
 ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_AnalyticsOptions_timeout, 0, 1, \\Couchbase\\AnalyticsOptions, 0)
 ZEND_ARG_TYPE_INFO(0, arg, IS_LONG, 0)
 ZEND_END_ARG_INFO()
@@ -278,6 +327,11 @@ ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_AnalyticsOptions_priority, 0, 1, \\Cou
 ZEND_ARG_TYPE_INFO(0, arg, _IS_BOOL, 0)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_AnalyticsOptions_streaming, 0, 1, \\Couchbase\\AnalyticsOptions, 0)
+ZEND_ARG_TYPE_INFO(0, enabled, _IS_BOOL, 0)
+ZEND_ARG_TYPE_INFO(0, rowWindow, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
 // clang-format off
 static const zend_function_entry pcbc_analytics_options_methods[] = {
     PHP_ME(AnalyticsOptions, timeout, ai_AnalyticsOptions_timeout, ZEND_ACC_PUBLIC)
@@ -288,6 +342,7 @@ static const zend_function_entry pcbc_analytics_options_methods[] = {
     PHP_ME(AnalyticsOptions, priority, ai_AnalyticsOptions_priority, ZEND_ACC_PUBLIC)
     PHP_ME(AnalyticsOptions, readonly, ai_AnalyticsOptions_readonly, ZEND_ACC_PUBLIC)
     PHP_ME(AnalyticsOptions, scanConsistency, ai_AnalyticsOptions_scanConsistency, ZEND_ACC_PUBLIC)
+    PHP_ME(AnalyticsOptions, streaming, ai_AnalyticsOptions_streaming, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
 // clang-format on
@@ -297,6 +352,8 @@ PHP_METHOD(Cluster, analyticsQuery)
     lcb_STATUS err;
     zend_string *statement;
     zval *options = NULL;
+    zend_bool streaming = 0;
+    zend_long stream_window = 0;
 
     int rv =
         zend_parse_parameters_throw(ZEND_NUM_ARGS() TSRMLS_CC, "S|O", &statement, &options, pcbc_analytics_options_ce);
@@ -356,19 +413,56 @@ PHP_METHOD(Cluster, analyticsQuery)
             }
             ZEND_HASH_FOREACH_END();
         }
+        prop = zend_read_property(pcbc_analytics_options_ce, options, ZEND_STRL("streaming"), 0, &ret);
+        streaming = Z_TYPE_P(prop) == IS_TRUE;
+        prop = zend_read_property(pcbc_analytics_options_ce, options, ZEND_STRL("stream_window"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_LONG) {
+            stream_window = Z_LVAL_P(prop);
+        }
     }
 
     lcb_ANALYTICS_HANDLE *handle = NULL;
     lcb_cmdanalytics_handle(cmd, &handle);
 
+    /* the streamed rows are fetched on the instance, which is not driven by the other objects */
+    pcbc_connection_t *conn = cluster->conn;
+    if (streaming) {
+        err = pcbc_connection_get_exclusive(&conn, LCB_TYPE_CLUSTER, cluster->connstr, NULL, cluster->username,
+                                            cluster->password TSRMLS_CC);
+        if (err != LCB_SUCCESS) {
+            lcb_cmdanalytics_destroy(cmd);
+            throw_lcb_exception(err, NULL);
+            return;
+        }
+    }
     lcbtrace_SPAN *span = NULL;
-    lcbtrace_TRACER *tracer = lcb_get_tracer(cluster->conn->lcb);
+    lcbtrace_TRACER *tracer = lcb_get_tracer(conn->lcb);
     if (tracer) {
         span = lcbtrace_span_start(tracer, "php/analytics", 0, NULL);
         lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_COMPONENT, pcbc_client_string);
         lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_SERVICE, LCBTRACE_TAG_SERVICE_ANALYTICS);
         lcb_cmdanalytics_parent_span(cmd, span);
     }
+    if (streaming) {
+        pcbc_row_stream_t *stream =
+            pcbc_row_stream_init(return_value, conn, pcbc_analytics_result_impl_ce, stream_window TSRMLS_CC);
+        pcbc_connection_delref(conn TSRMLS_CC); /* the stream holds its own reference */
+        stream->cancel = pcbc_analytics_cancel;
+        stream->error = pcbc_analytics_throw_error;
+        stream->span = span;
+        stream->metrics_op = PCBC_METRICS_ANALYTICS;
+        stream->started_at = lcbtrace_now();
+        err = lcb_analytics(conn->lcb, &stream->cookie, cmd);
+        lcb_cmdanalytics_destroy(cmd);
+        if (err != LCB_SUCCESS) {
+            pcbc_row_stream_finish(stream);
+            throw_http_exception(err, 0, NULL);
+            return;
+        }
+        /* the rows will be fetched by the stream, when the application iterates over them */
+        stream->handle = handle;
+        return;
+    }
     rv = object_init_ex(return_value, pcbc_analytics_result_impl_ce);
     if (rv != SUCCESS) {
         return;
@@ -376,7 +470,9 @@ PHP_METHOD(Cluster, analyticsQuery)
     zval rows;
     array_init(&rows);
     zend_update_property(pcbc_analytics_result_impl_ce, return_value, ZEND_STRL("rows"), &rows TSRMLS_CC);
-    struct query_cookie cookie = {LCB_SUCCESS, return_value};
+    Z_DELREF(rows);
+    pcbc_row_cookie_t cookie = {LCB_SUCCESS, return_value, NULL};
+    uint64_t started_at = lcbtrace_now();
     err = lcb_analytics(cluster->conn->lcb, &cookie, cmd);
     lcb_cmdanalytics_destroy(cmd);
     if (err == LCB_SUCCESS) {
@@ -386,8 +482,9 @@ PHP_METHOD(Cluster, analyticsQuery)
     if (span) {
         lcbtrace_span_finish(span, LCBTRACE_NOW);
     }
+    pcbc_metrics_record(PCBC_METRICS_ANALYTICS, started_at, err TSRMLS_CC);
     if (err != LCB_SUCCESS) {
-        throw_lcb_exception(err, NULL);
+        pcbc_analytics_throw_error(return_value, err TSRMLS_CC);
     }
 }
 
@@ -406,6 +503,8 @@ PHP_MINIT_FUNCTION(AnalyticsQuery)
     zend_declare_property_null(pcbc_analytics_options_ce, ZEND_STRL("priority"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_analytics_options_ce, ZEND_STRL("readonly"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_analytics_options_ce, ZEND_STRL("client_context_id"), ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_null(pcbc_analytics_options_ce, ZEND_STRL("streaming"), ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_null(pcbc_analytics_options_ce, ZEND_STRL("stream_window"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     return SUCCESS;
 }
@@ -21,16 +21,11 @@
 extern zend_class_entry *pcbc_search_result_impl_ce;
 extern zend_class_entry *pcbc_search_meta_data_impl_ce;
 
-struct search_cookie {
-    lcb_STATUS rc;
-    zval *return_value;
-};
-
 static void ftsrow_callback(lcb_INSTANCE *instance, int ignoreme, const lcb_RESPSEARCH *resp)
 {
     TSRMLS_FETCH();
 
-    struct search_cookie *cookie;
+    pcbc_row_cookie_t *cookie;
     lcb_respsearch_cookie(resp, (void **)&cookie);
     cookie->rc = lcb_respsearch_status(resp);
     zval *return_value = cookie->return_value;
@@ -52,6 +47,12 @@ static void ftsrow_callback(lcb_INSTANCE *instance, int ignoreme, const lcb_RESP
         }
         if (lcb_respsearch_is_final(resp)) {
             zval meta, *mval, *mstatus;
+            if (Z_TYPE(value) != IS_ARRAY) {
+                /* the service reports some of the errors as plain text */
+                zval_dtor(&value);
+                array_init(&value);
+                add_assoc_stringl(&value, "error", (char *)row, nrow);
+            }
             object_init_ex(&meta, pcbc_search_meta_data_impl_ce);
             HashTable *marr = Z_ARRVAL(value);
 
@@ -76,7 +77,6 @@ static void ftsrow_callback(lcb_INSTANCE *instance, int ignoreme, const lcb_RESP
             if (mstatus) {
                 switch (Z_TYPE_P(mstatus)) {
                 case IS_STRING:
-                    // TODO: read and expose value in "error" key
                     zend_update_property_stringl(pcbc_search_meta_data_impl_ce, &meta, ZEND_STRL("status"),
                                                  Z_STRVAL_P(mstatus), Z_STRLEN_P(mstatus) TSRMLS_CC);
                     break;
@@ -96,27 +96,61 @@ static void ftsrow_callback(lcb_INSTANCE *instance, int ignoreme, const lcb_RESP
                     break;
                 }
             }
+            mval = zend_symtable_str_find(marr, ZEND_STRL("error"));
+            if (mval && Z_TYPE_P(mval) == IS_STRING) {
+                zend_update_property(pcbc_search_meta_data_impl_ce, &meta, ZEND_STRL("error"), mval TSRMLS_CC);
+            }
             zend_update_property(pcbc_search_result_impl_ce, return_value, ZEND_STRL("meta"), &meta TSRMLS_CC);
             Z_DELREF(meta);
             mval = zend_symtable_str_find(marr, ZEND_STRL("facets"));
             if (mval) {
                 zend_update_property(pcbc_search_result_impl_ce, return_value, ZEND_STRL("facets"), mval TSRMLS_CC);
             }
+            zval_dtor(&value);
+        } else if (cookie->stream) {
+            pcbc_row_stream_push(cookie->stream, &value);
         } else {
             zval *hits, rv;
             hits = zend_read_property(pcbc_search_result_impl_ce, return_value, ZEND_STRL("rows"), 0, &rv);
             add_next_index_zval(hits, &value);
         }
-        zval_dtor(&value);
+    }
+    if (cookie->stream && lcb_respsearch_is_final(resp)) {
+        pcbc_row_stream_finish(cookie->stream);
+    }
+    if (cookie->future && lcb_respsearch_is_final(resp)) {
+        pcbc_future_complete(cookie->future, cookie->rc TSRMLS_CC);
     }
 }
 
-PHP_METHOD(Cluster, searchQuery)
+static void pcbc_search_cancel(lcb_INSTANCE *instance, void *handle)
+{
+    lcb_search_cancel(instance, (lcb_SEARCH_HANDLE *)handle);
+}
+
+static void pcbc_search_throw_error(zval *result, lcb_STATUS err TSRMLS_DC)
+{
+    const char *msg = NULL;
+    zval *meta = NULL, mret;
+    meta = zend_read_property(pcbc_search_result_impl_ce, result, ZEND_STRL("meta"), 0, &mret);
+    if (meta && Z_TYPE_P(meta) == IS_OBJECT) {
+        zval *prop, ret;
+        prop = zend_read_property(pcbc_search_meta_data_impl_ce, meta, ZEND_STRL("error"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_STRING) {
+            msg = Z_STRVAL_P(prop);
+        }
+    }
+    throw_http_exception(err, 0, msg);
+}
+
+static void pcbc_cluster_search_query(INTERNAL_FUNCTION_PARAMETERS, zend_bool async)
 {
     lcb_STATUS err;
     zend_string *index;
     zval *query;
     zval *options = NULL;
+    zend_bool streaming = 0;
+    zend_long stream_window = 0;
     int rv;
 
     rv = zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "SO|O", &index, &query, pcbc_search_query_ce, &options,
@@ -138,6 +172,13 @@ PHP_METHOD(Cluster, searchQuery)
         if (rv != FAILURE && !EG(exception) && !Z_ISUNDEF(values)) {
             zend_hash_merge(HASH_OF(&payload), HASH_OF(&values), NULL, 0);
         }
+        zval *prop, ret;
+        prop = zend_read_property(pcbc_search_options_ce, options, ZEND_STRL("streaming"), 0, &ret);
+        streaming = Z_TYPE_P(prop) == IS_TRUE;
+        prop = zend_read_property(pcbc_search_options_ce, options, ZEND_STRL("stream_window"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_LONG) {
+            stream_window = Z_LVAL_P(prop);
+        }
     }
 
     pcbc_cluster_t *cluster = Z_CLUSTER_OBJ_P(getThis());
@@ -159,23 +200,72 @@ PHP_METHOD(Cluster, searchQuery)
     smart_str_0(&buf);
     lcb_cmdsearch_payload(cmd, ZSTR_VAL(buf.s), ZSTR_LEN(buf.s));
 
-    object_init_ex(return_value, pcbc_search_result_impl_ce);
-    zval hits;
-    array_init(&hits);
-    zend_update_property(pcbc_search_result_impl_ce, return_value, ZEND_STRL("rows"), &hits TSRMLS_CC);
-    Z_DELREF(hits);
-    struct search_cookie cookie = {LCB_SUCCESS, return_value};
-
     lcb_SEARCH_HANDLE *handle = NULL;
     lcb_cmdsearch_handle(cmd, &handle);
+    /* the streamed rows are fetched on the instance, which is not driven by the other objects */
+    pcbc_connection_t *conn = cluster->conn;
+    if (streaming && !async) {
+        err = pcbc_connection_get_exclusive(&conn, LCB_TYPE_CLUSTER, cluster->connstr, NULL, cluster->username,
+                                            cluster->password TSRMLS_CC);
+        if (err != LCB_SUCCESS) {
+            lcb_cmdsearch_destroy(cmd);
+            smart_str_free(&buf);
+            throw_lcb_exception(err, NULL);
+            return;
+        }
+    }
     lcbtrace_SPAN *span = NULL;
-    lcbtrace_TRACER *tracer = lcb_get_tracer(cluster->conn->lcb);
+    lcbtrace_TRACER *tracer = lcb_get_tracer(conn->lcb);
     if (tracer) {
         span = lcbtrace_span_start(tracer, "php/search", 0, NULL);
         lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_COMPONENT, pcbc_client_string);
         lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_SERVICE, LCBTRACE_TAG_SERVICE_SEARCH);
         lcb_cmdsearch_parent_span(cmd, span);
     }
+    if (async) {
+        /* the hits are collected into the result of the future, the streaming options are not applicable */
+        pcbc_future_t *future =
+            pcbc_future_init(return_value, cluster->conn, pcbc_search_result_impl_ce, span TSRMLS_CC);
+        pcbc_future_init_rows(future, pcbc_search_throw_error TSRMLS_CC);
+        future->metrics_op = PCBC_METRICS_SEARCH;
+        future->started_at = lcbtrace_now();
+        err = lcb_search(cluster->conn->lcb, &future->row, cmd);
+        lcb_cmdsearch_destroy(cmd);
+        smart_str_free(&buf);
+        if (err != LCB_SUCCESS) {
+            pcbc_future_fail(future, err TSRMLS_CC);
+        }
+        return;
+    }
+    if (streaming) {
+        pcbc_row_stream_t *stream =
+            pcbc_row_stream_init(return_value, conn, pcbc_search_result_impl_ce, stream_window TSRMLS_CC);
+        pcbc_connection_delref(conn TSRMLS_CC); /* the stream holds its own reference */
+        stream->cancel = pcbc_search_cancel;
+        stream->error = pcbc_search_throw_error;
+        stream->span = span;
+        stream->metrics_op = PCBC_METRICS_SEARCH;
+        stream->started_at = lcbtrace_now();
+        err = lcb_search(conn->lcb, &stream->cookie, cmd);
+        lcb_cmdsearch_destroy(cmd);
+        smart_str_free(&buf);
+        if (err != LCB_SUCCESS) {
+            pcbc_row_stream_finish(stream);
+            throw_http_exception(err, 0, NULL);
+            return;
+        }
+        /* the hits will be fetched by the stream, when the application iterates over them */
+        stream->handle = handle;
+        return;
+    }
+
+    object_init_ex(return_value, pcbc_search_result_impl_ce);
+    zval hits;
+    array_init(&hits);
+    zend_update_property(pcbc_search_result_impl_ce, return_value, ZEND_STRL("rows"), &hits TSRMLS_CC);
+    Z_DELREF(hits);
+    pcbc_row_cookie_t cookie = {LCB_SUCCESS, return_value, NULL};
+    uint64_t started_at = lcbtrace_now();
     err = lcb_search(cluster->conn->lcb, &cookie, cmd);
     lcb_cmdsearch_destroy(cmd);
     smart_str_free(&buf);
@@ -186,11 +276,22 @@ PHP_METHOD(Cluster, searchQuery)
     if (span) {
         lcbtrace_span_finish(span, LCBTRACE_NOW);
     }
+    pcbc_metrics_record(PCBC_METRICS_SEARCH, started_at, err TSRMLS_CC);
     if (err != LCB_SUCCESS) {
-        throw_lcb_exception(err, NULL);
+        pcbc_search_throw_error(return_value, err TSRMLS_CC);
     }
 }
 
+PHP_METHOD(Cluster, searchQuery)
+{
+    pcbc_cluster_search_query(INTERNAL_FUNCTION_PARAM_PASSTHRU, 0);
+}
+
+PHP_METHOD(Cluster, searchQueryAsync)
+{
+    pcbc_cluster_search_query(INTERNAL_FUNCTION_PARAM_PASSTHRU, 1);
+}
+
 /*
  * vim: et ts=4 sw=4 sts=4
  */
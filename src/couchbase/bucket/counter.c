@@ -19,7 +19,6 @@
 #define LOGARGS(instance, lvl) LCB_LOG_##lvl, instance, "pcbc/counter", __FILE__, __LINE__
 
 extern zend_class_entry *pcbc_counter_result_impl_ce;
-extern zend_class_entry *pcbc_mutation_token_impl_ce;
 
 struct counter_cookie {
     lcb_STATUS rc;
@@ -33,49 +32,25 @@ void counter_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPCOUNTER
     const lcb_KEY_VALUE_ERROR_CONTEXT *ectx = NULL;
     struct counter_cookie *cookie = NULL;
     lcb_respcounter_cookie(resp, (void **)&cookie);
-    zval *return_value = cookie->return_value;
+    pcbc_kv_result_t *result = Z_KV_RESULT_OBJ_P(cookie->return_value);
     cookie->rc = lcb_respcounter_status(resp);
-    zend_update_property_long(pcbc_counter_result_impl_ce, return_value, ZEND_STRL("status"), cookie->rc TSRMLS_CC);
+    result->status = cookie->rc;
     lcb_respcounter_error_context(resp, &ectx);
 
-    set_property_str(ectx, lcb_errctx_kv_context, pcbc_counter_result_impl_ce, "err_ctx");
-    set_property_str(ectx, lcb_errctx_kv_ref, pcbc_counter_result_impl_ce, "err_ref");
-    set_property_str(ectx, lcb_errctx_kv_key, pcbc_counter_result_impl_ce, "key");
+    set_result_str(ectx, lcb_errctx_kv_context, result->err_ctx);
+    set_result_str(ectx, lcb_errctx_kv_ref, result->err_ref);
 
     if (cookie->rc == LCB_SUCCESS) {
         uint64_t value = 0;
         lcb_respcounter_value(resp, &value);
-        zend_update_property_long(pcbc_counter_result_impl_ce, return_value, ZEND_STRL("content"), value TSRMLS_CC);
+        ZVAL_LONG(&result->content, value);
 
-        zend_string *b64;
-        {
-            uint64_t data;
-            lcb_respcounter_cas(resp, &data);
-            b64 = php_base64_encode((unsigned char *)&data, sizeof(data));
-            zend_update_property_str(pcbc_counter_result_impl_ce, return_value, ZEND_STRL("cas"), b64 TSRMLS_CC);
-        }
+        lcb_respcounter_cas(resp, &result->cas);
         {
             lcb_MUTATION_TOKEN token = {0};
             lcb_respcounter_mutation_token(resp, &token);
             if (lcb_mutation_token_is_valid(&token)) {
-                zval val;
-                object_init_ex(&val, pcbc_mutation_token_impl_ce);
-
-                zend_update_property_long(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("partition_id"),
-                                          token.vbid_ TSRMLS_CC);
-                b64 = php_base64_encode((unsigned char *)&token.uuid_, sizeof(token.uuid_));
-                zend_update_property_str(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("partition_uuid"), b64 TSRMLS_CC);
-                b64 = php_base64_encode((unsigned char *)&token.seqno_, sizeof(token.seqno_));
-                zend_update_property_str(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("sequence_number"),
-                                         b64 TSRMLS_CC);
-
-                const char *bucket;
-                lcb_cntl(instance, LCB_CNTL_GET, LCB_CNTL_BUCKETNAME, &bucket);
-                zend_update_property_string(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("bucket_name"),
-                                            bucket TSRMLS_CC);
-
-                zend_update_property(pcbc_counter_result_impl_ce, return_value, ZEND_STRL("mutation_token"),
-                                     &val TSRMLS_CC);
+                pcbc_mutation_token_init(&result->mutation_token, instance, &token TSRMLS_CC);
             }
         }
     }
@@ -226,12 +201,9 @@ PHP_METHOD(BinaryCollection, increment)
         }
         prop = zend_read_property(pcbc_increment_options_ce, options, ZEND_STRL("cas"), 0, &ret);
         if (Z_TYPE_P(prop) == IS_STRING) {
-            zend_string *decoded = php_base64_decode_str(Z_STR_P(prop));
-            if (decoded) {
-                uint64_t cas = 0;
-                memcpy(&cas, ZSTR_VAL(decoded), ZSTR_LEN(decoded));
+            uint64_t cas;
+            if (pcbc_cas_decode(Z_STR_P(prop), &cas)) {
                 lcb_cmdcounter_cas(cmd, cas);
-                zend_string_free(decoded);
             }
         }
     }
@@ -408,12 +380,9 @@ PHP_METHOD(BinaryCollection, decrement)
         }
         prop = zend_read_property(pcbc_decrement_options_ce, options, ZEND_STRL("cas"), 0, &ret);
         if (Z_TYPE_P(prop) == IS_STRING) {
-            zend_string *decoded = php_base64_decode_str(Z_STR_P(prop));
-            if (decoded) {
-                uint64_t cas = 0;
-                memcpy(&cas, ZSTR_VAL(decoded), ZSTR_LEN(decoded));
+            uint64_t cas;
+            if (pcbc_cas_decode(Z_STR_P(prop), &cas)) {
                 lcb_cmdcounter_cas(cmd, cas);
-                zend_string_free(decoded);
             }
         }
     }
@@ -32,22 +32,16 @@ void exists_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPEXISTS *r
     const lcb_KEY_VALUE_ERROR_CONTEXT *ectx = NULL;
     struct exists_cookie *cookie = NULL;
     lcb_respexists_cookie(resp, (void **)&cookie);
-    zval *return_value = cookie->return_value;
+    pcbc_kv_result_t *result = Z_KV_RESULT_OBJ_P(cookie->return_value);
     cookie->rc = lcb_respexists_status(resp);
-    zend_update_property_long(pcbc_exists_result_impl_ce, return_value, ZEND_STRL("status"), cookie->rc TSRMLS_CC);
+    result->status = cookie->rc;
     lcb_respexists_error_context(resp, &ectx);
 
-    set_property_str(ectx, lcb_errctx_kv_context, pcbc_exists_result_impl_ce, "err_ctx");
-    set_property_str(ectx, lcb_errctx_kv_ref, pcbc_exists_result_impl_ce, "err_ref");
-    set_property_str(ectx, lcb_errctx_kv_key, pcbc_exists_result_impl_ce, "key");
-    zend_update_property_bool(pcbc_exists_result_impl_ce, return_value, ZEND_STRL("is_found"),
-                              lcb_respexists_is_found(resp) TSRMLS_CC);
+    set_result_str(ectx, lcb_errctx_kv_context, result->err_ctx);
+    set_result_str(ectx, lcb_errctx_kv_ref, result->err_ref);
+    result->is_found = lcb_respexists_is_found(resp) ? 1 : 0;
     if (cookie->rc == LCB_SUCCESS) {
-        uint64_t data;
-        lcb_respexists_cas(resp, &data);
-        zend_string *b64;
-        b64 = php_base64_encode((unsigned char *)&data, sizeof(data));
-        zend_update_property_str(pcbc_exists_result_impl_ce, return_value, ZEND_STRL("cas"), b64 TSRMLS_CC);
+        lcb_respexists_cas(resp, &result->cas);
     }
 }
 
@@ -125,6 +119,100 @@ PHP_METHOD(Collection, exists)
     }
 }
 
+PHP_METHOD(Collection, existsMulti)
+{
+    zval *ids = NULL, *options = NULL, *entry;
+    lcb_STATUS err;
+
+    int rv = zend_parse_parameters_throw(ZEND_NUM_ARGS() TSRMLS_CC, "a|O", &ids, &options, pcbc_exists_options_ce);
+    if (rv == FAILURE) {
+        RETURN_NULL();
+    }
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(ids), entry)
+    {
+        if (Z_TYPE_P(entry) != IS_STRING) {
+            zend_type_error("Document IDs must be strings");
+            RETURN_NULL();
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+    PCBC_RESOLVE_COLLECTION;
+
+    zend_long timeout = 0;
+    if (options) {
+        zval *prop, ret;
+        prop = zend_read_property(pcbc_exists_options_ce, options, ZEND_STRL("timeout"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_LONG) {
+            timeout = Z_LVAL_P(prop);
+        }
+    }
+
+    uint32_t num_ids = zend_hash_num_elements(Z_ARRVAL_P(ids));
+    array_init_size(return_value, num_ids);
+    if (num_ids == 0) {
+        return;
+    }
+
+    lcbtrace_SPAN *span = NULL;
+    lcbtrace_TRACER *tracer = lcb_get_tracer(bucket->conn->lcb);
+    if (tracer) {
+        span = lcbtrace_span_start(tracer, "php/" LCBTRACE_OP_EXISTS, 0, NULL);
+        lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_COMPONENT, pcbc_client_string);
+        lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_SERVICE, LCBTRACE_TAG_SERVICE_KV);
+    }
+
+    zval *results = ecalloc(num_ids, sizeof(zval));
+    struct exists_cookie *cookies = ecalloc(num_ids, sizeof(struct exists_cookie));
+    uint32_t idx = 0, num_scheduled = 0;
+
+    lcb_sched_enter(bucket->conn->lcb);
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(ids), entry)
+    {
+        lcb_CMDEXISTS *cmd;
+        lcb_cmdexists_create(&cmd);
+        lcb_cmdexists_collection(cmd, scope_str, scope_len, collection_str, collection_len);
+        lcb_cmdexists_key(cmd, Z_STRVAL_P(entry), Z_STRLEN_P(entry));
+        if (timeout) {
+            lcb_cmdexists_timeout(cmd, timeout);
+        }
+        if (span) {
+            lcb_cmdexists_parent_span(cmd, span);
+        }
+
+        object_init_ex(&results[idx], pcbc_exists_result_impl_ce);
+        cookies[idx].rc = LCB_SUCCESS;
+        cookies[idx].return_value = &results[idx];
+        err = lcb_exists(bucket->conn->lcb, &cookies[idx], cmd);
+        lcb_cmdexists_destroy(cmd);
+        if (err == LCB_SUCCESS) {
+            num_scheduled++;
+        } else {
+            cookies[idx].rc = err;
+            Z_KV_RESULT_OBJ_P(&results[idx])->status = err;
+        }
+        idx++;
+    }
+    ZEND_HASH_FOREACH_END();
+    lcb_sched_leave(bucket->conn->lcb);
+
+    if (num_scheduled > 0) {
+        lcb_wait(bucket->conn->lcb, LCB_WAIT_DEFAULT);
+    }
+    if (span) {
+        lcbtrace_span_finish(span, LCBTRACE_NOW);
+    }
+
+    idx = 0;
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(ids), entry)
+    {
+        pcbc_multi_result_add(return_value, Z_STR_P(entry), &results[idx], cookies[idx].rc TSRMLS_CC);
+        idx++;
+    }
+    ZEND_HASH_FOREACH_END();
+    efree(cookies);
+    efree(results);
+}
+
 PHP_MINIT_FUNCTION(CollectionExists)
 {
     zend_class_entry ce;
@@ -23,6 +23,7 @@ extern zend_class_entry *pcbc_get_result_impl_ce;
 struct get_cookie {
     lcb_STATUS rc;
     zval *return_value;
+    uint64_t started_at; /* zero when the latency is recorded by the caller */
 };
 
 void get_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPGET *resp)
@@ -32,26 +33,24 @@ void get_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPGET *resp)
     struct get_cookie *cookie = NULL;
     const lcb_KEY_VALUE_ERROR_CONTEXT *ectx = NULL;
     lcb_respget_cookie(resp, (void **)&cookie);
-    zval *return_value = cookie->return_value;
+    pcbc_kv_result_t *result = Z_KV_RESULT_OBJ_P(cookie->return_value);
     cookie->rc = lcb_respget_status(resp);
-    zend_update_property_long(pcbc_get_result_impl_ce, return_value, ZEND_STRL("status"), cookie->rc TSRMLS_CC);
+    result->status = cookie->rc;
     lcb_respget_error_context(resp, &ectx);
 
-    set_property_str(ectx, lcb_errctx_kv_context, pcbc_get_result_impl_ce, "err_ctx");
-    set_property_str(ectx, lcb_errctx_kv_ref, pcbc_get_result_impl_ce, "err_ref");
-    set_property_str(ectx, lcb_errctx_kv_key, pcbc_get_result_impl_ce, "key");
+    set_result_str(ectx, lcb_errctx_kv_context, result->err_ctx);
+    set_result_str(ectx, lcb_errctx_kv_ref, result->err_ref);
     if (cookie->rc == LCB_SUCCESS) {
-        set_property_num(uint32_t, lcb_respget_flags, pcbc_get_result_impl_ce, "flags");
-        set_property_num(uint8_t, lcb_respget_datatype, pcbc_get_result_impl_ce, "datatype");
-        set_property_str(resp, lcb_respget_value, pcbc_get_result_impl_ce, "data");
-        {
-            uint64_t data;
-            lcb_respget_cas(resp, &data);
-            zend_string *b64;
-            b64 = php_base64_encode((unsigned char *)&data, sizeof(data));
-            zend_update_property_str(pcbc_get_result_impl_ce, return_value, ZEND_STRL("cas"), b64 TSRMLS_CC);
-        }
+        lcb_respget_flags(resp, &result->flags);
+        lcb_respget_datatype(resp, &result->datatype);
+        set_result_str(resp, lcb_respget_value, result->data);
+        lcb_respget_cas(resp, &result->cas);
+    }
+    if (cookie->started_at) {
+        pcbc_metrics_record(PCBC_METRICS_GET, cookie->started_at, cookie->rc TSRMLS_CC);
+        cookie->started_at = 0;
     }
+    pcbc_future_notify(instance TSRMLS_CC);
 }
 
 zend_class_entry *pcbc_get_options_ce;
@@ -145,6 +144,7 @@ PHP_METHOD(Collection, get)
 
     object_init_ex(return_value, pcbc_get_result_impl_ce);
     struct get_cookie cookie = {LCB_SUCCESS, return_value};
+    uint64_t started_at = lcbtrace_now();
     err = lcb_get(bucket->conn->lcb, &cookie, cmd);
     lcb_cmdget_destroy(cmd);
 
@@ -155,11 +155,153 @@ PHP_METHOD(Collection, get)
     if (span) {
         lcbtrace_span_finish(span, LCBTRACE_NOW);
     }
+    pcbc_metrics_record(PCBC_METRICS_GET, started_at, err TSRMLS_CC);
     if (err != LCB_SUCCESS) {
         throw_lcb_exception(err, pcbc_get_result_impl_ce);
     }
 }
 
+PHP_METHOD(Collection, getAsync)
+{
+    zend_string *id;
+    zval *options = NULL;
+    lcb_STATUS err;
+
+    int rv = zend_parse_parameters_throw(ZEND_NUM_ARGS(), "S|O", &id, &options, pcbc_get_options_ce);
+    if (rv == FAILURE) {
+        RETURN_NULL();
+    }
+    PCBC_RESOLVE_COLLECTION;
+
+    lcb_CMDGET *cmd;
+    lcb_cmdget_create(&cmd);
+    lcb_cmdget_collection(cmd, scope_str, scope_len, collection_str, collection_len);
+    lcb_cmdget_key(cmd, ZSTR_VAL(id), ZSTR_LEN(id));
+    if (options) {
+        zval *prop, ret;
+        prop = zend_read_property(pcbc_get_options_ce, options, ZEND_STRL("timeout"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_LONG) {
+            lcb_cmdget_timeout(cmd, Z_LVAL_P(prop));
+        }
+    }
+
+    lcbtrace_SPAN *span = NULL;
+    lcbtrace_TRACER *tracer = lcb_get_tracer(bucket->conn->lcb);
+    if (tracer) {
+        span = lcbtrace_span_start(tracer, "php/" LCBTRACE_OP_GET, 0, NULL);
+        lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_COMPONENT, pcbc_client_string);
+        lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_SERVICE, LCBTRACE_TAG_SERVICE_KV);
+        lcb_cmdget_parent_span(cmd, span);
+    }
+
+    pcbc_future_t *future = pcbc_future_init(return_value, bucket->conn, pcbc_get_result_impl_ce, span TSRMLS_CC);
+    future->metrics_op = PCBC_METRICS_GET;
+    future->started_at = lcbtrace_now();
+    err = lcb_get(bucket->conn->lcb, future, cmd);
+    lcb_cmdget_destroy(cmd);
+    if (err != LCB_SUCCESS) {
+        pcbc_future_fail(future, err TSRMLS_CC);
+    }
+}
+
+PHP_METHOD(Collection, getMulti)
+{
+    zval *ids = NULL, *options = NULL, *entry;
+    lcb_STATUS err;
+
+    int rv = zend_parse_parameters_throw(ZEND_NUM_ARGS(), "a|O", &ids, &options, pcbc_get_options_ce);
+    if (rv == FAILURE) {
+        RETURN_NULL();
+    }
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(ids), entry)
+    {
+        if (Z_TYPE_P(entry) != IS_STRING) {
+            zend_type_error("Document IDs must be strings");
+            RETURN_NULL();
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+    PCBC_RESOLVE_COLLECTION;
+
+    zend_long timeout = 0;
+    if (options) {
+        zval *prop, ret;
+        prop = zend_read_property(pcbc_get_options_ce, options, ZEND_STRL("timeout"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_LONG) {
+            timeout = Z_LVAL_P(prop);
+        }
+    }
+
+    uint32_t num_ids = zend_hash_num_elements(Z_ARRVAL_P(ids));
+    array_init_size(return_value, num_ids);
+    if (num_ids == 0) {
+        return;
+    }
+
+    lcbtrace_SPAN *span = NULL;
+    lcbtrace_TRACER *tracer = lcb_get_tracer(bucket->conn->lcb);
+    if (tracer) {
+        span = lcbtrace_span_start(tracer, "php/" LCBTRACE_OP_GET, 0, NULL);
+        lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_COMPONENT, pcbc_client_string);
+        lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_SERVICE, LCBTRACE_TAG_SERVICE_KV);
+    }
+
+    zval *results = ecalloc(num_ids, sizeof(zval));
+    struct get_cookie *cookies = ecalloc(num_ids, sizeof(struct get_cookie));
+    uint32_t idx = 0, num_scheduled = 0;
+
+    lcb_sched_enter(bucket->conn->lcb);
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(ids), entry)
+    {
+        lcb_CMDGET *cmd;
+        lcb_cmdget_create(&cmd);
+        lcb_cmdget_collection(cmd, scope_str, scope_len, collection_str, collection_len);
+        lcb_cmdget_key(cmd, Z_STRVAL_P(entry), Z_STRLEN_P(entry));
+        if (timeout) {
+            lcb_cmdget_timeout(cmd, timeout);
+        }
+        if (span) {
+            lcb_cmdget_parent_span(cmd, span);
+        }
+
+        object_init_ex(&results[idx], pcbc_get_result_impl_ce);
+        cookies[idx].rc = LCB_SUCCESS;
+        cookies[idx].return_value = &results[idx];
+        cookies[idx].started_at = lcbtrace_now();
+        err = lcb_get(bucket->conn->lcb, &cookies[idx], cmd);
+        lcb_cmdget_destroy(cmd);
+        if (err == LCB_SUCCESS) {
+            num_scheduled++;
+        } else {
+            cookies[idx].rc = err;
+            Z_KV_RESULT_OBJ_P(&results[idx])->status = err;
+            pcbc_metrics_record(PCBC_METRICS_GET, cookies[idx].started_at, err TSRMLS_CC);
+            pcbc_log(LOGARGS(bucket->conn->lcb, WARN), "Failed to schedule GET command for \"%.*s\": %s",
+                     (int)Z_STRLEN_P(entry), Z_STRVAL_P(entry), lcb_strerror_short(err));
+        }
+        idx++;
+    }
+    ZEND_HASH_FOREACH_END();
+    lcb_sched_leave(bucket->conn->lcb);
+
+    if (num_scheduled > 0) {
+        lcb_wait(bucket->conn->lcb, LCB_WAIT_DEFAULT);
+    }
+    if (span) {
+        lcbtrace_span_finish(span, LCBTRACE_NOW);
+    }
+
+    idx = 0;
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(ids), entry)
+    {
+        pcbc_multi_result_add(return_value, Z_STR_P(entry), &results[idx], cookies[idx].rc TSRMLS_CC);
+        idx++;
+    }
+    ZEND_HASH_FOREACH_END();
+    efree(cookies);
+    efree(results);
+}
+
 zend_class_entry *pcbc_get_and_lock_options_ce;
 
 PHP_METHOD(GetAndLockOptions, timeout)
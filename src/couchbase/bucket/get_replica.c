@@ -33,35 +33,29 @@ void getreplica_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPGETRE
     const lcb_KEY_VALUE_ERROR_CONTEXT *ectx = NULL;
     struct get_replica_cookie *cookie = NULL;
     lcb_respgetreplica_cookie(resp, (void **)&cookie);
-    zval *return_value = NULL, value;
+    pcbc_kv_result_t *result = NULL;
     if (cookie->is_single) {
-        return_value = cookie->return_value;
+        result = Z_KV_RESULT_OBJ_P(cookie->return_value);
     } else {
-        return_value = &value;
-        object_init_ex(return_value, pcbc_get_replica_result_impl_ce);
-        add_next_index_zval(cookie->return_value, return_value);
+        zval value;
+        object_init_ex(&value, pcbc_get_replica_result_impl_ce);
+        add_next_index_zval(cookie->return_value, &value);
+        result = Z_KV_RESULT_OBJ_P(&value);
     }
 
     cookie->rc = lcb_respgetreplica_status(resp);
-    zend_update_property_long(pcbc_get_replica_result_impl_ce, return_value, ZEND_STRL("status"), cookie->rc TSRMLS_CC);
+    result->status = cookie->rc;
     lcb_respgetreplica_error_context(resp, &ectx);
 
-    set_property_str(ectx, lcb_errctx_kv_context, pcbc_get_replica_result_impl_ce, "err_ctx");
-    set_property_str(ectx, lcb_errctx_kv_ref, pcbc_get_replica_result_impl_ce, "err_ref");
-    set_property_str(ectx, lcb_errctx_kv_key, pcbc_get_replica_result_impl_ce, "key");
+    set_result_str(ectx, lcb_errctx_kv_context, result->err_ctx);
+    set_result_str(ectx, lcb_errctx_kv_ref, result->err_ref);
     /* TODO: shall libcouchbase query master for replica? */
-    zend_update_property_bool(pcbc_get_replica_result_impl_ce, return_value, ZEND_STRL("is_replica"), 1 TSRMLS_CC);
+    result->is_replica = 1;
     if (cookie->rc == LCB_SUCCESS) {
-        set_property_num(uint32_t, lcb_respgetreplica_flags, pcbc_get_replica_result_impl_ce, "flags");
-        set_property_num(uint8_t, lcb_respgetreplica_datatype, pcbc_get_replica_result_impl_ce, "datatype");
-        set_property_str(resp, lcb_respgetreplica_value, pcbc_get_replica_result_impl_ce, "data");
-        {
-            uint64_t data;
-            lcb_respgetreplica_cas(resp, &data);
-            zend_string *b64;
-            b64 = php_base64_encode((unsigned char *)&data, sizeof(data));
-            zend_update_property_str(pcbc_get_replica_result_impl_ce, return_value, ZEND_STRL("cas"), b64 TSRMLS_CC);
-        }
+        lcb_respgetreplica_flags(resp, &result->flags);
+        lcb_respgetreplica_datatype(resp, &result->datatype);
+        set_result_str(resp, lcb_respgetreplica_value, result->data);
+        lcb_respgetreplica_cas(resp, &result->cas);
     }
 }
 
@@ -95,12 +95,14 @@ void pcbc_http_request(zval *return_value, lcb_INSTANCE *conn, lcb_CMDHTTP *cmd,
 
     cookie = opcookie_init();
     cookie->json_response = json_response;
+    uint64_t started_at = lcbtrace_now();
     err = lcb_http(conn, cookie, cmd);
     lcb_cmdhttp_destroy(cmd);
     if (err == LCB_SUCCESS) {
         lcb_wait(conn, LCB_WAIT_DEFAULT);
         err = proc_http_results(return_value, cookie TSRMLS_CC);
     }
+    pcbc_metrics_record(PCBC_METRICS_HTTP, started_at, err TSRMLS_CC);
     opcookie_destroy(cookie);
     if (err != LCB_SUCCESS) {
         throw_lcb_exception(err, NULL);
@@ -30,16 +30,11 @@ extern zend_class_entry *pcbc_query_result_impl_ce;
 extern zend_class_entry *pcbc_query_meta_data_impl_ce;
 zend_class_entry *pcbc_query_options_ce;
 
-struct query_cookie {
-    lcb_STATUS rc;
-    zval *return_value;
-};
-
 static void n1qlrow_callback(lcb_INSTANCE *instance, int ignoreme, const lcb_RESPQUERY *resp)
 {
     TSRMLS_FETCH();
 
-    struct query_cookie *cookie;
+    pcbc_row_cookie_t *cookie;
     lcb_respquery_cookie(resp, (void **)&cookie);
     cookie->rc = lcb_respquery_status(resp);
     zval *return_value = cookie->return_value;
@@ -99,12 +94,51 @@ static void n1qlrow_callback(lcb_INSTANCE *instance, int ignoreme, const lcb_RES
             }
 
             zend_update_property(pcbc_query_result_impl_ce, return_value, ZEND_STRL("meta"), &meta TSRMLS_CC);
+        } else if (cookie->stream) {
+            pcbc_row_stream_push(cookie->stream, &value);
         } else {
             zval *rows, rv;
             rows = zend_read_property(pcbc_query_result_impl_ce, return_value, ZEND_STRL("rows"), 0, &rv);
             add_next_index_zval(rows, &value);
         }
     }
+    if (cookie->stream && lcb_respquery_is_final(resp)) {
+        pcbc_row_stream_finish(cookie->stream);
+    }
+    if (cookie->future && lcb_respquery_is_final(resp)) {
+        pcbc_future_complete(cookie->future, cookie->rc TSRMLS_CC);
+    }
+}
+
+static void pcbc_query_cancel(lcb_INSTANCE *instance, void *handle)
+{
+    lcb_query_cancel(instance, (lcb_QUERY_HANDLE *)handle);
+}
+
+static void pcbc_query_throw_error(zval *result, lcb_STATUS err TSRMLS_DC)
+{
+    int code = 0;
+    char msg[200] = {0};
+    zval *meta = NULL, mret;
+    meta = zend_read_property(pcbc_query_result_impl_ce, result, ZEND_STRL("meta"), 0, &mret);
+    if (meta && Z_TYPE_P(meta) == IS_OBJECT) {
+        zval *prop, ret;
+        prop = zend_read_property(pcbc_query_meta_data_impl_ce, meta, ZEND_STRL("errors"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_ARRAY) {
+            HashTable *ht = Z_ARRVAL_P(prop);
+            zval *entry = zend_hash_index_find(ht, 0);
+            zval *val;
+            val = zend_symtable_str_find(Z_ARRVAL_P(entry), ZEND_STRL("code"));
+            if (val && Z_TYPE_P(val) == IS_LONG) {
+                code = Z_LVAL_P(val);
+            }
+            val = zend_symtable_str_find(Z_ARRVAL_P(entry), ZEND_STRL("msg"));
+            if (val && Z_TYPE_P(val) == IS_STRING) {
+                strncpy(msg, Z_STRVAL_P(val), Z_STRLEN_P(val));
+            }
+        }
+    }
+    throw_http_exception(code ? LCB_ERR_QUERY : err, code, msg);
 }
 
 zend_class_entry *pcbc_query_consistency_ce;
@@ -145,18 +179,8 @@ PHP_METHOD(QueryOptions, consistentWith)
     }
     zend_update_property_null(pcbc_query_options_ce, getThis(), ZEND_STRL("scan_consistency") TSRMLS_CC);
 
-    zval scan_vectors;
-    ZVAL_UNDEF(&scan_vectors);
-    pcbc_mutation_state_export_for_n1ql(arg, &scan_vectors TSRMLS_CC);
     smart_str buf = {0};
-    int last_error;
-    PCBC_JSON_ENCODE(&buf, &scan_vectors, 0, last_error);
-    if (last_error != 0) {
-        pcbc_log(LOGARGS(NULL, WARN), "Failed to encode value of raw parameter as JSON: json_last_error=%d",
-                 last_error);
-        smart_str_free(&buf);
-        RETURN_NULL();
-    }
+    pcbc_mutation_state_export_for_n1ql(arg, &buf TSRMLS_CC);
     smart_str_0(&buf);
     zend_update_property_str(pcbc_query_options_ce, getThis(), ZEND_STRL("consistent_with"), buf.s TSRMLS_CC);
     smart_str_free(&buf);
@@ -338,6 +362,21 @@ PHP_METHOD(QueryOptions, positionalParameters)
     RETURN_ZVAL(getThis(), 1, 0);
 }
 
+PHP_METHOD(QueryOptions, streaming)
+{
+    zend_bool arg;
+    zend_long window = 0;
+    int rv = zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "b|l", &arg, &window);
+    if (rv == FAILURE) {
+        RETURN_NULL();
+    }
+    zend_update_property_bool(pcbc_query_options_ce, getThis(), ZEND_STRL("streaming"), arg TSRMLS_CC);
+    if (window > 0) {
+        zend_update_property_long(pcbc_query_options_ce, getThis(), ZEND_STRL("stream_window"), window TSRMLS_CC);
+    }
+    RETURN_ZVAL(getThis(), 1, 0);
+}
+
 PHP_METHOD(QueryOptions, raw)
 {
     zend_string *key;
@@ -425,6 +464,11 @@ ZEND_ARG_TYPE_INFO(0, key, IS_STRING, 0)
 ZEND_ARG_TYPE_INFO(0, value, 0, 1)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_QueryOptions_streaming, 0, 1, \\Couchbase\\QueryOptions, 0)
+ZEND_ARG_TYPE_INFO(0, enabled, _IS_BOOL, 0)
+ZEND_ARG_TYPE_INFO(0, rowWindow, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_QueryOptions_clientContextId, 0, 2, \\Couchbase\\QueryOptions, 0)
 ZEND_ARG_TYPE_INFO(0, value, IS_STRING, 0)
 ZEND_END_ARG_INFO()
@@ -446,15 +490,18 @@ static const zend_function_entry pcbc_query_options_methods[] = {
     PHP_ME(QueryOptions, maxParallelism, ai_QueryOptions_maxParallelism, ZEND_ACC_PUBLIC)
     PHP_ME(QueryOptions, profile, ai_QueryOptions_profile, ZEND_ACC_PUBLIC)
     PHP_ME(QueryOptions, clientContextId, ai_QueryOptions_clientContextId, ZEND_ACC_PUBLIC)
+    PHP_ME(QueryOptions, streaming, ai_QueryOptions_streaming, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
 // clang-format on
 
-PHP_METHOD(Cluster, query)
+static void pcbc_cluster_query(INTERNAL_FUNCTION_PARAMETERS, zend_bool async)
 {
     lcb_STATUS err;
     zend_string *statement;
     zval *options = NULL;
+    zend_bool streaming = 0;
+    zend_long stream_window = 0;
 
     int rv = zend_parse_parameters_throw(ZEND_NUM_ARGS() TSRMLS_CC, "S|O", &statement, &options, pcbc_query_options_ce);
     if (rv == FAILURE) {
@@ -576,19 +623,71 @@ PHP_METHOD(Cluster, query)
             }
             ZEND_HASH_FOREACH_END();
         }
+        prop = zend_read_property(pcbc_query_options_ce, options, ZEND_STRL("streaming"), 0, &ret);
+        streaming = Z_TYPE_P(prop) == IS_TRUE;
+        prop = zend_read_property(pcbc_query_options_ce, options, ZEND_STRL("stream_window"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_LONG) {
+            stream_window = Z_LVAL_P(prop);
+        }
     }
 
     lcb_QUERY_HANDLE *handle = NULL;
     lcb_cmdquery_handle(cmd, &handle);
 
+    /* the streamed rows are fetched on the instance, which is not driven by the other objects */
+    pcbc_connection_t *conn = cluster->conn;
+    if (streaming && !async) {
+        err = pcbc_connection_get_exclusive(&conn, LCB_TYPE_CLUSTER, cluster->connstr, NULL, cluster->username,
+                                            cluster->password TSRMLS_CC);
+        if (err != LCB_SUCCESS) {
+            lcb_cmdquery_destroy(cmd);
+            throw_lcb_exception(err, NULL);
+            return;
+        }
+    }
     lcbtrace_SPAN *span = NULL;
-    lcbtrace_TRACER *tracer = lcb_get_tracer(cluster->conn->lcb);
+    lcbtrace_TRACER *tracer = lcb_get_tracer(conn->lcb);
     if (tracer) {
         span = lcbtrace_span_start(tracer, "php/n1ql", 0, NULL);
         lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_COMPONENT, pcbc_client_string);
         lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_SERVICE, LCBTRACE_TAG_SERVICE_N1QL);
         lcb_cmdquery_parent_span(cmd, span);
     }
+    if (async) {
+        /* the rows are collected into the result of the future, the streaming options are not applicable */
+        pcbc_future_t *future =
+            pcbc_future_init(return_value, cluster->conn, pcbc_query_result_impl_ce, span TSRMLS_CC);
+        pcbc_future_init_rows(future, pcbc_query_throw_error TSRMLS_CC);
+        future->metrics_op = PCBC_METRICS_QUERY;
+        future->started_at = lcbtrace_now();
+        err = lcb_query(cluster->conn->lcb, &future->row, cmd);
+        lcb_cmdquery_destroy(cmd);
+        if (err != LCB_SUCCESS) {
+            pcbc_future_fail(future, err TSRMLS_CC);
+        }
+        return;
+    }
+    if (streaming) {
+        pcbc_row_stream_t *stream =
+            pcbc_row_stream_init(return_value, conn, pcbc_query_result_impl_ce, stream_window TSRMLS_CC);
+        pcbc_connection_delref(conn TSRMLS_CC); /* the stream holds its own reference */
+        stream->cancel = pcbc_query_cancel;
+        stream->error = pcbc_query_throw_error;
+        stream->span = span;
+        stream->metrics_op = PCBC_METRICS_QUERY;
+        stream->started_at = lcbtrace_now();
+        err = lcb_query(conn->lcb, &stream->cookie, cmd);
+        lcb_cmdquery_destroy(cmd);
+        if (err != LCB_SUCCESS) {
+            pcbc_row_stream_finish(stream);
+            throw_http_exception(err, 0, NULL);
+            return;
+        }
+        /* the rows will be fetched by the stream, when the application iterates over them */
+        stream->handle = handle;
+        return;
+    }
+
     rv = object_init_ex(return_value, pcbc_query_result_impl_ce);
     if (rv != SUCCESS) {
         return;
@@ -597,7 +696,8 @@ PHP_METHOD(Cluster, query)
     array_init(&rows);
     zend_update_property(pcbc_query_result_impl_ce, return_value, ZEND_STRL("rows"), &rows TSRMLS_CC);
     Z_DELREF(rows);
-    struct query_cookie cookie = {LCB_SUCCESS, return_value};
+    pcbc_row_cookie_t cookie = {LCB_SUCCESS, return_value, NULL};
+    uint64_t started_at = lcbtrace_now();
     err = lcb_query(cluster->conn->lcb, &cookie, cmd);
     lcb_cmdquery_destroy(cmd);
     if (err == LCB_SUCCESS) {
@@ -607,32 +707,22 @@ PHP_METHOD(Cluster, query)
     if (span) {
         lcbtrace_span_finish(span, LCBTRACE_NOW);
     }
+    pcbc_metrics_record(PCBC_METRICS_QUERY, started_at, err TSRMLS_CC);
     if (err != LCB_SUCCESS) {
-        int code = 0;
-        char msg[200] = {0};
-        zval *meta = NULL, mret;
-        meta = zend_read_property(pcbc_query_result_impl_ce, return_value, ZEND_STRL("meta"), 0, &mret);
-        if (meta) {
-            zval *prop, ret;
-            prop = zend_read_property(pcbc_query_meta_data_impl_ce, meta, ZEND_STRL("errors"), 0, &ret);
-            if (Z_TYPE_P(prop) == IS_ARRAY) {
-                HashTable *ht = Z_ARRVAL_P(prop);
-                zval *entry = zend_hash_index_find(ht, 0);
-                zval *val;
-                val = zend_symtable_str_find(Z_ARRVAL_P(entry), ZEND_STRL("code"));
-                if (val && Z_TYPE_P(val) == IS_LONG) {
-                    code = Z_LVAL_P(val);
-                }
-                val = zend_symtable_str_find(Z_ARRVAL_P(entry), ZEND_STRL("msg"));
-                if (val && Z_TYPE_P(val) == IS_STRING) {
-                    strncpy(msg, Z_STRVAL_P(val), Z_STRLEN_P(val));
-                }
-            }
-        }
-        throw_http_exception(code ? LCB_ERR_QUERY : err, code, msg);
+        pcbc_query_throw_error(return_value, err TSRMLS_CC);
     }
 }
 
+PHP_METHOD(Cluster, query)
+{
+    pcbc_cluster_query(INTERNAL_FUNCTION_PARAM_PASSTHRU, 0);
+}
+
+PHP_METHOD(Cluster, queryAsync)
+{
+    pcbc_cluster_query(INTERNAL_FUNCTION_PARAM_PASSTHRU, 1);
+}
+
 PHP_MINIT_FUNCTION(N1qlQuery)
 {
     zend_class_entry ce;
@@ -655,6 +745,8 @@ PHP_MINIT_FUNCTION(N1qlQuery)
     zend_declare_property_null(pcbc_query_options_ce, ZEND_STRL("max_parallelism"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_query_options_ce, ZEND_STRL("profile"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_query_options_ce, ZEND_STRL("client_context_id"), ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_null(pcbc_query_options_ce, ZEND_STRL("streaming"), ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_null(pcbc_query_options_ce, ZEND_STRL("stream_window"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "QueryScanConsistency", pcbc_query_consistency_methods);
     pcbc_query_consistency_ce = zend_register_internal_interface(&ce TSRMLS_CC);
@@ -19,7 +19,6 @@
 #define LOGARGS(instance, lvl) LCB_LOG_##lvl, instance, "pcbc/remove", __FILE__, __LINE__
 
 extern zend_class_entry *pcbc_mutation_result_impl_ce;
-extern zend_class_entry *pcbc_mutation_token_impl_ce;
 
 struct remove_cookie {
     lcb_STATUS rc;
@@ -33,45 +32,21 @@ void remove_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPREMOVE *r
     const lcb_KEY_VALUE_ERROR_CONTEXT *ectx = NULL;
     struct remove_cookie *cookie = NULL;
     lcb_respremove_cookie(resp, (void **)&cookie);
-    zval *return_value = cookie->return_value;
+    pcbc_kv_result_t *result = Z_KV_RESULT_OBJ_P(cookie->return_value);
     cookie->rc = lcb_respremove_status(resp);
-    zend_update_property_long(pcbc_mutation_result_impl_ce, return_value, ZEND_STRL("status"), cookie->rc TSRMLS_CC);
+    result->status = cookie->rc;
 
     lcb_respremove_error_context(resp, &ectx);
-    set_property_str(ectx, lcb_errctx_kv_context, pcbc_mutation_result_impl_ce, "err_ctx");
-    set_property_str(ectx, lcb_errctx_kv_ref, pcbc_mutation_result_impl_ce, "err_ref");
-    set_property_str(ectx, lcb_errctx_kv_key, pcbc_mutation_result_impl_ce, "key");
+    set_result_str(ectx, lcb_errctx_kv_context, result->err_ctx);
+    set_result_str(ectx, lcb_errctx_kv_ref, result->err_ref);
 
     if (cookie->rc == LCB_SUCCESS) {
-        zend_string *b64;
-        {
-            uint64_t data;
-            lcb_respremove_cas(resp, &data);
-            b64 = php_base64_encode((unsigned char *)&data, sizeof(data));
-            zend_update_property_str(pcbc_mutation_result_impl_ce, return_value, ZEND_STRL("cas"), b64 TSRMLS_CC);
-        }
+        lcb_respremove_cas(resp, &result->cas);
         {
             lcb_MUTATION_TOKEN token = {0};
             lcb_respremove_mutation_token(resp, &token);
             if (lcb_mutation_token_is_valid(&token)) {
-                zval val;
-                object_init_ex(&val, pcbc_mutation_token_impl_ce);
-
-                zend_update_property_long(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("partition_id"),
-                                          token.vbid_ TSRMLS_CC);
-                b64 = php_base64_encode((unsigned char *)&token.uuid_, sizeof(token.uuid_));
-                zend_update_property_str(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("partition_uuid"), b64 TSRMLS_CC);
-                b64 = php_base64_encode((unsigned char *)&token.seqno_, sizeof(token.seqno_));
-                zend_update_property_str(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("sequence_number"),
-                                         b64 TSRMLS_CC);
-
-                const char *bucket;
-                lcb_cntl(instance, LCB_CNTL_GET, LCB_CNTL_BUCKETNAME, &bucket);
-                zend_update_property_string(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("bucket_name"),
-                                            bucket TSRMLS_CC);
-
-                zend_update_property(pcbc_mutation_result_impl_ce, return_value, ZEND_STRL("mutation_token"),
-                                     &val TSRMLS_CC);
+                pcbc_mutation_token_init(&result->mutation_token, instance, &token TSRMLS_CC);
             }
         }
     }
@@ -86,12 +61,9 @@ PHP_METHOD(RemoveOptions, cas)
     if (rv == FAILURE) {
         RETURN_NULL();
     }
-    zend_string *decoded = php_base64_decode_str(arg);
-    if (decoded) {
-        if (ZSTR_LEN(decoded) == sizeof(uint64_t)) {
-            zend_update_property_str(pcbc_remove_options_ce, getThis(), ZEND_STRL("cas"), arg TSRMLS_CC);
-        }
-        zend_string_free(decoded);
+    uint64_t cas;
+    if (pcbc_cas_decode(arg, &cas)) {
+        zend_update_property_str(pcbc_remove_options_ce, getThis(), ZEND_STRL("cas"), arg TSRMLS_CC);
     }
     RETURN_ZVAL(getThis(), 1, 0);
 }
@@ -167,12 +139,9 @@ PHP_METHOD(Collection, remove)
         }
         prop = zend_read_property(pcbc_remove_options_ce, options, ZEND_STRL("cas"), 0, &ret);
         if (Z_TYPE_P(prop) == IS_STRING) {
-            zend_string *decoded = php_base64_decode_str(Z_STR_P(prop));
-            if (decoded) {
-                uint64_t cas = 0;
-                memcpy(&cas, ZSTR_VAL(decoded), ZSTR_LEN(decoded));
+            uint64_t cas;
+            if (pcbc_cas_decode(Z_STR_P(prop), &cas)) {
                 lcb_cmdremove_cas(cmd, cas);
-                zend_string_free(decoded);
             }
         }
     }
@@ -202,6 +171,107 @@ PHP_METHOD(Collection, remove)
     }
 }
 
+PHP_METHOD(Collection, removeMulti)
+{
+    zval *ids = NULL, *options = NULL, *entry;
+    lcb_STATUS err;
+
+    int rv = zend_parse_parameters_throw(ZEND_NUM_ARGS() TSRMLS_CC, "a|O", &ids, &options, pcbc_remove_options_ce);
+    if (rv == FAILURE) {
+        RETURN_NULL();
+    }
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(ids), entry)
+    {
+        if (Z_TYPE_P(entry) != IS_STRING) {
+            zend_type_error("Document IDs must be strings");
+            RETURN_NULL();
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+    PCBC_RESOLVE_COLLECTION;
+
+    zend_long timeout = 0, durability_level = 0;
+    if (options) {
+        zval *prop, ret;
+        prop = zend_read_property(pcbc_remove_options_ce, options, ZEND_STRL("timeout"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_LONG) {
+            timeout = Z_LVAL_P(prop);
+        }
+        prop = zend_read_property(pcbc_remove_options_ce, options, ZEND_STRL("durability_level"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_LONG) {
+            durability_level = Z_LVAL_P(prop);
+        }
+    }
+
+    uint32_t num_ids = zend_hash_num_elements(Z_ARRVAL_P(ids));
+    array_init_size(return_value, num_ids);
+    if (num_ids == 0) {
+        return;
+    }
+
+    lcbtrace_SPAN *span = NULL;
+    lcbtrace_TRACER *tracer = lcb_get_tracer(bucket->conn->lcb);
+    if (tracer) {
+        span = lcbtrace_span_start(tracer, "php/" LCBTRACE_OP_REMOVE, 0, NULL);
+        lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_COMPONENT, pcbc_client_string);
+        lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_SERVICE, LCBTRACE_TAG_SERVICE_KV);
+    }
+
+    zval *results = ecalloc(num_ids, sizeof(zval));
+    struct remove_cookie *cookies = ecalloc(num_ids, sizeof(struct remove_cookie));
+    uint32_t idx = 0, num_scheduled = 0;
+
+    lcb_sched_enter(bucket->conn->lcb);
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(ids), entry)
+    {
+        lcb_CMDREMOVE *cmd;
+        lcb_cmdremove_create(&cmd);
+        lcb_cmdremove_collection(cmd, scope_str, scope_len, collection_str, collection_len);
+        lcb_cmdremove_key(cmd, Z_STRVAL_P(entry), Z_STRLEN_P(entry));
+        if (timeout) {
+            lcb_cmdremove_timeout(cmd, timeout);
+        }
+        if (durability_level) {
+            lcb_cmdremove_durability(cmd, durability_level);
+        }
+        if (span) {
+            lcb_cmdremove_parent_span(cmd, span);
+        }
+
+        object_init_ex(&results[idx], pcbc_mutation_result_impl_ce);
+        cookies[idx].rc = LCB_SUCCESS;
+        cookies[idx].return_value = &results[idx];
+        err = lcb_remove(bucket->conn->lcb, &cookies[idx], cmd);
+        lcb_cmdremove_destroy(cmd);
+        if (err == LCB_SUCCESS) {
+            num_scheduled++;
+        } else {
+            cookies[idx].rc = err;
+            Z_KV_RESULT_OBJ_P(&results[idx])->status = err;
+        }
+        idx++;
+    }
+    ZEND_HASH_FOREACH_END();
+    lcb_sched_leave(bucket->conn->lcb);
+
+    if (num_scheduled > 0) {
+        lcb_wait(bucket->conn->lcb, LCB_WAIT_DEFAULT);
+    }
+    if (span) {
+        lcbtrace_span_finish(span, LCBTRACE_NOW);
+    }
+
+    idx = 0;
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(ids), entry)
+    {
+        pcbc_multi_result_add(return_value, Z_STR_P(entry), &results[idx], cookies[idx].rc TSRMLS_CC);
+        idx++;
+    }
+    ZEND_HASH_FOREACH_END();
+    efree(cookies);
+    efree(results);
+}
+
 PHP_MINIT_FUNCTION(CollectionRemove)
 {
     zend_class_entry ce;
@@ -22,11 +22,11 @@ zend_class_entry *pcbc_durability_level_ce;
 static const zend_function_entry pcbc_durability_level_methods[] = {PHP_FE_END};
 
 extern zend_class_entry *pcbc_store_result_impl_ce;
-extern zend_class_entry *pcbc_mutation_token_impl_ce;
 
 struct store_cookie {
     lcb_STATUS rc;
     zval *return_value;
+    uint64_t started_at; /* zero when the latency is recorded by the caller, or not recorded for the operation */
 };
 
 void store_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPSTORE *resp)
@@ -36,58 +36,29 @@ void store_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPSTORE *res
     const lcb_KEY_VALUE_ERROR_CONTEXT *ectx = NULL;
     struct store_cookie *cookie = NULL;
     lcb_respstore_cookie(resp, (void **)&cookie);
-    zval *return_value = cookie->return_value;
+    pcbc_kv_result_t *result = Z_KV_RESULT_OBJ_P(cookie->return_value);
     cookie->rc = lcb_respstore_status(resp);
-    zend_update_property_long(pcbc_store_result_impl_ce, return_value, ZEND_STRL("status"), cookie->rc TSRMLS_CC);
+    result->status = cookie->rc;
 
     lcb_respstore_error_context(resp, &ectx);
-    set_property_str(ectx, lcb_errctx_kv_context, pcbc_store_result_impl_ce, "err_ctx");
-    set_property_str(ectx, lcb_errctx_kv_ref, pcbc_store_result_impl_ce, "err_ref");
-    set_property_str(ectx, lcb_errctx_kv_key, pcbc_store_result_impl_ce, "key");
+    set_result_str(ectx, lcb_errctx_kv_context, result->err_ctx);
+    set_result_str(ectx, lcb_errctx_kv_ref, result->err_ref);
 
     if (cookie->rc == LCB_SUCCESS) {
-        zend_string *b64;
-        {
-            uint64_t data;
-            lcb_respstore_cas(resp, &data);
-            b64 = php_base64_encode((unsigned char *)&data, sizeof(data));
-            zend_update_property_str(pcbc_store_result_impl_ce, return_value, ZEND_STRL("cas"), b64 TSRMLS_CC);
-        }
+        lcb_respstore_cas(resp, &result->cas);
         {
             lcb_MUTATION_TOKEN token = {0};
             lcb_respstore_mutation_token(resp, &token);
             if (lcb_mutation_token_is_valid(&token)) {
-                zval val;
-                object_init_ex(&val, pcbc_mutation_token_impl_ce);
-
-                zend_update_property_long(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("partition_id"),
-                                          token.vbid_ TSRMLS_CC);
-                b64 = php_base64_encode((unsigned char *)&token.uuid_, sizeof(token.uuid_));
-                zend_update_property_str(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("partition_uuid"), b64 TSRMLS_CC);
-                b64 = php_base64_encode((unsigned char *)&token.seqno_, sizeof(token.seqno_));
-                zend_update_property_str(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("sequence_number"),
-                                         b64 TSRMLS_CC);
-
-                const char *bucket;
-                lcb_cntl(instance, LCB_CNTL_GET, LCB_CNTL_BUCKETNAME, &bucket);
-                zend_update_property_string(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("bucket_name"),
-                                            bucket TSRMLS_CC);
-
-                zend_update_property(pcbc_store_result_impl_ce, return_value, ZEND_STRL("mutation_token"),
-                                     &val TSRMLS_CC);
+                pcbc_mutation_token_init(&result->mutation_token, instance, &token TSRMLS_CC);
             }
         }
     }
-    if (lcb_respstore_observe_attached(resp)) {
-        int store_ok;
-        lcb_respstore_observe_stored(resp, &store_ok);
-        zend_update_property_bool(pcbc_store_result_impl_ce, return_value, ZEND_STRL("is_stored"), store_ok TSRMLS_CC);
-        if (store_ok) {
-            set_property_num(uint16_t, lcb_respstore_observe_num_persisted, pcbc_store_result_impl_ce, "num_persisted");
-            set_property_num(uint16_t, lcb_respstore_observe_num_replicated, pcbc_store_result_impl_ce,
-                             "num_replicated");
-        }
+    if (cookie->started_at) {
+        pcbc_metrics_record(PCBC_METRICS_UPSERT, cookie->started_at, cookie->rc TSRMLS_CC);
+        cookie->started_at = 0;
     }
+    pcbc_future_notify(instance TSRMLS_CC);
 }
 
 zend_class_entry *pcbc_insert_options_ce;
@@ -194,11 +165,10 @@ PHP_METHOD(Collection, insert)
         lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_COMPONENT, pcbc_client_string);
         lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_SERVICE, LCBTRACE_TAG_SERVICE_KV);
     }
-    void *bytes = NULL;
-    size_t nbytes;
+    zend_string *bytes = NULL;
     uint32_t flags;
     uint8_t datatype;
-    rv = pcbc_encode_value(bucket, value, &bytes, &nbytes, &flags, &datatype TSRMLS_CC);
+    rv = pcbc_encode_value(bucket, value, &bytes, &flags, &datatype TSRMLS_CC);
     if (span) {
         lcbtrace_span_finish(span, LCBTRACE_NOW);
     }
@@ -210,14 +180,14 @@ PHP_METHOD(Collection, insert)
     }
 
     lcb_cmdstore_key(cmd, ZSTR_VAL(id), ZSTR_LEN(id));
-    lcb_cmdstore_value(cmd, bytes, nbytes);
+    lcb_cmdstore_value(cmd, ZSTR_VAL(bytes), ZSTR_LEN(bytes));
     lcb_cmdstore_flags(cmd, flags);
     lcb_cmdstore_datatype(cmd, datatype);
 
     object_init_ex(return_value, pcbc_store_result_impl_ce);
     struct store_cookie cookie = {LCB_SUCCESS, return_value};
     err = lcb_store(bucket->conn->lcb, &cookie, cmd);
-    efree(bytes);
+    zend_string_release(bytes);
     lcb_cmdstore_destroy(cmd);
     if (err == LCB_SUCCESS) {
         lcb_wait(bucket->conn->lcb, LCB_WAIT_DEFAULT);
@@ -240,12 +210,9 @@ PHP_METHOD(UpsertOptions, cas)
     if (rv == FAILURE) {
         RETURN_NULL();
     }
-    zend_string *decoded = php_base64_decode_str(arg);
-    if (decoded) {
-        if (ZSTR_LEN(decoded) == sizeof(uint64_t)) {
-            zend_update_property_str(pcbc_upsert_options_ce, getThis(), ZEND_STRL("cas"), arg TSRMLS_CC);
-        }
-        zend_string_free(decoded);
+    uint64_t cas;
+    if (pcbc_cas_decode(arg, &cas)) {
+        zend_update_property_str(pcbc_upsert_options_ce, getThis(), ZEND_STRL("cas"), arg TSRMLS_CC);
     }
     RETURN_ZVAL(getThis(), 1, 0);
 }
@@ -340,16 +307,14 @@ PHP_METHOD(Collection, upsert)
         }
         prop = zend_read_property(pcbc_upsert_options_ce, options, ZEND_STRL("cas"), 0, &ret);
         if (Z_TYPE_P(prop) == IS_STRING) {
-            zend_string *decoded = php_base64_decode_str(Z_STR_P(prop));
-            if (decoded) {
-                uint64_t cas = 0;
-                memcpy(&cas, ZSTR_VAL(decoded), ZSTR_LEN(decoded));
+            uint64_t cas;
+            if (pcbc_cas_decode(Z_STR_P(prop), &cas)) {
                 lcb_cmdstore_cas(cmd, cas);
-                zend_string_free(decoded);
             }
         }
     }
 
+    uint64_t started_at = lcbtrace_now();
     lcbtrace_SPAN *parent_span = NULL;
     lcbtrace_TRACER *tracer = lcb_get_tracer(bucket->conn->lcb);
     if (tracer) {
@@ -367,11 +332,10 @@ PHP_METHOD(Collection, upsert)
         lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_COMPONENT, pcbc_client_string);
         lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_SERVICE, LCBTRACE_TAG_SERVICE_KV);
     }
-    void *bytes = NULL;
-    size_t nbytes;
+    zend_string *bytes = NULL;
     uint32_t flags;
     uint8_t datatype;
-    rv = pcbc_encode_value(bucket, value, &bytes, &nbytes, &flags, &datatype TSRMLS_CC);
+    rv = pcbc_encode_value(bucket, value, &bytes, &flags, &datatype TSRMLS_CC);
     if (span) {
         lcbtrace_span_finish(span, LCBTRACE_NOW);
     }
@@ -383,14 +347,14 @@ PHP_METHOD(Collection, upsert)
     }
 
     lcb_cmdstore_key(cmd, ZSTR_VAL(id), ZSTR_LEN(id));
-    lcb_cmdstore_value(cmd, bytes, nbytes);
+    lcb_cmdstore_value(cmd, ZSTR_VAL(bytes), ZSTR_LEN(bytes));
     lcb_cmdstore_flags(cmd, flags);
     lcb_cmdstore_datatype(cmd, datatype);
 
     object_init_ex(return_value, pcbc_store_result_impl_ce);
     struct store_cookie cookie = {LCB_SUCCESS, return_value};
     err = lcb_store(bucket->conn->lcb, &cookie, cmd);
-    efree(bytes);
+    zend_string_release(bytes);
     lcb_cmdstore_destroy(cmd);
     if (err == LCB_SUCCESS) {
         lcb_wait(bucket->conn->lcb, LCB_WAIT_DEFAULT);
@@ -399,11 +363,86 @@ PHP_METHOD(Collection, upsert)
     if (parent_span) {
         lcbtrace_span_finish(parent_span, LCBTRACE_NOW);
     }
+    pcbc_metrics_record(PCBC_METRICS_UPSERT, started_at, err TSRMLS_CC);
     if (err != LCB_SUCCESS) {
         throw_lcb_exception(err, pcbc_store_result_impl_ce);
     }
 }
 
+PHP_METHOD(Collection, upsertAsync)
+{
+    zend_string *id;
+    zval *value, *options = NULL;
+    lcb_STATUS err = LCB_ERR_INVALID_ARGUMENT;
+
+    int rv = zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "Sz|O", &id, &value, &options, pcbc_upsert_options_ce);
+    if (rv == FAILURE) {
+        RETURN_NULL();
+    }
+    PCBC_RESOLVE_COLLECTION;
+
+    lcb_CMDSTORE *cmd;
+    lcb_cmdstore_create(&cmd, LCB_STORE_UPSERT);
+    lcb_cmdstore_collection(cmd, scope_str, scope_len, collection_str, collection_len);
+    if (options) {
+        zval *prop, ret;
+        prop = zend_read_property(pcbc_upsert_options_ce, options, ZEND_STRL("timeout"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_LONG) {
+            lcb_cmdstore_timeout(cmd, Z_LVAL_P(prop));
+        }
+        prop = zend_read_property(pcbc_upsert_options_ce, options, ZEND_STRL("expiry"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_LONG) {
+            lcb_cmdstore_expiry(cmd, Z_LVAL_P(prop));
+        }
+        prop = zend_read_property(pcbc_upsert_options_ce, options, ZEND_STRL("durability_level"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_LONG) {
+            lcb_cmdstore_durability(cmd, Z_LVAL_P(prop));
+        }
+        prop = zend_read_property(pcbc_upsert_options_ce, options, ZEND_STRL("cas"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_STRING) {
+            uint64_t cas;
+            if (pcbc_cas_decode(Z_STR_P(prop), &cas)) {
+                lcb_cmdstore_cas(cmd, cas);
+            }
+        }
+    }
+
+    zend_string *bytes = NULL;
+    uint32_t flags;
+    uint8_t datatype;
+    rv = pcbc_encode_value(bucket, value, &bytes, &flags, &datatype TSRMLS_CC);
+    if (rv != SUCCESS) {
+        pcbc_log(LOGARGS(bucket->conn->lcb, ERROR), "Failed to encode value for before storing");
+        lcb_cmdstore_destroy(cmd);
+        throw_lcb_exception(err, NULL);
+        RETURN_NULL();
+    }
+
+    lcb_cmdstore_key(cmd, ZSTR_VAL(id), ZSTR_LEN(id));
+    lcb_cmdstore_value(cmd, ZSTR_VAL(bytes), ZSTR_LEN(bytes));
+    lcb_cmdstore_flags(cmd, flags);
+    lcb_cmdstore_datatype(cmd, datatype);
+
+    lcbtrace_SPAN *span = NULL;
+    lcbtrace_TRACER *tracer = lcb_get_tracer(bucket->conn->lcb);
+    if (tracer) {
+        span = lcbtrace_span_start(tracer, "php/" LCBTRACE_OP_UPSERT, 0, NULL);
+        lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_COMPONENT, pcbc_client_string);
+        lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_SERVICE, LCBTRACE_TAG_SERVICE_KV);
+        lcb_cmdstore_parent_span(cmd, span);
+    }
+
+    pcbc_future_t *future = pcbc_future_init(return_value, bucket->conn, pcbc_store_result_impl_ce, span TSRMLS_CC);
+    future->metrics_op = PCBC_METRICS_UPSERT;
+    future->started_at = lcbtrace_now();
+    err = lcb_store(bucket->conn->lcb, future, cmd);
+    zend_string_release(bytes);
+    lcb_cmdstore_destroy(cmd);
+    if (err != LCB_SUCCESS) {
+        pcbc_future_fail(future, err TSRMLS_CC);
+    }
+}
+
 zend_class_entry *pcbc_replace_options_ce;
 
 PHP_METHOD(ReplaceOptions, cas)
@@ -413,12 +452,9 @@ PHP_METHOD(ReplaceOptions, cas)
     if (rv == FAILURE) {
         RETURN_NULL();
     }
-    zend_string *decoded = php_base64_decode_str(arg);
-    if (decoded) {
-        if (ZSTR_LEN(decoded) == sizeof(uint64_t)) {
-            zend_update_property_str(pcbc_replace_options_ce, getThis(), ZEND_STRL("cas"), arg TSRMLS_CC);
-        }
-        zend_string_free(decoded);
+    uint64_t cas;
+    if (pcbc_cas_decode(arg, &cas)) {
+        zend_update_property_str(pcbc_replace_options_ce, getThis(), ZEND_STRL("cas"), arg TSRMLS_CC);
     }
     RETURN_ZVAL(getThis(), 1, 0);
 }
@@ -513,12 +549,9 @@ PHP_METHOD(Collection, replace)
         }
         prop = zend_read_property(pcbc_replace_options_ce, options, ZEND_STRL("cas"), 0, &ret);
         if (Z_TYPE_P(prop) == IS_STRING) {
-            zend_string *decoded = php_base64_decode_str(Z_STR_P(prop));
-            if (decoded) {
-                uint64_t cas = 0;
-                memcpy(&cas, ZSTR_VAL(decoded), ZSTR_LEN(decoded));
+            uint64_t cas;
+            if (pcbc_cas_decode(Z_STR_P(prop), &cas)) {
                 lcb_cmdstore_cas(cmd, cas);
-                zend_string_free(decoded);
             }
         }
     }
@@ -540,11 +573,10 @@ PHP_METHOD(Collection, replace)
         lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_COMPONENT, pcbc_client_string);
         lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_SERVICE, LCBTRACE_TAG_SERVICE_KV);
     }
-    void *bytes = NULL;
-    size_t nbytes;
+    zend_string *bytes = NULL;
     uint32_t flags;
     uint8_t datatype;
-    rv = pcbc_encode_value(bucket, value, &bytes, &nbytes, &flags, &datatype TSRMLS_CC);
+    rv = pcbc_encode_value(bucket, value, &bytes, &flags, &datatype TSRMLS_CC);
     if (span) {
         lcbtrace_span_finish(span, LCBTRACE_NOW);
     }
@@ -556,14 +588,14 @@ PHP_METHOD(Collection, replace)
     }
 
     lcb_cmdstore_key(cmd, ZSTR_VAL(id), ZSTR_LEN(id));
-    lcb_cmdstore_value(cmd, bytes, nbytes);
+    lcb_cmdstore_value(cmd, ZSTR_VAL(bytes), ZSTR_LEN(bytes));
     lcb_cmdstore_flags(cmd, flags);
     lcb_cmdstore_datatype(cmd, datatype);
 
     object_init_ex(return_value, pcbc_store_result_impl_ce);
     struct store_cookie cookie = {LCB_SUCCESS, return_value};
     err = lcb_store(bucket->conn->lcb, &cookie, cmd);
-    efree(bytes);
+    zend_string_release(bytes);
     lcb_cmdstore_destroy(cmd);
     if (err == LCB_SUCCESS) {
         lcb_wait(bucket->conn->lcb, LCB_WAIT_DEFAULT);
@@ -577,6 +609,187 @@ PHP_METHOD(Collection, replace)
     }
 }
 
+/*
+ * Timeout, expiry and durability level of the options are applied to every document of the batch. CAS does not make
+ * sense for the whole batch, so it is ignored.
+ */
+static void pcbc_store_multi(zval *return_value, pcbc_bucket_t *bucket, const char *scope_str, size_t scope_len,
+                             const char *collection_str, size_t collection_len, lcb_STORE_OPERATION operation,
+                             const char *operation_name, zval *docs, zval *options,
+                             zend_class_entry *options_ce TSRMLS_DC)
+{
+    zend_long timeout = 0, expiry = 0, durability_level = 0;
+    if (options) {
+        zval *prop, ret;
+        prop = zend_read_property(options_ce, options, ZEND_STRL("timeout"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_LONG) {
+            timeout = Z_LVAL_P(prop);
+        }
+        prop = zend_read_property(options_ce, options, ZEND_STRL("expiry"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_LONG) {
+            expiry = Z_LVAL_P(prop);
+        }
+        prop = zend_read_property(options_ce, options, ZEND_STRL("durability_level"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_LONG) {
+            durability_level = Z_LVAL_P(prop);
+        }
+    }
+
+    uint32_t num_docs = zend_hash_num_elements(Z_ARRVAL_P(docs));
+    array_init_size(return_value, num_docs);
+    if (num_docs == 0) {
+        return;
+    }
+
+    lcbtrace_SPAN *span = NULL;
+    lcbtrace_TRACER *tracer = lcb_get_tracer(bucket->conn->lcb);
+    if (tracer) {
+        span = lcbtrace_span_start(tracer, operation_name, 0, NULL);
+        lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_COMPONENT, pcbc_client_string);
+        lcbtrace_span_add_tag_str(span, LCBTRACE_TAG_SERVICE, LCBTRACE_TAG_SERVICE_KV);
+    }
+
+    zend_string **ids = ecalloc(num_docs, sizeof(zend_string *));
+    zval *results = ecalloc(num_docs, sizeof(zval));
+    zval *errors = ecalloc(num_docs, sizeof(zval)); /* exceptions thrown by the transcoder */
+    struct store_cookie *cookies = ecalloc(num_docs, sizeof(struct store_cookie));
+    uint32_t idx = 0, num_scheduled = 0;
+    zend_string *str_key;
+    zend_ulong num_key;
+    zval *value;
+
+    lcb_sched_enter(bucket->conn->lcb);
+    ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(docs), num_key, str_key, value)
+    {
+        lcb_STATUS err = LCB_ERR_INVALID_ARGUMENT;
+        ids[idx] = str_key ? zend_string_copy(str_key) : zend_long_to_str(num_key);
+        object_init_ex(&results[idx], pcbc_store_result_impl_ce);
+        cookies[idx].rc = LCB_SUCCESS;
+        cookies[idx].return_value = &results[idx];
+        if (operation == LCB_STORE_UPSERT) {
+            cookies[idx].started_at = lcbtrace_now();
+        }
+
+        zend_string *bytes = NULL;
+        uint32_t flags;
+        uint8_t datatype;
+        int rv = pcbc_encode_value(bucket, value, &bytes, &flags, &datatype TSRMLS_CC);
+        if (EG(exception)) {
+            /* the pending exception would make the engine refuse to call the transcoder for the rest of the batch, so
+             * it becomes the result of this document instead */
+            ZVAL_OBJ(&errors[idx], EG(exception));
+            Z_ADDREF(errors[idx]);
+            zend_clear_exception();
+            if (rv == SUCCESS) {
+                zend_string_release(bytes);
+                rv = FAILURE;
+            }
+        }
+        if (rv == SUCCESS) {
+            lcb_CMDSTORE *cmd;
+            lcb_cmdstore_create(&cmd, operation);
+            lcb_cmdstore_collection(cmd, scope_str, scope_len, collection_str, collection_len);
+            lcb_cmdstore_key(cmd, ZSTR_VAL(ids[idx]), ZSTR_LEN(ids[idx]));
+            lcb_cmdstore_value(cmd, ZSTR_VAL(bytes), ZSTR_LEN(bytes));
+            lcb_cmdstore_flags(cmd, flags);
+            lcb_cmdstore_datatype(cmd, datatype);
+            if (timeout) {
+                lcb_cmdstore_timeout(cmd, timeout);
+            }
+            if (expiry) {
+                lcb_cmdstore_expiry(cmd, expiry);
+            }
+            if (durability_level) {
+                lcb_cmdstore_durability(cmd, durability_level);
+            }
+            if (span) {
+                lcb_cmdstore_parent_span(cmd, span);
+            }
+            err = lcb_store(bucket->conn->lcb, &cookies[idx], cmd);
+            zend_string_release(bytes);
+            lcb_cmdstore_destroy(cmd);
+        } else {
+            pcbc_log(LOGARGS(bucket->conn->lcb, ERROR), "Failed to encode value of \"%.*s\" before storing",
+                     (int)ZSTR_LEN(ids[idx]), ZSTR_VAL(ids[idx]));
+        }
+        if (err == LCB_SUCCESS) {
+            num_scheduled++;
+        } else {
+            cookies[idx].rc = err;
+            Z_KV_RESULT_OBJ_P(&results[idx])->status = err;
+            if (cookies[idx].started_at) {
+                pcbc_metrics_record(PCBC_METRICS_UPSERT, cookies[idx].started_at, err TSRMLS_CC);
+            }
+        }
+        idx++;
+    }
+    ZEND_HASH_FOREACH_END();
+    lcb_sched_leave(bucket->conn->lcb);
+
+    if (num_scheduled > 0) {
+        lcb_wait(bucket->conn->lcb, LCB_WAIT_DEFAULT);
+    }
+    if (span) {
+        lcbtrace_span_finish(span, LCBTRACE_NOW);
+    }
+
+    for (idx = 0; idx < num_docs; idx++) {
+        if (Z_ISUNDEF(errors[idx])) {
+            pcbc_multi_result_add(return_value, ids[idx], &results[idx], cookies[idx].rc TSRMLS_CC);
+        } else {
+            zend_symtable_update(Z_ARRVAL_P(return_value), ids[idx], &errors[idx]);
+            zval_ptr_dtor(&results[idx]);
+        }
+        zend_string_release(ids[idx]);
+    }
+    efree(cookies);
+    efree(errors);
+    efree(results);
+    efree(ids);
+}
+
+PHP_METHOD(Collection, insertMulti)
+{
+    zval *docs, *options = NULL;
+
+    int rv = zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "a|O", &docs, &options, pcbc_insert_options_ce);
+    if (rv == FAILURE) {
+        RETURN_NULL();
+    }
+    PCBC_RESOLVE_COLLECTION;
+
+    pcbc_store_multi(return_value, bucket, scope_str, scope_len, collection_str, collection_len, LCB_STORE_INSERT,
+                     "php/" LCBTRACE_OP_INSERT, docs, options, pcbc_insert_options_ce TSRMLS_CC);
+}
+
+PHP_METHOD(Collection, upsertMulti)
+{
+    zval *docs, *options = NULL;
+
+    int rv = zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "a|O", &docs, &options, pcbc_upsert_options_ce);
+    if (rv == FAILURE) {
+        RETURN_NULL();
+    }
+    PCBC_RESOLVE_COLLECTION;
+
+    pcbc_store_multi(return_value, bucket, scope_str, scope_len, collection_str, collection_len, LCB_STORE_UPSERT,
+                     "php/" LCBTRACE_OP_UPSERT, docs, options, pcbc_upsert_options_ce TSRMLS_CC);
+}
+
+PHP_METHOD(Collection, replaceMulti)
+{
+    zval *docs, *options = NULL;
+
+    int rv = zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "a|O", &docs, &options, pcbc_replace_options_ce);
+    if (rv == FAILURE) {
+        RETURN_NULL();
+    }
+    PCBC_RESOLVE_COLLECTION;
+
+    pcbc_store_multi(return_value, bucket, scope_str, scope_len, collection_str, collection_len, LCB_STORE_REPLACE,
+                     "php/" LCBTRACE_OP_REPLACE, docs, options, pcbc_replace_options_ce TSRMLS_CC);
+}
+
 zend_class_entry *pcbc_append_options_ce;
 
 PHP_METHOD(AppendOptions, cas)
@@ -586,12 +799,9 @@ PHP_METHOD(AppendOptions, cas)
     if (rv == FAILURE) {
         RETURN_NULL();
     }
-    zend_string *decoded = php_base64_decode_str(arg);
-    if (decoded) {
-        if (ZSTR_LEN(decoded) == sizeof(uint64_t)) {
-            zend_update_property_str(pcbc_append_options_ce, getThis(), ZEND_STRL("cas"), arg TSRMLS_CC);
-        }
-        zend_string_free(decoded);
+    uint64_t cas;
+    if (pcbc_cas_decode(arg, &cas)) {
+        zend_update_property_str(pcbc_append_options_ce, getThis(), ZEND_STRL("cas"), arg TSRMLS_CC);
     }
     RETURN_ZVAL(getThis(), 1, 0);
 }
@@ -666,12 +876,9 @@ PHP_METHOD(BinaryCollection, append)
         }
         prop = zend_read_property(pcbc_append_options_ce, options, ZEND_STRL("cas"), 0, &ret);
         if (Z_TYPE_P(prop) == IS_STRING) {
-            zend_string *decoded = php_base64_decode_str(Z_STR_P(prop));
-            if (decoded) {
-                uint64_t cas = 0;
-                memcpy(&cas, ZSTR_VAL(decoded), ZSTR_LEN(decoded));
+            uint64_t cas;
+            if (pcbc_cas_decode(Z_STR_P(prop), &cas)) {
                 lcb_cmdstore_cas(cmd, cas);
-                zend_string_free(decoded);
             }
         }
     }
@@ -713,12 +920,9 @@ PHP_METHOD(PrependOptions, cas)
     if (rv == FAILURE) {
         RETURN_NULL();
     }
-    zend_string *decoded = php_base64_decode_str(arg);
-    if (decoded) {
-        if (ZSTR_LEN(decoded) == sizeof(uint64_t)) {
-            zend_update_property_str(pcbc_prepend_options_ce, getThis(), ZEND_STRL("cas"), arg TSRMLS_CC);
-        }
-        zend_string_free(decoded);
+    uint64_t cas;
+    if (pcbc_cas_decode(arg, &cas)) {
+        zend_update_property_str(pcbc_prepend_options_ce, getThis(), ZEND_STRL("cas"), arg TSRMLS_CC);
     }
     RETURN_ZVAL(getThis(), 1, 0);
 }
@@ -793,12 +997,9 @@ PHP_METHOD(BinaryCollection, prepend)
         }
         prop = zend_read_property(pcbc_append_options_ce, options, ZEND_STRL("cas"), 0, &ret);
         if (Z_TYPE_P(prop) == IS_STRING) {
-            zend_string *decoded = php_base64_decode_str(Z_STR_P(prop));
-            if (decoded) {
-                uint64_t cas = 0;
-                memcpy(&cas, ZSTR_VAL(decoded), ZSTR_LEN(decoded));
+            uint64_t cas;
+            if (pcbc_cas_decode(Z_STR_P(prop), &cas)) {
                 lcb_cmdstore_cas(cmd, cas);
-                zend_string_free(decoded);
             }
         }
     }
@@ -37,7 +37,6 @@ extern zend_class_entry *pcbc_mutate_counter_spec_ce;
 
 extern zend_class_entry *pcbc_mutate_in_result_impl_ce;
 extern zend_class_entry *pcbc_mutate_in_result_entry_ce;
-extern zend_class_entry *pcbc_mutation_token_impl_ce;
 
 struct subdoc_cookie {
     lcb_STATUS rc;
@@ -51,30 +50,21 @@ void subdoc_lookup_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPSU
     const lcb_KEY_VALUE_ERROR_CONTEXT *ectx = NULL;
     struct subdoc_cookie *cookie = NULL;
     lcb_respsubdoc_cookie(resp, (void **)&cookie);
-    zval *return_value = cookie->return_value;
+    pcbc_kv_result_t *result = Z_KV_RESULT_OBJ_P(cookie->return_value);
     cookie->rc = lcb_respsubdoc_status(resp);
-    zend_update_property_long(pcbc_lookup_in_result_impl_ce, return_value, ZEND_STRL("status"), cookie->rc TSRMLS_CC);
+    result->status = cookie->rc;
 
     lcb_respsubdoc_error_context(resp, &ectx);
-    set_property_str(ectx, lcb_errctx_kv_context, pcbc_lookup_in_result_impl_ce, "err_ctx");
-    set_property_str(ectx, lcb_errctx_kv_ref, pcbc_lookup_in_result_impl_ce, "err_ref");
-    set_property_str(ectx, lcb_errctx_kv_key, pcbc_lookup_in_result_impl_ce, "key");
+    set_result_str(ectx, lcb_errctx_kv_context, result->err_ctx);
+    set_result_str(ectx, lcb_errctx_kv_ref, result->err_ref);
     if (cookie->rc == LCB_SUCCESS) {
-        uint64_t data;
-        lcb_respsubdoc_cas(resp, &data);
-        zend_string *b64;
-        b64 = php_base64_encode((unsigned char *)&data, sizeof(data));
-        zend_update_property_str(pcbc_lookup_in_result_impl_ce, return_value, ZEND_STRL("cas"), b64 TSRMLS_CC);
+        lcb_respsubdoc_cas(resp, &result->cas);
     }
     size_t num_results = lcb_respsubdoc_result_size(resp);
     size_t idx;
-    zval data;
-    array_init(&data);
-    zend_update_property(pcbc_lookup_in_result_impl_ce, return_value, ZEND_STRL("data"), &data TSRMLS_CC);
-    Z_DELREF(data);
+    array_init_size(&result->content, num_results);
     for (idx = 0; idx < num_results; idx++) {
         zval entry;
-        array_init(&entry);
         object_init_ex(&entry, pcbc_lookup_in_result_entry_ce);
 
         zend_update_property_long(pcbc_lookup_in_result_entry_ce, &entry, ZEND_STRL("code"),
@@ -94,8 +84,7 @@ void subdoc_lookup_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPSU
             }
         }
         zend_update_property(pcbc_lookup_in_result_entry_ce, &entry, ZEND_STRL("value"), &value TSRMLS_CC);
-        add_index_zval(&data, idx, &entry);
-        Z_TRY_ADDREF(entry);
+        add_index_zval(&result->content, idx, &entry);
     }
 }
 
@@ -106,55 +95,29 @@ void subdoc_mutate_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPSU
     const lcb_KEY_VALUE_ERROR_CONTEXT *ectx = NULL;
     struct subdoc_cookie *cookie = NULL;
     lcb_respsubdoc_cookie(resp, (void **)&cookie);
-    zval *return_value = cookie->return_value;
+    pcbc_kv_result_t *result = Z_KV_RESULT_OBJ_P(cookie->return_value);
     cookie->rc = lcb_respsubdoc_status(resp);
-    zend_update_property_long(pcbc_mutate_in_result_impl_ce, return_value, ZEND_STRL("status"), cookie->rc TSRMLS_CC);
+    result->status = cookie->rc;
 
     lcb_respsubdoc_error_context(resp, &ectx);
 
-    set_property_str(ectx, lcb_errctx_kv_context, pcbc_mutate_in_result_impl_ce, "err_ctx");
-    set_property_str(ectx, lcb_errctx_kv_ref, pcbc_mutate_in_result_impl_ce, "err_ref");
-    set_property_str(ectx, lcb_errctx_kv_key, pcbc_mutate_in_result_impl_ce, "key");
+    set_result_str(ectx, lcb_errctx_kv_context, result->err_ctx);
+    set_result_str(ectx, lcb_errctx_kv_ref, result->err_ref);
     if (cookie->rc == LCB_SUCCESS) {
-        uint64_t data;
-        lcb_respsubdoc_cas(resp, &data);
-        zend_string *b64;
-        b64 = php_base64_encode((unsigned char *)&data, sizeof(data));
-        zend_update_property_str(pcbc_mutate_in_result_impl_ce, return_value, ZEND_STRL("cas"), b64 TSRMLS_CC);
+        lcb_respsubdoc_cas(resp, &result->cas);
         {
             lcb_MUTATION_TOKEN token = {0};
             lcb_respsubdoc_mutation_token(resp, &token);
             if (lcb_mutation_token_is_valid(&token)) {
-                zval val;
-                object_init_ex(&val, pcbc_mutation_token_impl_ce);
-
-                zend_update_property_long(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("partition_id"),
-                                          token.vbid_ TSRMLS_CC);
-                b64 = php_base64_encode((unsigned char *)&token.uuid_, sizeof(token.uuid_));
-                zend_update_property_str(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("partition_uuid"), b64 TSRMLS_CC);
-                b64 = php_base64_encode((unsigned char *)&token.seqno_, sizeof(token.seqno_));
-                zend_update_property_str(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("sequence_number"),
-                                         b64 TSRMLS_CC);
-
-                const char *bucket;
-                lcb_cntl(instance, LCB_CNTL_GET, LCB_CNTL_BUCKETNAME, &bucket);
-                zend_update_property_string(pcbc_mutation_token_impl_ce, &val, ZEND_STRL("bucket_name"),
-                                            bucket TSRMLS_CC);
-
-                zend_update_property(pcbc_mutate_in_result_impl_ce, return_value, ZEND_STRL("mutation_token"),
-                                     &val TSRMLS_CC);
+                pcbc_mutation_token_init(&result->mutation_token, instance, &token TSRMLS_CC);
             }
         }
     }
     size_t num_results = lcb_respsubdoc_result_size(resp);
     size_t idx;
-    zval data;
-    array_init(&data);
-    zend_update_property(pcbc_mutate_in_result_impl_ce, return_value, ZEND_STRL("data"), &data TSRMLS_CC);
-    Z_DELREF(data);
+    array_init_size(&result->content, num_results);
     for (idx = 0; idx < num_results; idx++) {
         zval entry;
-        array_init(&entry);
         object_init_ex(&entry, pcbc_mutate_in_result_entry_ce);
 
         zend_update_property_long(pcbc_mutate_in_result_entry_ce, &entry, ZEND_STRL("code"),
@@ -174,8 +137,7 @@ void subdoc_mutate_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPSU
             }
         }
         zend_update_property(pcbc_mutate_in_result_entry_ce, &entry, ZEND_STRL("value"), &value TSRMLS_CC);
-        add_index_zval(&data, idx, &entry);
-        Z_TRY_ADDREF(entry);
+        add_index_zval(&result->content, idx, &entry);
     }
 }
 
@@ -319,12 +281,9 @@ PHP_METHOD(MutateInOptions, cas)
     if (rv == FAILURE) {
         RETURN_NULL();
     }
-    zend_string *decoded = php_base64_decode_str(arg);
-    if (decoded) {
-        if (ZSTR_LEN(decoded) == sizeof(uint64_t)) {
-            zend_update_property_str(pcbc_mutate_in_options_ce, getThis(), ZEND_STRL("cas"), arg TSRMLS_CC);
-        }
-        zend_string_free(decoded);
+    uint64_t cas;
+    if (pcbc_cas_decode(arg, &cas)) {
+        zend_update_property_str(pcbc_mutate_in_options_ce, getThis(), ZEND_STRL("cas"), arg TSRMLS_CC);
     }
     RETURN_ZVAL(getThis(), 1, 0);
 }
@@ -570,12 +529,9 @@ PHP_METHOD(Collection, mutateIn)
         }
         prop = zend_read_property(pcbc_mutate_in_options_ce, options, ZEND_STRL("cas"), 0, &ret);
         if (Z_TYPE_P(prop) == IS_STRING) {
-            zend_string *decoded = php_base64_decode_str(Z_STR_P(prop));
-            if (decoded) {
-                uint64_t cas = 0;
-                memcpy(&cas, ZSTR_VAL(decoded), ZSTR_LEN(decoded));
+            uint64_t cas;
+            if (pcbc_cas_decode(Z_STR_P(prop), &cas)) {
                 lcb_cmdsubdoc_cas(cmd, cas);
-                zend_string_free(decoded);
             }
         }
     }
@@ -32,24 +32,17 @@ void unlock_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPUNLOCK *r
     const lcb_KEY_VALUE_ERROR_CONTEXT *ectx = NULL;
     struct unlock_cookie *cookie = NULL;
     lcb_respunlock_cookie(resp, (void **)&cookie);
-    zval *return_value = cookie->return_value;
+    pcbc_kv_result_t *result = Z_KV_RESULT_OBJ_P(cookie->return_value);
     cookie->rc = lcb_respunlock_status(resp);
-    zend_update_property_long(pcbc_result_impl_ce, return_value, ZEND_STRL("status"), cookie->rc TSRMLS_CC);
+    result->status = cookie->rc;
 
     lcb_respunlock_error_context(resp, &ectx);
 
-    set_property_str(ectx, lcb_errctx_kv_context, pcbc_result_impl_ce, "err_ctx");
-    set_property_str(ectx, lcb_errctx_kv_ref, pcbc_result_impl_ce, "err_ref");
-    set_property_str(ectx, lcb_errctx_kv_key, pcbc_result_impl_ce, "key");
+    set_result_str(ectx, lcb_errctx_kv_context, result->err_ctx);
+    set_result_str(ectx, lcb_errctx_kv_ref, result->err_ref);
 
     if (cookie->rc == LCB_SUCCESS) {
-        zend_string *b64;
-        {
-            uint64_t data;
-            lcb_respunlock_cas(resp, &data);
-            b64 = php_base64_encode((unsigned char *)&data, sizeof(data));
-            zend_update_property_str(pcbc_result_impl_ce, return_value, ZEND_STRL("cas"), b64 TSRMLS_CC);
-        }
+        lcb_respunlock_cas(resp, &result->cas);
     }
 }
 
@@ -94,12 +87,9 @@ PHP_METHOD(Collection, unlock)
     lcb_cmdunlock_create(&cmd);
     lcb_cmdunlock_collection(cmd, scope_str, scope_len, collection_str, collection_len);
     lcb_cmdunlock_key(cmd, ZSTR_VAL(id), ZSTR_LEN(id));
-    zend_string *decoded = php_base64_decode_str(cas);
-    if (decoded) {
-        uint64_t cas_val = 0;
-        memcpy(&cas_val, ZSTR_VAL(decoded), ZSTR_LEN(decoded));
+    uint64_t cas_val;
+    if (pcbc_cas_decode(cas, &cas_val)) {
         lcb_cmdunlock_cas(cmd, cas_val);
-        zend_string_free(decoded);
     }
     if (options) {
         zval *prop, ret;
@@ -24,16 +24,11 @@ extern zend_class_entry *pcbc_view_result_impl_ce;
 extern zend_class_entry *pcbc_view_result_entry_ce;
 extern zend_class_entry *pcbc_view_meta_data_impl_ce;
 
-struct view_cookie {
-    lcb_STATUS rc;
-    zval *return_value;
-};
-
 static void viewrow_callback(lcb_INSTANCE *instance, int ignoreme, const lcb_RESPVIEW *resp)
 {
     TSRMLS_FETCH();
 
-    struct view_cookie *cookie;
+    pcbc_row_cookie_t *cookie;
     lcb_respview_cookie(resp, (void **)&cookie);
     cookie->rc = lcb_respview_status(resp);
 
@@ -115,26 +110,24 @@ static void viewrow_callback(lcb_INSTANCE *instance, int ignoreme, const lcb_RES
 
             const lcb_RESPGET *get;
             lcb_respview_document(resp, &get);
-            zval document;
             if (get) {
                 const char *doc_str;
                 size_t doc_len;
                 lcb_respget_value(get, &doc_str, &doc_len);
                 if (doc_len) {
-                    PCBC_JSON_COPY_DECODE(&document, doc_str, doc_len, PHP_JSON_OBJECT_AS_ARRAY, last_error);
-                    if (last_error) {
-                        pcbc_log(LOGARGS(instance, WARN), "Failed to decode VIEW document as JSON: json_last_error=%d",
-                                 last_error);
-                    } else {
-                        zend_update_property(pcbc_view_result_entry_ce, &entry, ZEND_STRL("document"),
-                                             &document TSRMLS_CC);
-                    }
+                    /* the document will be decoded by ViewRow::document(), if the application asks for it */
+                    zend_update_property_stringl(pcbc_view_result_entry_ce, &entry, ZEND_STRL("document_str"), doc_str,
+                                                 doc_len TSRMLS_CC);
                 }
             }
 
-            zval *rows, rv;
-            rows = zend_read_property(pcbc_view_result_impl_ce, return_value, ZEND_STRL("rows"), 0, &rv);
-            add_next_index_zval(rows, &entry);
+            if (cookie->stream) {
+                pcbc_row_stream_push(cookie->stream, &entry);
+            } else {
+                zval *rows, rv;
+                rows = zend_read_property(pcbc_view_result_impl_ce, return_value, ZEND_STRL("rows"), 0, &rv);
+                add_next_index_zval(rows, &entry);
+            }
         }
     } else {
         const char *body_str;
@@ -152,6 +145,14 @@ static void viewrow_callback(lcb_INSTANCE *instance, int ignoreme, const lcb_RES
             }
         }
     }
+    if (cookie->stream && lcb_respview_is_final(resp)) {
+        pcbc_row_stream_finish(cookie->stream);
+    }
+}
+
+static void pcbc_view_cancel(lcb_INSTANCE *instance, void *handle)
+{
+    lcb_view_cancel(instance, (lcb_VIEW_HANDLE *)handle);
 }
 
 zend_class_entry *pcbc_view_order_ce;
@@ -188,6 +189,21 @@ PHP_METHOD(ViewOptions, includeDocuments)
     RETURN_ZVAL(getThis(), 1, 0);
 }
 
+PHP_METHOD(ViewOptions, streaming)
+{
+    zend_bool arg;
+    zend_long window = 0;
+    int rv = zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "b|l", &arg, &window);
+    if (rv == FAILURE) {
+        RETURN_NULL();
+    }
+    zend_update_property_bool(pcbc_view_options_ce, getThis(), ZEND_STRL("streaming"), arg TSRMLS_CC);
+    if (window > 0) {
+        zend_update_property_long(pcbc_view_options_ce, getThis(), ZEND_STRL("stream_window"), window TSRMLS_CC);
+    }
+    RETURN_ZVAL(getThis(), 1, 0);
+}
+
 PHP_METHOD(ViewOptions, key)
 {
     zval *arg;
@@ -486,6 +502,11 @@ ZEND_ARG_TYPE_INFO(0, arg, _IS_BOOL, 0)
 ZEND_ARG_TYPE_INFO(0, maxConcurrentDocuments, IS_LONG, 1)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_ViewOptions_streaming, 0, 1, \\Couchbase\\ViewOptions, 0)
+ZEND_ARG_TYPE_INFO(0, enabled, _IS_BOOL, 0)
+ZEND_ARG_TYPE_INFO(0, rowWindow, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_ViewOptions_key, 0, 1, \\Couchbase\\ViewOptions, 0)
 ZEND_ARG_INFO(0, arg)
 ZEND_END_ARG_INFO()
@@ -555,6 +576,7 @@ static const zend_function_entry pcbc_view_options_methods[] = {
     PHP_ME(ViewOptions, range, ai_ViewOptions_range, ZEND_ACC_PUBLIC)
     PHP_ME(ViewOptions, idRange, ai_ViewOptions_idRange, ZEND_ACC_PUBLIC)
     PHP_ME(ViewOptions, raw, ai_ViewOptions_raw, ZEND_ACC_PUBLIC)
+    PHP_ME(ViewOptions, streaming, ai_ViewOptions_streaming, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
 // clang-format on
@@ -565,6 +587,8 @@ PHP_METHOD(Bucket, viewQuery)
     zend_string *design_doc;
     zend_string *view_name;
     zval *options = NULL;
+    zend_bool streaming = 0;
+    zend_long stream_window = 0;
 
     rv = zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "SS|O", &design_doc, &view_name, &options,
                                pcbc_view_options_ce);
@@ -626,6 +650,12 @@ PHP_METHOD(Bucket, viewQuery)
                 lcb_cmdview_post_data(cmd, ZSTR_VAL(body_str.s), ZSTR_LEN(body_str.s));
             }
         }
+        prop = zend_read_property(pcbc_view_options_ce, options, ZEND_STRL("streaming"), 0, &ret);
+        streaming = Z_TYPE_P(prop) == IS_TRUE;
+        prop = zend_read_property(pcbc_view_options_ce, options, ZEND_STRL("stream_window"), 0, &ret);
+        if (Z_TYPE_P(prop) == IS_LONG) {
+            stream_window = Z_LVAL_P(prop);
+        }
     }
 
     lcb_cmdview_callback(cmd, viewrow_callback);
@@ -642,6 +672,27 @@ PHP_METHOD(Bucket, viewQuery)
         lcb_cmdview_parent_span(cmd, span);
     }
 
+    if (streaming) {
+        pcbc_row_stream_t *stream =
+            pcbc_row_stream_init(return_value, obj->conn, pcbc_view_result_impl_ce, stream_window TSRMLS_CC);
+        stream->cancel = pcbc_view_cancel;
+        stream->span = span;
+        stream->metrics_op = PCBC_METRICS_VIEW;
+        stream->started_at = lcbtrace_now();
+        lcb_STATUS err = lcb_view(obj->conn->lcb, &stream->cookie, cmd);
+        smart_str_free(&query_str);
+        smart_str_free(&body_str);
+        lcb_cmdview_destroy(cmd);
+        if (err != LCB_SUCCESS) {
+            pcbc_row_stream_finish(stream);
+            throw_lcb_exception(err, NULL);
+            return;
+        }
+        /* the rows will be fetched by the stream, when the application iterates over them */
+        stream->handle = handle;
+        return;
+    }
+
     rv = object_init_ex(return_value, pcbc_view_result_impl_ce);
     if (rv != SUCCESS) {
         return;
@@ -650,7 +701,8 @@ PHP_METHOD(Bucket, viewQuery)
     array_init(&rows);
     zend_update_property(pcbc_view_result_impl_ce, return_value, ZEND_STRL("rows"), &rows TSRMLS_CC);
     Z_DELREF(rows);
-    struct view_cookie cookie = {LCB_SUCCESS, return_value};
+    pcbc_row_cookie_t cookie = {LCB_SUCCESS, return_value, NULL};
+    uint64_t started_at = lcbtrace_now();
     lcb_STATUS err = lcb_view(obj->conn->lcb, &cookie, cmd);
     smart_str_free(&query_str);
     smart_str_free(&body_str);
@@ -662,6 +714,7 @@ PHP_METHOD(Bucket, viewQuery)
     if (span) {
         lcbtrace_span_finish(span, LCBTRACE_NOW);
     }
+    pcbc_metrics_record(PCBC_METRICS_VIEW, started_at, err TSRMLS_CC);
     if (err != LCB_SUCCESS) {
         throw_lcb_exception(err, NULL);
     }
@@ -680,6 +733,8 @@ PHP_MINIT_FUNCTION(BucketView)
 
     zend_declare_property_null(pcbc_view_options_ce, ZEND_STRL("query"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_view_options_ce, ZEND_STRL("body"), ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_null(pcbc_view_options_ce, ZEND_STRL("streaming"), ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_null(pcbc_view_options_ce, ZEND_STRL("stream_window"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "ViewScanConsistency", pcbc_view_consistency_methods);
     pcbc_view_consistency_ce = zend_register_internal_interface(&ce TSRMLS_CC);
@@ -24,8 +24,10 @@ extern zend_class_entry *pcbc_cluster_manager_ce;
 extern zend_class_entry *pcbc_cluster_options_ce;
 
 PHP_METHOD(Cluster, query);
+PHP_METHOD(Cluster, queryAsync);
 PHP_METHOD(Cluster, analyticsQuery);
 PHP_METHOD(Cluster, searchQuery);
+PHP_METHOD(Cluster, searchQueryAsync);
 
 static void pcbc_bucket_init(zval *return_value, pcbc_cluster_t *cluster, const char *bucketname TSRMLS_DC)
 {
@@ -33,8 +35,8 @@ static void pcbc_bucket_init(zval *return_value, pcbc_cluster_t *cluster, const
     pcbc_connection_t *conn;
     lcb_STATUS err;
 
-    err = pcbc_connection_get(&conn, LCB_TYPE_BUCKET, cluster->connstr, bucketname, cluster->username,
-                              cluster->password TSRMLS_CC);
+    err = pcbc_connection_get_bucket(&conn, cluster->conn, cluster->connstr, bucketname, cluster->username,
+                                     cluster->password TSRMLS_CC);
     if (err) {
         throw_lcb_exception(err, NULL);
         return;
@@ -47,6 +49,7 @@ static void pcbc_bucket_init(zval *return_value, pcbc_cluster_t *cluster, const
     ZVAL_UNDEF(&bucket->decoder);
     PCBC_STRING(bucket->encoder, "\\Couchbase\\defaultEncoder");
     PCBC_STRING(bucket->decoder, "\\Couchbase\\defaultDecoder");
+    bucket->default_encoder = 1;
 }
 
 static void pcbc_cluster_connection_init(zval *return_value, pcbc_cluster_t *cluster TSRMLS_DC)
@@ -171,6 +174,11 @@ ZEND_ARG_TYPE_INFO(0, statement, IS_STRING, 0)
 ZEND_ARG_OBJ_INFO(0, queryOptions, \\Couchbase\\QueryOptions, 1)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_Cluster_queryAsync, 0, 1, \\Couchbase\\Future, 0)
+ZEND_ARG_TYPE_INFO(0, statement, IS_STRING, 0)
+ZEND_ARG_OBJ_INFO(0, queryOptions, \\Couchbase\\QueryOptions, 1)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_Cluster_analyticsQuery, 0, 1, \\Couchbase\\AnalyticsResult, 0)
 ZEND_ARG_TYPE_INFO(0, statement, IS_STRING, 0)
 ZEND_ARG_OBJ_INFO(0, queryOptions, \\Couchbase\\AnalyticsOptions, 1)
@@ -182,6 +190,12 @@ ZEND_ARG_OBJ_INFO(0, query, \\Couchbase\\SearchQuery, 0)
 ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\SearchOptions, 0)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_Cluster_searchQueryAsync, 0, 2, \\Couchbase\\Future, 0)
+ZEND_ARG_TYPE_INFO(0, indexName, IS_STRING, 0)
+ZEND_ARG_OBJ_INFO(0, query, \\Couchbase\\SearchQuery, 0)
+ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\SearchOptions, 0)
+ZEND_END_ARG_INFO()
+
 // clang-format off
 zend_function_entry cluster_methods[] = {
     PHP_ME(Cluster, __construct, ai_Cluster_constructor, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
@@ -189,8 +203,10 @@ zend_function_entry cluster_methods[] = {
     PHP_ME(Cluster, manager, ai_Cluster_manager, ZEND_ACC_PUBLIC)
     PHP_ME(Cluster, queryIndexes, ai_Cluster_queryIndexes, ZEND_ACC_PUBLIC)
     PHP_ME(Cluster, query, ai_Cluster_query, ZEND_ACC_PUBLIC)
+    PHP_ME(Cluster, queryAsync, ai_Cluster_queryAsync, ZEND_ACC_PUBLIC)
     PHP_ME(Cluster, analyticsQuery, ai_Cluster_analyticsQuery, ZEND_ACC_PUBLIC)
     PHP_ME(Cluster, searchQuery, ai_Cluster_searchQuery, ZEND_ACC_PUBLIC)
+    PHP_ME(Cluster, searchQueryAsync, ai_Cluster_searchQueryAsync, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
 // clang-format on
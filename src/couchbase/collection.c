@@ -161,6 +161,18 @@ ZEND_ARG_TYPE_INFO(0, id, IS_STRING, 0)
 ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\GetOptions, 0)
 ZEND_END_ARG_INFO()
 
+PHP_METHOD(Collection, getAsync);
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_Collection_getAsync, 0, 1, \\Couchbase\\Future, 0)
+ZEND_ARG_TYPE_INFO(0, id, IS_STRING, 0)
+ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\GetOptions, 0)
+ZEND_END_ARG_INFO()
+
+PHP_METHOD(Collection, getMulti);
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(ai_Collection_getMulti, IS_ARRAY, 0)
+ZEND_ARG_TYPE_INFO(0, ids, IS_ARRAY, 0)
+ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\GetOptions, 0)
+ZEND_END_ARG_INFO()
+
 PHP_METHOD(Collection, getAndLock);
 ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_Collection_getAndLock, 0, 2, \\Couchbase\\GetResult, 0)
 ZEND_ARG_TYPE_INFO(0, id, IS_STRING, 0)
@@ -181,6 +193,12 @@ ZEND_ARG_TYPE_INFO(0, id, IS_STRING, 0)
 ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\ExistsOptions, 0)
 ZEND_END_ARG_INFO()
 
+PHP_METHOD(Collection, existsMulti);
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(ai_Collection_existsMulti, IS_ARRAY, 0)
+ZEND_ARG_TYPE_INFO(0, ids, IS_ARRAY, 0)
+ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\ExistsOptions, 0)
+ZEND_END_ARG_INFO()
+
 PHP_METHOD(Collection, getAnyReplica);
 ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_Collection_getAnyReplica, 0, 1, \\Couchbase\\GetReplicaResult, 0)
 ZEND_ARG_TYPE_INFO(0, id, IS_STRING, 0)
@@ -200,6 +218,13 @@ ZEND_ARG_INFO(0, value)
 ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\UpsertOptions, 0)
 ZEND_END_ARG_INFO()
 
+PHP_METHOD(Collection, upsertAsync);
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_Collection_upsertAsync, 0, 2, \\Couchbase\\Future, 0)
+ZEND_ARG_TYPE_INFO(0, id, IS_STRING, 0)
+ZEND_ARG_INFO(0, value)
+ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\UpsertOptions, 0)
+ZEND_END_ARG_INFO()
+
 PHP_METHOD(Collection, insert);
 ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_Collection_insert, 0, 2, \\Couchbase\\MutationResult, 0)
 ZEND_ARG_TYPE_INFO(0, id, IS_STRING, 0)
@@ -214,12 +239,36 @@ ZEND_ARG_INFO(0, value)
 ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\ReplaceOptions, 0)
 ZEND_END_ARG_INFO()
 
+PHP_METHOD(Collection, upsertMulti);
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(ai_Collection_upsertMulti, IS_ARRAY, 0)
+ZEND_ARG_TYPE_INFO(0, documents, IS_ARRAY, 0)
+ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\UpsertOptions, 0)
+ZEND_END_ARG_INFO()
+
+PHP_METHOD(Collection, insertMulti);
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(ai_Collection_insertMulti, IS_ARRAY, 0)
+ZEND_ARG_TYPE_INFO(0, documents, IS_ARRAY, 0)
+ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\InsertOptions, 0)
+ZEND_END_ARG_INFO()
+
+PHP_METHOD(Collection, replaceMulti);
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(ai_Collection_replaceMulti, IS_ARRAY, 0)
+ZEND_ARG_TYPE_INFO(0, documents, IS_ARRAY, 0)
+ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\ReplaceOptions, 0)
+ZEND_END_ARG_INFO()
+
 PHP_METHOD(Collection, remove);
 ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_Collection_remove, 0, 1, \\Couchbase\\MutationResult, 0)
 ZEND_ARG_TYPE_INFO(0, id, IS_STRING, 0)
 ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\RemoveOptions, 0)
 ZEND_END_ARG_INFO()
 
+PHP_METHOD(Collection, removeMulti);
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(ai_Collection_removeMulti, IS_ARRAY, 0)
+ZEND_ARG_TYPE_INFO(0, ids, IS_ARRAY, 0)
+ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\RemoveOptions, 0)
+ZEND_END_ARG_INFO()
+
 PHP_METHOD(Collection, unlock);
 ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_Collection_unlock, 0, 2, \\Couchbase\\Result, 0)
 ZEND_ARG_TYPE_INFO(0, id, IS_STRING, 0)
@@ -234,6 +283,13 @@ ZEND_ARG_TYPE_INFO(0, expiry, IS_LONG, 0)
 ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\TouchOptions, 0)
 ZEND_END_ARG_INFO()
 
+PHP_METHOD(Collection, touchMulti);
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(ai_Collection_touchMulti, IS_ARRAY, 0)
+ZEND_ARG_TYPE_INFO(0, ids, IS_ARRAY, 0)
+ZEND_ARG_TYPE_INFO(0, expiry, IS_LONG, 0)
+ZEND_ARG_OBJ_INFO(0, options, \\Couchbase\\TouchOptions, 0)
+ZEND_END_ARG_INFO()
+
 PHP_METHOD(Collection, lookupIn);
 ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_Collection_lookupIn, 0, 2, \\Couchbase\\LookupInResult, 0)
 ZEND_ARG_TYPE_INFO(0, id, IS_STRING, 0)
@@ -295,7 +351,10 @@ static zend_function_entry collection_methods[] = {
     PHP_ME(Collection, __construct, ai_Collection___construct, ZEND_ACC_PUBLIC | ZEND_ACC_CTOR)
     PHP_ME(Collection, name, ai_Collection_name, ZEND_ACC_PUBLIC)
     PHP_ME(Collection, get, ai_Collection_get, ZEND_ACC_PUBLIC)
+    PHP_ME(Collection, getAsync, ai_Collection_getAsync, ZEND_ACC_PUBLIC)
+    PHP_ME(Collection, getMulti, ai_Collection_getMulti, ZEND_ACC_PUBLIC)
     PHP_ME(Collection, exists, ai_Collection_exists, ZEND_ACC_PUBLIC)
+    PHP_ME(Collection, existsMulti, ai_Collection_existsMulti, ZEND_ACC_PUBLIC)
     PHP_ME(Collection, getAndLock, ai_Collection_getAndLock, ZEND_ACC_PUBLIC)
     PHP_ME(Collection, getAndTouch, ai_Collection_getAndTouch, ZEND_ACC_PUBLIC)
     PHP_ME(Collection, getAnyReplica, ai_Collection_getAnyReplica, ZEND_ACC_PUBLIC)
@@ -303,9 +362,15 @@ static zend_function_entry collection_methods[] = {
     PHP_ME(Collection, upsert, ai_Collection_upsert, ZEND_ACC_PUBLIC)
     PHP_ME(Collection, insert, ai_Collection_insert, ZEND_ACC_PUBLIC)
     PHP_ME(Collection, replace, ai_Collection_replace, ZEND_ACC_PUBLIC)
+    PHP_ME(Collection, upsertAsync, ai_Collection_upsertAsync, ZEND_ACC_PUBLIC)
+    PHP_ME(Collection, upsertMulti, ai_Collection_upsertMulti, ZEND_ACC_PUBLIC)
+    PHP_ME(Collection, insertMulti, ai_Collection_insertMulti, ZEND_ACC_PUBLIC)
+    PHP_ME(Collection, replaceMulti, ai_Collection_replaceMulti, ZEND_ACC_PUBLIC)
     PHP_ME(Collection, remove, ai_Collection_remove, ZEND_ACC_PUBLIC)
+    PHP_ME(Collection, removeMulti, ai_Collection_removeMulti, ZEND_ACC_PUBLIC)
     PHP_ME(Collection, unlock, ai_Collection_unlock, ZEND_ACC_PUBLIC)
     PHP_ME(Collection, touch, ai_Collection_touch, ZEND_ACC_PUBLIC)
+    PHP_ME(Collection, touchMulti, ai_Collection_touchMulti, ZEND_ACC_PUBLIC)
     PHP_ME(Collection, lookupIn, ai_Collection_lookupIn, ZEND_ACC_PUBLIC)
     PHP_ME(Collection, mutateIn, ai_Collection_mutateIn, ZEND_ACC_PUBLIC)
     PHP_ME(Collection, binary, ai_Collection_binary, ZEND_ACC_PUBLIC)
@@ -0,0 +1,368 @@
+/**
+ *     Copyright 2019 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "couchbase.h"
+
+#define LOGARGS(instance, lvl) LCB_LOG_##lvl, instance, "pcbc/future", __FILE__, __LINE__
+
+zend_class_entry *pcbc_future_ce;
+
+pcbc_future_t *pcbc_future_init(zval *return_value, pcbc_connection_t *conn, zend_class_entry *result_ce,
+                                lcbtrace_SPAN *span TSRMLS_DC)
+{
+    pcbc_future_t *future;
+
+    object_init_ex(return_value, pcbc_future_ce);
+    future = Z_FUTURE_OBJ_P(return_value);
+    future->rc = PCBC_FUTURE_PENDING;
+    object_init_ex(&future->result, result_ce);
+    future->return_value = &future->result;
+    future->result_ce = result_ce;
+    future->span = span;
+    future->conn = conn;
+    pcbc_connection_addref(conn TSRMLS_CC);
+    return future;
+}
+
+/* makes the future a cookie of the row-based service, the rows are collected into "rows" property of the result */
+void pcbc_future_init_rows(pcbc_future_t *future, pcbc_row_stream_error_fn error TSRMLS_DC)
+{
+    zval rows;
+
+    array_init(&rows);
+    zend_update_property(future->result_ce, &future->result, ZEND_STRL("rows"), &rows TSRMLS_CC);
+    Z_DELREF(rows);
+    future->row.rc = LCB_SUCCESS;
+    future->row.return_value = &future->result;
+    future->row.future = future;
+    future->error = error;
+}
+
+/* records the latency of the future, unless the callback of the KV operation has done it already */
+static void pcbc_future_record(pcbc_future_t *future TSRMLS_DC)
+{
+    if (future->started_at) {
+        pcbc_metrics_record(future->metrics_op, future->started_at, future->rc TSRMLS_CC);
+        future->started_at = 0;
+    }
+}
+
+void pcbc_future_fail(pcbc_future_t *future, lcb_STATUS err TSRMLS_DC)
+{
+    future->rc = err;
+    pcbc_future_record(future TSRMLS_CC);
+    if (future->row.future == NULL) {
+        Z_KV_RESULT_OBJ_P(&future->result)->status = err;
+    }
+}
+
+/* called by the row-based services with the final row */
+void pcbc_future_complete(pcbc_future_t *future, lcb_STATUS err TSRMLS_DC)
+{
+    future->rc = err;
+    pcbc_future_record(future TSRMLS_CC);
+    pcbc_future_notify(future->conn->lcb TSRMLS_CC);
+}
+
+/*
+ * Called by the callbacks, which might complete futures. When Bucket::waitAny() runs the event loop of the instance,
+ * it is interrupted, so that the futures can be checked. The notification is sent only once per lcb_wait().
+ */
+void pcbc_future_notify(lcb_INSTANCE *instance TSRMLS_DC)
+{
+    if (PCBCG(future_wait_instance) == instance) {
+        PCBCG(future_wait_instance) = NULL;
+        lcb_breakout(instance);
+    }
+}
+
+/* throws the error of the completed future, or stores it into "error" instead, if it is not NULL */
+static void pcbc_future_throw_error(pcbc_future_t *future, zval *error TSRMLS_DC)
+{
+    zval *return_value = &future->result; /* throw_lcb_exception() takes the context from the KV result */
+
+    if (future->error) {
+        future->error(&future->result, future->rc TSRMLS_CC);
+    } else {
+        throw_lcb_exception(future->rc, future->result_ce);
+    }
+    if (error && EG(exception)) {
+        ZVAL_OBJ(error, EG(exception));
+        Z_ADDREF_P(error);
+        zend_clear_exception();
+    }
+}
+
+static zend_bool pcbc_future_is_ready(pcbc_future_t *future)
+{
+    if (future->rc == PCBC_FUTURE_PENDING) {
+        return 0;
+    }
+    if (future->span) {
+        lcbtrace_span_finish(future->span, LCBTRACE_NOW);
+        future->span = NULL;
+    }
+    return 1;
+}
+
+static void pcbc_future_wait(pcbc_future_t *future TSRMLS_DC)
+{
+    if (pcbc_future_is_ready(future)) {
+        return;
+    }
+    /* lcb_wait() returns only when all scheduled operations of the instance are completed */
+    lcb_wait(future->conn->lcb, LCB_WAIT_DEFAULT);
+    if (!pcbc_future_is_ready(future)) {
+        pcbc_log(LOGARGS(future->conn->lcb, ERROR), "Future %p has not been completed by the event loop",
+                 (void *)future);
+        pcbc_future_fail(future, LCB_ERR_SDK_INTERNAL TSRMLS_CC);
+    }
+}
+
+PHP_METHOD(Future, __construct)
+{
+    throw_pcbc_exception("Accessing private constructor.", LCB_ERR_INVALID_ARGUMENT);
+}
+
+PHP_METHOD(Future, isReady)
+{
+    if (zend_parse_parameters_none_throw() == FAILURE) {
+        RETURN_NULL();
+    }
+
+    pcbc_future_t *future = Z_FUTURE_OBJ_P(getThis());
+    if (!pcbc_future_is_ready(future)) {
+        lcb_tick_nowait(future->conn->lcb);
+    }
+    RETURN_BOOL(pcbc_future_is_ready(future));
+}
+
+PHP_METHOD(Future, wait)
+{
+    if (zend_parse_parameters_none_throw() == FAILURE) {
+        RETURN_NULL();
+    }
+
+    pcbc_future_t *future = Z_FUTURE_OBJ_P(getThis());
+    pcbc_future_wait(future TSRMLS_CC);
+    if (future->rc != LCB_SUCCESS) {
+        pcbc_future_throw_error(future, NULL TSRMLS_CC);
+        return;
+    }
+    ZVAL_COPY(return_value, &future->result);
+}
+
+static zend_bool pcbc_future_check_all(HashTable *futures)
+{
+    zval *entry;
+    ZEND_HASH_FOREACH_VAL(futures, entry)
+    {
+        if (Z_TYPE_P(entry) != IS_OBJECT || !instanceof_function(Z_OBJCE_P(entry), pcbc_future_ce)) {
+            zend_type_error("Expected array of Couchbase\\Future objects");
+            return 0;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+    return 1;
+}
+
+PHP_METHOD(Bucket, wait)
+{
+    zval *futures, *entry;
+    zend_string *str_key;
+    zend_ulong num_key;
+
+    int rv = zend_parse_parameters_throw(ZEND_NUM_ARGS() TSRMLS_CC, "a", &futures);
+    if (rv == FAILURE) {
+        RETURN_NULL();
+    }
+    if (!pcbc_future_check_all(Z_ARRVAL_P(futures))) {
+        RETURN_NULL();
+    }
+
+    array_init_size(return_value, zend_hash_num_elements(Z_ARRVAL_P(futures)));
+    ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(futures), num_key, str_key, entry)
+    {
+        pcbc_future_t *future = Z_FUTURE_OBJ_P(entry);
+        zend_string *id = str_key ? zend_string_copy(str_key) : zend_long_to_str(num_key);
+        zval result;
+
+        pcbc_future_wait(future TSRMLS_CC);
+        if (future->row.future && future->rc != LCB_SUCCESS) {
+            /* the errors of the queries carry the messages of the service, which are not known to the KV results */
+            ZVAL_UNDEF(&result);
+            pcbc_future_throw_error(future, &result TSRMLS_CC);
+            if (!Z_ISUNDEF(result)) {
+                zend_symtable_update(Z_ARRVAL_P(return_value), id, &result);
+            }
+        } else {
+            ZVAL_COPY(&result, &future->result);
+            pcbc_multi_result_add(return_value, id, &result, future->rc TSRMLS_CC);
+        }
+        zend_string_release(id);
+    }
+    ZEND_HASH_FOREACH_END();
+}
+
+static zend_bool pcbc_future_find_ready(HashTable *futures, zval *key)
+{
+    zval *entry;
+    zend_string *str_key;
+    zend_ulong num_key;
+
+    ZEND_HASH_FOREACH_KEY_VAL(futures, num_key, str_key, entry)
+    {
+        if (pcbc_future_is_ready(Z_FUTURE_OBJ_P(entry))) {
+            if (str_key) {
+                ZVAL_STR_COPY(key, str_key);
+            } else {
+                ZVAL_LONG(key, num_key);
+            }
+            return 1;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+    return 0;
+}
+
+PHP_METHOD(Bucket, waitAny)
+{
+    zval *futures, *entry;
+
+    int rv = zend_parse_parameters_throw(ZEND_NUM_ARGS() TSRMLS_CC, "a", &futures);
+    if (rv == FAILURE) {
+        RETURN_NULL();
+    }
+    if (!pcbc_future_check_all(Z_ARRVAL_P(futures))) {
+        RETURN_NULL();
+    }
+    if (zend_hash_num_elements(Z_ARRVAL_P(futures)) == 0) {
+        RETURN_NULL();
+    }
+
+    /*
+     * Runs the event loop of the instance, which the first pending future belongs to, until any callback of this
+     * instance notifies about completion. The futures of the other instances do not progress meanwhile, so they are
+     * picked up on the next call.
+     */
+    while (!pcbc_future_find_ready(Z_ARRVAL_P(futures), return_value)) {
+        pcbc_future_t *pending = NULL;
+        zend_bool notified;
+
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(futures), entry)
+        {
+            pending = Z_FUTURE_OBJ_P(entry);
+            break;
+        }
+        ZEND_HASH_FOREACH_END();
+
+        PCBCG(future_wait_instance) = pending->conn->lcb;
+        lcb_wait(pending->conn->lcb, LCB_WAIT_DEFAULT);
+        notified = PCBCG(future_wait_instance) == NULL;
+        PCBCG(future_wait_instance) = NULL;
+        if (!notified && !pcbc_future_is_ready(pending)) {
+            /* lcb_wait() has completed all operations of the instance, so the future will not be completed anymore */
+            pcbc_log(LOGARGS(pending->conn->lcb, ERROR), "Future %p has not been completed by the event loop",
+                     (void *)pending);
+            pcbc_future_fail(pending, LCB_ERR_SDK_INTERNAL TSRMLS_CC);
+        }
+    }
+}
+
+ZEND_BEGIN_ARG_INFO_EX(ai_Future_none, 0, 0, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(ai_Future_isReady, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+// clang-format off
+zend_function_entry future_methods[] = {
+    PHP_ME(Future, __construct, ai_Future_none, ZEND_ACC_PRIVATE | ZEND_ACC_FINAL | ZEND_ACC_CTOR)
+    PHP_ME(Future, isReady, ai_Future_isReady, ZEND_ACC_PUBLIC)
+    PHP_ME(Future, wait, ai_Future_none, ZEND_ACC_PUBLIC)
+    PHP_FE_END
+};
+// clang-format on
+
+zend_object_handlers pcbc_future_handlers;
+
+static void pcbc_future_free_object(zend_object *object TSRMLS_DC)
+{
+    pcbc_future_t *obj = Z_FUTURE_OBJ(object);
+
+    if (obj->conn) {
+        /* the future is the cookie of the operation, so it must outlive the response callback */
+        pcbc_future_wait(obj TSRMLS_CC);
+        pcbc_connection_delref(obj->conn TSRMLS_CC);
+        obj->conn = NULL;
+    }
+    zval_ptr_dtor(&obj->result);
+    zend_object_std_dtor(&obj->std TSRMLS_CC);
+}
+
+static zend_object *pcbc_future_create_object(zend_class_entry *class_type TSRMLS_DC)
+{
+    pcbc_future_t *obj = NULL;
+
+    obj = PCBC_ALLOC_OBJECT_T(pcbc_future_t, class_type);
+
+    zend_object_std_init(&obj->std, class_type TSRMLS_CC);
+    object_properties_init(&obj->std, class_type);
+    ZVAL_UNDEF(&obj->result);
+
+    obj->std.handlers = &pcbc_future_handlers;
+    return &obj->std;
+}
+
+static HashTable *pcbc_future_get_debug_info(zval *object, int *is_temp TSRMLS_DC)
+{
+    pcbc_future_t *obj = NULL;
+    zval retval;
+
+    *is_temp = 1;
+    obj = Z_FUTURE_OBJ_P(object);
+
+    array_init(&retval);
+    add_assoc_bool(&retval, "ready", obj->rc != PCBC_FUTURE_PENDING);
+    if (obj->rc != PCBC_FUTURE_PENDING) {
+        add_assoc_long(&retval, "status", obj->rc);
+    }
+
+    return Z_ARRVAL(retval);
+}
+
+PHP_MINIT_FUNCTION(Future)
+{
+    zend_class_entry ce;
+
+    INIT_NS_CLASS_ENTRY(ce, "Couchbase", "Future", future_methods);
+    pcbc_future_ce = zend_register_internal_class(&ce TSRMLS_CC);
+    pcbc_future_ce->create_object = pcbc_future_create_object;
+    pcbc_future_ce->ce_flags |= ZEND_ACC_FINAL;
+    PCBC_CE_DISABLE_SERIALIZATION(pcbc_future_ce);
+
+    memcpy(&pcbc_future_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    pcbc_future_handlers.get_debug_info = pcbc_future_get_debug_info;
+    pcbc_future_handlers.free_obj = pcbc_future_free_object;
+    pcbc_future_handlers.clone_obj = NULL;
+    pcbc_future_handlers.offset = XtOffsetOf(pcbc_future_t, std);
+
+    return SUCCESS;
+}
+
+/*
+ * vim: et ts=4 sw=4 sts=4
+ */
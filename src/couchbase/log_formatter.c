@@ -74,3 +74,72 @@ void pcbc_log_formatter(char *buf, int buf_size, const char *severity, const cha
         snprintf(buf, buf_size, "[cb,%s] (%s L:%d) %s", severity, subsystem, srcline, msg);
     }
 }
+
+/* appends the string as JSON string literal, returns the new position, never writes past the end of the buffer */
+static int pcbc_log_json_string(char *buf, int pos, int buf_size, const char *str)
+{
+    const unsigned char *p = (const unsigned char *)str;
+
+    if (pos > buf_size - 1) {
+        pos = buf_size - 1;
+    }
+    if (pos < buf_size - 1) {
+        buf[pos++] = '"';
+    }
+    for (; *p && pos < buf_size - 7; p++) {
+        switch (*p) {
+        case '"':
+        case '\\':
+            buf[pos++] = '\\';
+            buf[pos++] = *p;
+            break;
+        case '\n':
+            buf[pos++] = '\\';
+            buf[pos++] = 'n';
+            break;
+        case '\t':
+            buf[pos++] = '\\';
+            buf[pos++] = 't';
+            break;
+        default:
+            if (*p < 0x20) {
+                pos += snprintf(buf + pos, buf_size - pos, "\\u%04x", *p);
+            } else {
+                buf[pos++] = *p;
+            }
+        }
+    }
+    if (pos < buf_size - 1) {
+        buf[pos++] = '"';
+    }
+    buf[pos] = '\0';
+    return pos;
+}
+
+void pcbc_log_formatter_json(char *buf, int buf_size, const char *timestamp, const char *severity,
+                             const char *subsystem, int srcline, int instance_id, void *instance_ptr, int is_lcb,
+                             const char *fmt, va_list ap)
+{
+    char msg[PCBC_LOG_MSG_SIZE] = {0};
+    int pos;
+
+    vsnprintf(msg, PCBC_LOG_MSG_SIZE, fmt, ap);
+    msg[PCBC_LOG_MSG_SIZE - 1] = '\0';
+
+    pos = snprintf(buf, buf_size, "{\"time\":\"%s\",\"level\":\"%s\",\"subsys\":", timestamp, severity);
+    pos = pcbc_log_json_string(buf, pos, buf_size, subsystem);
+    if (is_lcb) {
+        pos += snprintf(buf + pos, buf_size - pos, ",\"line\":%d,\"instance\":\"%u\",\"msg\":", srcline,
+                        (unsigned int)instance_id);
+    } else if (instance_ptr) {
+        pos += snprintf(buf + pos, buf_size - pos, ",\"line\":%d,\"instance\":\"%p\",\"msg\":", srcline,
+                        instance_ptr);
+    } else {
+        pos += snprintf(buf + pos, buf_size - pos, ",\"line\":%d,\"msg\":", srcline);
+    }
+    pos = pcbc_log_json_string(buf, pos, buf_size, msg);
+    if (pos < buf_size - 1) {
+        buf[pos++] = '}';
+    }
+    buf[pos] = '\0';
+}
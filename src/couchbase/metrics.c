@@ -0,0 +1,226 @@
+/**
+ *     Copyright 2016-2019 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "couchbase.h"
+
+#define LOGARGS(lvl) LCB_LOG_##lvl, NULL, "pcbc/metrics", __FILE__, __LINE__
+
+#define PCBC_METRICS_SUB_BUCKETS (1 << PCBC_METRICS_PRECISION)
+
+static const char *pcbc_metrics_op_names[PCBC_METRICS_NUM_OPS] = {"get",  "upsert",    "query", "search",
+                                                                  "view", "analytics", "http"};
+static const char *pcbc_metrics_outcome_names[PCBC_METRICS_NUM_OUTCOMES] = {"success", "timeout", "error"};
+
+/*
+ * Values below PCBC_METRICS_SUB_BUCKETS have their own buckets. Larger values are grouped by position of the
+ * leading bit, and each group is split into PCBC_METRICS_SUB_BUCKETS linear buckets, so the relative error stays
+ * within 1/PCBC_METRICS_SUB_BUCKETS like in HDR histogram.
+ */
+static int pcbc_metrics_bucket_index(uint64_t value)
+{
+    int magnitude = PCBC_METRICS_PRECISION;
+
+    if (value < PCBC_METRICS_SUB_BUCKETS) {
+        return (int)value;
+    }
+    while (magnitude < PCBC_METRICS_MAX_MAGNITUDE && (value >> (magnitude + 1)) != 0) {
+        magnitude++;
+    }
+    if ((value >> (magnitude + 1)) != 0) {
+        return PCBC_METRICS_NUM_BUCKETS - 1;
+    }
+    return ((magnitude - PCBC_METRICS_PRECISION + 1) << PCBC_METRICS_PRECISION) +
+           (int)((value >> (magnitude - PCBC_METRICS_PRECISION)) & (PCBC_METRICS_SUB_BUCKETS - 1));
+}
+
+/* the highest value, which falls into the bucket */
+static uint64_t pcbc_metrics_bucket_value(int index)
+{
+    int magnitude;
+    uint64_t sub;
+
+    if (index < PCBC_METRICS_SUB_BUCKETS) {
+        return index;
+    }
+    magnitude = (index >> PCBC_METRICS_PRECISION) + PCBC_METRICS_PRECISION - 1;
+    sub = (index & (PCBC_METRICS_SUB_BUCKETS - 1)) | PCBC_METRICS_SUB_BUCKETS;
+    return ((sub + 1) << (magnitude - PCBC_METRICS_PRECISION)) - 1;
+}
+
+static uint64_t pcbc_metrics_percentile(const pcbc_histogram_t *histogram, int permille)
+{
+    uint64_t rank = (histogram->count * permille + 999) / 1000;
+    uint64_t seen = 0;
+    int i;
+
+    for (i = 0; i < PCBC_METRICS_NUM_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= rank) {
+            uint64_t value = pcbc_metrics_bucket_value(i);
+            return value > histogram->max ? histogram->max : value;
+        }
+    }
+    return histogram->max;
+}
+
+/*
+ * The histograms live in the module globals, so every thread of ZTS build has its own copy, and the counters can be
+ * updated without locks or atomics.
+ */
+void pcbc_metrics_record(pcbc_metrics_op_t op, uint64_t started_at, lcb_STATUS rc TSRMLS_DC)
+{
+    pcbc_histogram_t *histogram;
+    uint64_t now = lcbtrace_now();
+    uint64_t latency = now > started_at ? now - started_at : 0;
+    int outcome;
+
+    switch (rc) {
+    case LCB_SUCCESS:
+        outcome = 0;
+        break;
+    case LCB_ERR_TIMEOUT:
+    case LCB_ERR_AMBIGUOUS_TIMEOUT:
+    case LCB_ERR_UNAMBIGUOUS_TIMEOUT:
+        outcome = 1;
+        break;
+    default:
+        outcome = 2;
+        break;
+    }
+
+    histogram = &PCBCG(metrics)[op][outcome];
+    if (histogram->count == 0 || latency < histogram->min) {
+        histogram->min = latency;
+    }
+    if (latency > histogram->max) {
+        histogram->max = latency;
+    }
+    histogram->count++;
+    histogram->sum += latency;
+    histogram->buckets[pcbc_metrics_bucket_index(latency)]++;
+}
+
+void pcbc_metrics_log(TSRMLS_D)
+{
+    int op, outcome;
+
+    for (op = 0; op < PCBC_METRICS_NUM_OPS; op++) {
+        for (outcome = 0; outcome < PCBC_METRICS_NUM_OUTCOMES; outcome++) {
+            const pcbc_histogram_t *histogram = &PCBCG(metrics)[op][outcome];
+            if (histogram->count == 0) {
+                continue;
+            }
+            pcbc_log(LOGARGS(INFO),
+                     "%s/%s: count=%llu, min=%lluus, p50=%lluus, p90=%lluus, p99=%lluus, p999=%lluus, max=%lluus",
+                     pcbc_metrics_op_names[op], pcbc_metrics_outcome_names[outcome],
+                     (unsigned long long)histogram->count, (unsigned long long)histogram->min,
+                     (unsigned long long)pcbc_metrics_percentile(histogram, 500),
+                     (unsigned long long)pcbc_metrics_percentile(histogram, 900),
+                     (unsigned long long)pcbc_metrics_percentile(histogram, 990),
+                     (unsigned long long)pcbc_metrics_percentile(histogram, 999), (unsigned long long)histogram->max);
+        }
+    }
+}
+
+zend_class_entry *pcbc_metrics_ce;
+
+PHP_METHOD(Metrics, __construct)
+{
+    throw_pcbc_exception("Accessing private constructor.", LCB_ERR_INVALID_ARGUMENT);
+}
+
+PHP_METHOD(Metrics, snapshot)
+{
+    zend_bool reset = 0;
+    int op, outcome;
+
+    if (zend_parse_parameters_throw(ZEND_NUM_ARGS(), "|b", &reset) == FAILURE) {
+        return;
+    }
+
+    array_init(return_value);
+    for (op = 0; op < PCBC_METRICS_NUM_OPS; op++) {
+        zval outcomes;
+        array_init(&outcomes);
+        for (outcome = 0; outcome < PCBC_METRICS_NUM_OUTCOMES; outcome++) {
+            const pcbc_histogram_t *histogram = &PCBCG(metrics)[op][outcome];
+            zval entry;
+            if (histogram->count == 0) {
+                continue;
+            }
+            array_init(&entry);
+            add_assoc_long(&entry, "count", histogram->count);
+            add_assoc_long(&entry, "min_us", histogram->min);
+            add_assoc_long(&entry, "mean_us", histogram->sum / histogram->count);
+            add_assoc_long(&entry, "p50_us", pcbc_metrics_percentile(histogram, 500));
+            add_assoc_long(&entry, "p90_us", pcbc_metrics_percentile(histogram, 900));
+            add_assoc_long(&entry, "p99_us", pcbc_metrics_percentile(histogram, 990));
+            add_assoc_long(&entry, "p999_us", pcbc_metrics_percentile(histogram, 999));
+            add_assoc_long(&entry, "max_us", histogram->max);
+            add_assoc_zval(&outcomes, pcbc_metrics_outcome_names[outcome], &entry);
+        }
+        add_assoc_zval(return_value, pcbc_metrics_op_names[op], &outcomes);
+    }
+    {
+        zval compression;
+        array_init(&compression);
+        add_assoc_long(&compression, "attempts", PCBCG(cmpr_attempts));
+        add_assoc_long(&compression, "compressed", PCBCG(cmpr_compressed));
+        add_assoc_long(&compression, "rejected", PCBCG(cmpr_rejected));
+        add_assoc_long(&compression, "skipped", PCBCG(cmpr_skipped));
+        add_assoc_long(&compression, "bytes_in", PCBCG(cmpr_bytes_in));
+        add_assoc_long(&compression, "bytes_out", PCBCG(cmpr_bytes_out));
+        add_assoc_zval(return_value, "compression", &compression);
+    }
+    if (reset) {
+        memset(PCBCG(metrics), 0, sizeof(PCBCG(metrics)));
+        PCBCG(cmpr_attempts) = 0;
+        PCBCG(cmpr_compressed) = 0;
+        PCBCG(cmpr_rejected) = 0;
+        PCBCG(cmpr_skipped) = 0;
+        PCBCG(cmpr_bytes_in) = 0;
+        PCBCG(cmpr_bytes_out) = 0;
+    }
+}
+
+ZEND_BEGIN_ARG_INFO_EX(ai_Metrics_none, 0, 0, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(ai_Metrics_snapshot, 0, 0, 0)
+ZEND_ARG_INFO(0, reset)
+ZEND_END_ARG_INFO()
+
+// clang-format off
+zend_function_entry metrics_methods[] = {
+    PHP_ME(Metrics, __construct, ai_Metrics_none, ZEND_ACC_PRIVATE | ZEND_ACC_FINAL | ZEND_ACC_CTOR)
+    PHP_ME(Metrics, snapshot, ai_Metrics_snapshot, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_FE_END
+};
+// clang-format on
+
+PHP_MINIT_FUNCTION(Metrics)
+{
+    zend_class_entry ce;
+
+    INIT_NS_CLASS_ENTRY(ce, "Couchbase", "Metrics", metrics_methods);
+    pcbc_metrics_ce = zend_register_internal_class(&ce TSRMLS_CC);
+    pcbc_metrics_ce->ce_flags |= ZEND_ACC_FINAL;
+    return SUCCESS;
+}
+
+/*
+ * vim: et ts=4 sw=4 sts=4
+ */
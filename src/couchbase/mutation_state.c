@@ -20,12 +20,120 @@
 #define LOGARGS(lvl) LCB_LOG_##lvl, NULL, "pcbc/mutation_state", __FILE__, __LINE__
 
 extern zend_class_entry *pcbc_mutation_result_ce;
-extern zend_class_entry *pcbc_mutation_token_legacy_ce;
+extern zend_class_entry *pcbc_mutation_token_ce;
+extern zend_class_entry *pcbc_mutation_token_impl_ce;
+extern zend_object_handlers pcbc_kv_result_handlers;
+extern zend_object_handlers pcbc_mutation_token_handlers;
 zend_class_entry *pcbc_mutation_state_ce;
 
+typedef struct {
+    uint64_t partition_uuid;
+    uint64_t sequence_number;
+} pcbc_partition_position_t;
+
+/*
+ * Only the highest sequence number of every partition matters for the scan vectors, so instead of the tokens the state
+ * keeps a table "bucket name" => ("partition id" => position). Its size depends on the number of touched partitions
+ * (at most PCBC_MAX_PARTITIONS per bucket), and not on the number of added mutations.
+ */
+typedef struct {
+    HashTable buckets;
+    zend_object std;
+} pcbc_mutation_state_t;
+
+static inline pcbc_mutation_state_t *pcbc_mutation_state_fetch_object(zend_object *obj)
+{
+    return (pcbc_mutation_state_t *)((char *)obj - XtOffsetOf(pcbc_mutation_state_t, std));
+}
+#define Z_MUTATION_STATE_OBJ(zo) (pcbc_mutation_state_fetch_object(zo))
+#define Z_MUTATION_STATE_OBJ_P(zv) (pcbc_mutation_state_fetch_object(Z_OBJ_P(zv)))
+
+static void pcbc_partition_position_dtor(zval *zv)
+{
+    efree(Z_PTR_P(zv));
+}
+
+static void pcbc_partition_table_dtor(zval *zv)
+{
+    HashTable *partitions = Z_PTR_P(zv);
+    zend_hash_destroy(partitions);
+    FREE_HASHTABLE(partitions);
+}
+
+static void pcbc_mutation_state_update(pcbc_mutation_state_t *state, zend_string *bucket, zend_long partition_id,
+                                       uint64_t partition_uuid, uint64_t sequence_number)
+{
+    HashTable *partitions;
+    pcbc_partition_position_t *position;
+
+    if (partition_id < 0 || partition_id >= PCBC_MAX_PARTITIONS) {
+        pcbc_log(LOGARGS(WARN), "Ignore mutation token with invalid partition ID: %d", (int)partition_id);
+        return;
+    }
+
+    partitions = zend_hash_find_ptr(&state->buckets, bucket);
+    if (partitions == NULL) {
+        ALLOC_HASHTABLE(partitions);
+        zend_hash_init(partitions, 0, NULL, pcbc_partition_position_dtor, 0);
+        zend_hash_add_new_ptr(&state->buckets, bucket, partitions);
+    }
+
+    position = zend_hash_index_find_ptr(partitions, partition_id);
+    if (position == NULL) {
+        position = emalloc(sizeof(pcbc_partition_position_t));
+        zend_hash_index_add_new_ptr(partitions, partition_id, position);
+    } else if (position->partition_uuid == partition_uuid && position->sequence_number >= sequence_number) {
+        /* sequence numbers are comparable only within the same history of the partition, after failover (new UUID)
+         * the position of the added token always replaces the old one */
+        return;
+    }
+    position->partition_uuid = partition_uuid;
+    position->sequence_number = sequence_number;
+}
+
+static zend_bool pcbc_mutation_state_call(zval *token, const char *name, zval *retval TSRMLS_DC)
+{
+    zval fname;
+    int rv;
+
+    PCBC_STRING(fname, name);
+    rv = call_user_function_ex(EG(function_table), token, &fname, retval, 0, NULL, 1, NULL TSRMLS_CC);
+    zval_ptr_dtor(&fname);
+    if (rv == FAILURE || EG(exception) || Z_ISUNDEF_P(retval)) {
+        return 0;
+    }
+    return 1;
+}
+
+/* tokens of the other MutationToken implementations are read through their getters */
+static void pcbc_mutation_state_add_token(pcbc_mutation_state_t *state, zval *token TSRMLS_DC)
+{
+    zval bucket, partition_id, partition_uuid, sequence_number;
+    uint64_t uuid = 0, seqno = 0;
+
+    ZVAL_UNDEF(&bucket);
+    ZVAL_UNDEF(&partition_id);
+    ZVAL_UNDEF(&partition_uuid);
+    ZVAL_UNDEF(&sequence_number);
+    if (pcbc_mutation_state_call(token, "bucketName", &bucket TSRMLS_CC) && Z_TYPE(bucket) == IS_STRING &&
+        pcbc_mutation_state_call(token, "partitionId", &partition_id TSRMLS_CC) && Z_TYPE(partition_id) == IS_LONG &&
+        pcbc_mutation_state_call(token, "partitionUuid", &partition_uuid TSRMLS_CC) &&
+        Z_TYPE(partition_uuid) == IS_STRING && pcbc_cas_decode(Z_STR(partition_uuid), &uuid) &&
+        pcbc_mutation_state_call(token, "sequenceNumber", &sequence_number TSRMLS_CC) &&
+        Z_TYPE(sequence_number) == IS_STRING && pcbc_cas_decode(Z_STR(sequence_number), &seqno)) {
+        pcbc_mutation_state_update(state, Z_STR(bucket), Z_LVAL(partition_id), uuid, seqno);
+    }
+    zval_ptr_dtor(&bucket);
+    zval_ptr_dtor(&partition_id);
+    zval_ptr_dtor(&partition_uuid);
+    zval_ptr_dtor(&sequence_number);
+}
+
 PHP_METHOD(MutationState, add)
 {
     zval *source;
+    zval *token;
+    zval retval;
     int rv;
 
     rv = zend_parse_parameters_throw(ZEND_NUM_ARGS() TSRMLS_CC, "O", &source, pcbc_mutation_result_ce);
@@ -33,144 +141,107 @@ PHP_METHOD(MutationState, add)
         RETURN_NULL();
     }
 
-    zval fname;
-    zval retval;
-    PCBC_STRING(fname, "mutationToken");
-    rv = call_user_function_ex(EG(function_table), source, &fname, &retval, 0, NULL, 1, NULL TSRMLS_CC);
-    if (rv == FAILURE || EG(exception) || Z_ISUNDEF(retval)) {
-        RETURN_NULL();
+    ZVAL_UNDEF(&retval);
+    if (Z_OBJ_P(source)->handlers == &pcbc_kv_result_handlers) {
+        token = &Z_KV_RESULT_OBJ_P(source)->mutation_token;
+    } else {
+        zval fname;
+        PCBC_STRING(fname, "mutationToken");
+        rv = call_user_function_ex(EG(function_table), source, &fname, &retval, 0, NULL, 1, NULL TSRMLS_CC);
+        zval_ptr_dtor(&fname);
+        if (rv == FAILURE || EG(exception) || Z_ISUNDEF(retval)) {
+            RETURN_NULL();
+        }
+        token = &retval;
     }
 
-    zval *tokens, rv1;
-    tokens = zend_read_property(pcbc_mutation_state_ce, getThis(), ZEND_STRL("tokens"), 0, &rv1);
-    if (Z_TYPE_P(tokens) == IS_NULL) {
-        array_init(&rv1);
-        tokens = &rv1;
-        zend_update_property(pcbc_mutation_state_ce, getThis(), ZEND_STRL("tokens"), tokens TSRMLS_CC);
-        Z_DELREF_P(tokens);
+    if (Z_TYPE_P(token) == IS_OBJECT) {
+        pcbc_mutation_state_t *state = Z_MUTATION_STATE_OBJ_P(getThis());
+        if (Z_OBJ_P(token)->handlers == &pcbc_mutation_token_handlers) {
+            pcbc_mutation_token_t *obj = Z_MUTATION_TOKEN_OBJ_P(token);
+            if (obj->bucket_name) {
+                pcbc_mutation_state_update(state, obj->bucket_name, obj->partition_id, obj->partition_uuid,
+                                           obj->sequence_number);
+            }
+        } else if (instanceof_function(Z_OBJCE_P(token), pcbc_mutation_token_ce TSRMLS_CC)) {
+            pcbc_mutation_state_add_token(state, token TSRMLS_CC);
+        }
     }
-    add_next_index_zval(tokens, &retval);
-    Z_TRY_ADDREF(retval);
+    zval_ptr_dtor(&retval);
     RETURN_ZVAL(getThis(), 1, 0);
 }
 
-void pcbc_mutation_state_export_for_n1ql(zval *mutation_state, zval *scan_vectors TSRMLS_DC)
+/* {"bucket":{"partition id":[sequence number,"partition uuid"],...},...} */
+void pcbc_mutation_state_export_for_n1ql(zval *mutation_state, smart_str *scan_vectors TSRMLS_DC)
 {
-    array_init(scan_vectors);
+    pcbc_mutation_state_t *state = Z_MUTATION_STATE_OBJ_P(mutation_state);
+    zend_string *bucket;
+    HashTable *partitions;
+    zend_bool first_bucket = 1;
 
-    zval *tokens, rv1;
-    zval fname;
-    tokens = zend_read_property(pcbc_mutation_state_ce, mutation_state, ZEND_STRL("tokens"), 0, &rv1);
-    if (Z_TYPE_P(tokens) == IS_ARRAY) {
-        HashTable *ht = HASH_OF(tokens);
-        zval *token;
-        ZEND_HASH_FOREACH_VAL(ht, token)
-        {
-            zval bucket;
-            PCBC_STRING(fname, "bucketName");
-            call_user_function_ex(EG(function_table), token, &fname, &bucket, 0, NULL, 1, NULL TSRMLS_CC);
-
-            zval new_group;
-            zval *bucket_group = zend_symtable_str_find(Z_ARRVAL_P(scan_vectors), Z_STRVAL(bucket), Z_STRLEN(bucket));
-            if (!bucket_group) {
-                array_init(&new_group);
-                add_assoc_zval_ex(scan_vectors, Z_STRVAL(bucket), Z_STRLEN(bucket), &new_group);
-                bucket_group = &new_group;
-            }
-
-            zval pair;
-            array_init_size(&pair, 2);
+    smart_str_appendc(scan_vectors, '{');
+    ZEND_HASH_FOREACH_STR_KEY_PTR(&state->buckets, bucket, partitions)
+    {
+        zend_ulong partition_id;
+        pcbc_partition_position_t *position;
+        zend_bool first_partition = 1;
+        zval name;
+        int last_error;
 
-            zend_string *decoded;
-
-            zval seqno;
-            PCBC_STRING(fname, "sequenceNumber");
-            call_user_function_ex(EG(function_table), token, &fname, &seqno, 0, NULL, 1, NULL TSRMLS_CC);
-            decoded = php_base64_decode_str(Z_STR(seqno));
-            if (decoded) {
-                if (ZSTR_LEN(decoded) == sizeof(uint64_t)) {
-                    uint64_t num = 0;
-                    memcpy(&num, ZSTR_VAL(decoded), ZSTR_LEN(decoded));
-                    add_next_index_long(&pair, num);
-                }
-                zend_string_free(decoded);
-            }
+        if (!first_bucket) {
+            smart_str_appendc(scan_vectors, ',');
+        }
+        first_bucket = 0;
+        ZVAL_STR(&name, bucket);
+        PCBC_JSON_ENCODE(scan_vectors, &name, 0, last_error);
+        if (last_error != 0) {
+            pcbc_log(LOGARGS(WARN), "Failed to encode bucket name of mutation state as JSON: json_last_error=%d",
+                     last_error);
+        }
+        smart_str_appendl(scan_vectors, ":{", 2);
+        ZEND_HASH_FOREACH_NUM_KEY_PTR(partitions, partition_id, position)
+        {
+            char buf[64] = {0};
+            int buf_len;
 
-            char buf[22] = {0};
-
-            zval vb_uuid;
-            PCBC_STRING(fname, "partitionUuid");
-            call_user_function_ex(EG(function_table), token, &fname, &vb_uuid, 0, NULL, 1, NULL TSRMLS_CC);
-            decoded = php_base64_decode_str(Z_STR(vb_uuid));
-            if (decoded) {
-                if (ZSTR_LEN(decoded) == sizeof(uint64_t)) {
-                    uint64_t num = 0;
-                    memcpy(&num, ZSTR_VAL(decoded), ZSTR_LEN(decoded));
-                    snprintf(buf, 21, "%llu", (unsigned long long)num);
-                    add_next_index_string(&pair, buf);
-                }
-                zend_string_free(decoded);
+            if (!first_partition) {
+                smart_str_appendc(scan_vectors, ',');
             }
-
-            zval vb_id;
-            PCBC_STRING(fname, "partitionId");
-            call_user_function_ex(EG(function_table), token, &fname, &vb_id, 0, NULL, 1, NULL TSRMLS_CC);
-
-            snprintf(buf, 21, "%d", (int)Z_LVAL(vb_id));
-            zend_hash_str_update(Z_ARRVAL_P(bucket_group), buf, strlen(buf), &pair TSRMLS_CC);
+            first_partition = 0;
+            buf_len = snprintf(buf, sizeof(buf), "\"%d\":[%llu,\"%llu\"]", (int)partition_id,
+                               (unsigned long long)position->sequence_number,
+                               (unsigned long long)position->partition_uuid);
+            smart_str_appendl(scan_vectors, buf, buf_len);
         }
         ZEND_HASH_FOREACH_END();
+        smart_str_appendc(scan_vectors, '}');
     }
+    ZEND_HASH_FOREACH_END();
+    smart_str_appendc(scan_vectors, '}');
 }
 
+/* {"partition id/partition uuid":sequence number,...}, the search service does not need the bucket name */
 void pcbc_mutation_state_export_for_search(zval *mutation_state, zval *scan_vectors TSRMLS_DC)
 {
+    pcbc_mutation_state_t *state = Z_MUTATION_STATE_OBJ_P(mutation_state);
+    HashTable *partitions;
+
     array_init(scan_vectors);
+    ZEND_HASH_FOREACH_PTR(&state->buckets, partitions)
+    {
+        zend_ulong partition_id;
+        pcbc_partition_position_t *position;
 
-    zval *tokens, rv1;
-    zval fname;
-    tokens = zend_read_property(pcbc_mutation_state_ce, mutation_state, ZEND_STRL("tokens"), 0, &rv1);
-    if (Z_TYPE_P(tokens) == IS_ARRAY) {
-        HashTable *ht = HASH_OF(tokens);
-        zval *token;
-        ZEND_HASH_FOREACH_VAL(ht, token)
+        ZEND_HASH_FOREACH_NUM_KEY_PTR(partitions, partition_id, position)
         {
-            zend_string *decoded;
-
             char token_key[50] = {0};
-
-            zval vb_id;
-            PCBC_STRING(fname, "partitionId");
-            call_user_function_ex(EG(function_table), token, &fname, &vb_id, 0, NULL, 1, NULL TSRMLS_CC);
-
-            zval vb_uuid;
-            PCBC_STRING(fname, "partitionUuid");
-            call_user_function_ex(EG(function_table), token, &fname, &vb_uuid, 0, NULL, 1, NULL TSRMLS_CC);
-            decoded = php_base64_decode_str(Z_STR(vb_uuid));
-            if (decoded) {
-                if (ZSTR_LEN(decoded) == sizeof(uint64_t)) {
-                    uint64_t num = 0;
-                    memcpy(&num, ZSTR_VAL(decoded), ZSTR_LEN(decoded));
-                    snprintf(token_key, 49, "%d/%llu", (int)Z_LVAL(vb_id), (unsigned long long)num);
-                }
-                zend_string_free(decoded);
-            }
-
-            zval seqno;
-            PCBC_STRING(fname, "sequenceNumber");
-            call_user_function_ex(EG(function_table), token, &fname, &seqno, 0, NULL, 1, NULL TSRMLS_CC);
-            decoded = php_base64_decode_str(Z_STR(seqno));
-            if (decoded) {
-                if (ZSTR_LEN(decoded) == sizeof(uint64_t)) {
-                    uint64_t num = 0;
-                    memcpy(&num, ZSTR_VAL(decoded), ZSTR_LEN(decoded));
-                    add_assoc_long_ex(scan_vectors, token_key, strlen(token_key), (zend_long)num);
-                }
-                zend_string_free(decoded);
-            }
+            int token_key_len = snprintf(token_key, sizeof(token_key), "%d/%llu", (int)partition_id,
+                                         (unsigned long long)position->partition_uuid);
+            add_assoc_long_ex(scan_vectors, token_key, token_key_len, (zend_long)position->sequence_number);
         }
         ZEND_HASH_FOREACH_END();
     }
+    ZEND_HASH_FOREACH_END();
 }
 
 PHP_METHOD(MutationState, __construct) {}
@@ -190,13 +261,77 @@ zend_function_entry mutation_state_methods[] = {
 };
 // clang-format on
 
+zend_object_handlers pcbc_mutation_state_handlers;
+
+static void pcbc_mutation_state_free_object(zend_object *object TSRMLS_DC)
+{
+    pcbc_mutation_state_t *obj = Z_MUTATION_STATE_OBJ(object);
+
+    zend_hash_destroy(&obj->buckets);
+    zend_object_std_dtor(&obj->std TSRMLS_CC);
+}
+
+static zend_object *pcbc_mutation_state_create_object(zend_class_entry *class_type TSRMLS_DC)
+{
+    pcbc_mutation_state_t *obj = NULL;
+
+    obj = PCBC_ALLOC_OBJECT_T(pcbc_mutation_state_t, class_type);
+
+    zend_object_std_init(&obj->std, class_type TSRMLS_CC);
+    object_properties_init(&obj->std, class_type);
+    zend_hash_init(&obj->buckets, 0, NULL, pcbc_partition_table_dtor, 0);
+
+    obj->std.handlers = &pcbc_mutation_state_handlers;
+    return &obj->std;
+}
+
+static HashTable *pcbc_mutation_state_get_debug_info(zval *object, int *is_temp TSRMLS_DC)
+{
+    pcbc_mutation_state_t *obj = NULL;
+    zend_string *bucket;
+    HashTable *partitions;
+    zval retval;
+
+    *is_temp = 1;
+    obj = Z_MUTATION_STATE_OBJ_P(object);
+
+    array_init(&retval);
+    ZEND_HASH_FOREACH_STR_KEY_PTR(&obj->buckets, bucket, partitions)
+    {
+        zend_ulong partition_id;
+        pcbc_partition_position_t *position;
+        zval group;
+
+        array_init_size(&group, zend_hash_num_elements(partitions));
+        ZEND_HASH_FOREACH_NUM_KEY_PTR(partitions, partition_id, position)
+        {
+            zval pair;
+            array_init_size(&pair, 2);
+            add_next_index_str(&pair, pcbc_cas_encode(position->sequence_number));
+            add_next_index_str(&pair, pcbc_cas_encode(position->partition_uuid));
+            add_index_zval(&group, partition_id, &pair);
+        }
+        ZEND_HASH_FOREACH_END();
+        add_assoc_zval_ex(&retval, ZSTR_VAL(bucket), ZSTR_LEN(bucket), &group);
+    }
+    ZEND_HASH_FOREACH_END();
+
+    return Z_ARRVAL(retval);
+}
+
 PHP_MINIT_FUNCTION(MutationState)
 {
     zend_class_entry ce;
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "MutationState", mutation_state_methods);
     pcbc_mutation_state_ce = zend_register_internal_class(&ce TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutation_state_ce, ZEND_STRL("tokens"), ZEND_ACC_PRIVATE TSRMLS_CC);
+    pcbc_mutation_state_ce->create_object = pcbc_mutation_state_create_object;
+
+    memcpy(&pcbc_mutation_state_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    pcbc_mutation_state_handlers.get_debug_info = pcbc_mutation_state_get_debug_info;
+    pcbc_mutation_state_handlers.free_obj = pcbc_mutation_state_free_object;
+    pcbc_mutation_state_handlers.clone_obj = NULL;
+    pcbc_mutation_state_handlers.offset = XtOffsetOf(pcbc_mutation_state_t, std);
 
     return SUCCESS;
 }
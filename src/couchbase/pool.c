@@ -16,6 +16,8 @@
 
 #include "couchbase.h"
 #include <ext/standard/url.h>
+#include <ext/standard/php_rand.h>
+#include <main/SAPI.h>
 
 static int pcbc_res_couchbase;
 
@@ -44,8 +46,67 @@ void http_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPHTTP *rb);
 void ping_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPPING *rb);
 void diag_callback(lcb_INSTANCE *instance, int cbtype, const lcb_RESPDIAG *rb);
 
+static void open_callback(lcb_INSTANCE *instance, lcb_STATUS err)
+{
+    PCBCG(pool_open_status) = err;
+}
+
+/* checks whether the query part of the connection string has the option with the given name */
+static zend_bool pcbc_connstr_has_option(const char *connstr, const char *name)
+{
+    const char *option = strchr(connstr, '?');
+    size_t name_len = strlen(name);
+
+    while (option) {
+        const char *end;
+
+        option++;
+        end = option + strcspn(option, "&=");
+        if ((size_t)(end - option) == name_len && strncmp(option, name, name_len) == 0) {
+            return 1;
+        }
+        option = strchr(option, '&');
+    }
+    return 0;
+}
+
+/*
+ * Snappy datatype compression is negotiated with the server, so the values stay compressed on the wire and at rest,
+ * and are readable by every SDK. The options given in the connection string win over INI settings.
+ */
+static void pcbc_configure_compression(lcb_INSTANCE *conn, const char *connstr TSRMLS_DC)
+{
+    lcb_STATUS err;
+
+    if (PCBCG(snappy_mode) != LCB_COMPRESS_INOUT && !pcbc_connstr_has_option(connstr, "compression")) {
+        int mode = PCBCG(snappy_mode);
+        err = lcb_cntl(conn, LCB_CNTL_SET, LCB_CNTL_COMPRESSION_OPTS, &mode);
+        if (err != LCB_SUCCESS) {
+            pcbc_log(LOGARGS(conn, WARN), "Failed to configure compression mode: %s", lcb_strerror_short(err));
+        }
+    }
+    if (PCBCG(snappy_min_size) >= 0 && !pcbc_connstr_has_option(connstr, "compression_min_size")) {
+        lcb_U32 min_size = (lcb_U32)PCBCG(snappy_min_size);
+        err = lcb_cntl(conn, LCB_CNTL_SET, LCB_CNTL_COMPRESSION_MIN_SIZE, &min_size);
+        if (err != LCB_SUCCESS) {
+            pcbc_log(LOGARGS(conn, WARN), "Failed to configure compression min size: %s", lcb_strerror_short(err));
+        }
+    }
+    if (PCBCG(snappy_min_ratio) > 0 && !pcbc_connstr_has_option(connstr, "compression_min_ratio")) {
+        float min_ratio = (float)PCBCG(snappy_min_ratio);
+        err = lcb_cntl(conn, LCB_CNTL_SET, LCB_CNTL_COMPRESSION_MIN_RATIO, &min_ratio);
+        if (err != LCB_SUCCESS) {
+            pcbc_log(LOGARGS(conn, WARN), "Failed to configure compression min ratio: %s", lcb_strerror_short(err));
+        }
+    }
+}
+
+/* flags of pcbc_connection_acquire() */
+#define PCBC_ACQUIRE_EXCLUSIVE 0x01 /* skip the connections, which are held by other objects */
+#define PCBC_ACQUIRE_NO_WAIT 0x02   /* return new connection right after lcb_connect(), see pcbc_connection_prewarm() */
+
 static lcb_STATUS pcbc_establish_connection(lcb_INSTANCE_TYPE type, lcb_INSTANCE **result, const char *connstr,
-                                            const char *username, const char *password TSRMLS_DC)
+                                            const char *username, const char *password, zend_bool wait TSRMLS_DC)
 {
     lcb_LOGGER *logger = NULL;
     lcb_logger_create(&logger, &pcbc_logger);
@@ -74,6 +135,7 @@ static lcb_STATUS pcbc_establish_connection(lcb_INSTANCE_TYPE type, lcb_INSTANCE
         lcb_logger_destroy(logger);
         return err;
     }
+    pcbc_configure_compression(conn, connstr TSRMLS_CC);
 
     lcb_install_callback(conn, LCB_CALLBACK_GET, (lcb_RESPCALLBACK)get_callback);
     lcb_install_callback(conn, LCB_CALLBACK_GETREPLICA, (lcb_RESPCALLBACK)getreplica_callback);
@@ -89,6 +151,7 @@ static lcb_STATUS pcbc_establish_connection(lcb_INSTANCE_TYPE type, lcb_INSTANCE
     lcb_install_callback(conn, LCB_CALLBACK_HTTP, (lcb_RESPCALLBACK)http_callback);
     lcb_install_callback(conn, LCB_CALLBACK_PING, (lcb_RESPCALLBACK)ping_callback);
     lcb_install_callback(conn, LCB_CALLBACK_DIAG, (lcb_RESPCALLBACK)diag_callback);
+    lcb_set_open_callback(conn, open_callback);
 
     err = lcb_connect(conn);
     if (err != LCB_SUCCESS) {
@@ -97,6 +160,10 @@ static lcb_STATUS pcbc_establish_connection(lcb_INSTANCE_TYPE type, lcb_INSTANCE
         lcb_logger_destroy(logger);
         return err;
     }
+    if (!wait) {
+        *result = conn;
+        return LCB_SUCCESS;
+    }
     // We use lcb_wait here as no callbacks are invoked by connect.
     lcb_wait(conn, LCB_WAIT_DEFAULT);
     err = lcb_get_bootstrap_status(conn);
@@ -238,14 +305,36 @@ static lcb_STATUS pcbc_normalize_connstr(lcb_INSTANCE_TYPE type, char *connstr,
     return LCB_SUCCESS;
 }
 
+static void pcbc_connection_idle_unlink(pcbc_connection_t *conn TSRMLS_DC)
+{
+    if (conn->idle_prev) {
+        conn->idle_prev->idle_next = conn->idle_next;
+    } else {
+        PCBCG(pool_idle_head) = conn->idle_next;
+    }
+    if (conn->idle_next) {
+        conn->idle_next->idle_prev = conn->idle_prev;
+    } else {
+        PCBCG(pool_idle_tail) = conn->idle_prev;
+    }
+    conn->idle_prev = NULL;
+    conn->idle_next = NULL;
+    conn->idle_at = 0;
+    PCBCG(pool_idle)--;
+}
+
 void pcbc_connection_addref(pcbc_connection_t *conn TSRMLS_DC)
 {
     if (conn) {
         conn->refs++;
-        conn->idle_at = 0;
+        if (conn->idle_at) {
+            pcbc_connection_idle_unlink(conn TSRMLS_CC);
+        }
     }
 }
 
+static void pcbc_connection_destroy(pcbc_connection_t *conn TSRMLS_DC);
+
 void pcbc_connection_delref(pcbc_connection_t *conn TSRMLS_DC)
 {
     if (conn) {
@@ -253,8 +342,23 @@ void pcbc_connection_delref(pcbc_connection_t *conn TSRMLS_DC)
         pcbc_log(LOGARGS(conn->lcb, DEBUG),
                  "cachedel: type=%d, connstr=%s, bucketname=%s, username=%s, lcb=%p, refs=%d", conn->type,
                  conn->connstr, conn->bucketname, conn->username, conn->lcb, conn->refs);
-        if (conn->refs == 0) {
+        if (conn->refs == 0 && conn->plist_key == NULL) {
+            /* the connection was created while all pooled instances were busy, and nobody will reuse it */
+            pcbc_connection_destroy(conn TSRMLS_CC);
+            return;
+        }
+        if (conn->refs == 0 && conn->idle_at == 0) {
+            /* time only moves forward, so appending to the tail keeps the list ordered */
             conn->idle_at = time(NULL);
+            conn->idle_prev = PCBCG(pool_idle_tail);
+            conn->idle_next = NULL;
+            if (PCBCG(pool_idle_tail)) {
+                PCBCG(pool_idle_tail)->idle_next = conn;
+            } else {
+                PCBCG(pool_idle_head) = conn;
+            }
+            PCBCG(pool_idle_tail) = conn;
+            PCBCG(pool_idle)++;
         }
     }
 }
@@ -262,7 +366,8 @@ void pcbc_connection_delref(pcbc_connection_t *conn TSRMLS_DC)
 static zend_resource *pcbc_connection_lookup(smart_str *plist_key TSRMLS_DC)
 {
     zend_resource *res;
-    res = zend_hash_find_ptr(&EG(persistent_list), plist_key->s);
+    /* the key is reused for several slots, so do not let the hash be cached in the zend_string */
+    res = zend_hash_str_find_ptr(&EG(persistent_list), PCBC_SMARTSTR_VAL(*plist_key), PCBC_SMARTSTR_LEN(*plist_key));
     if (res != NULL && res->type == pcbc_res_couchbase) {
         return res;
     }
@@ -285,6 +390,8 @@ static lcb_STATUS pcbc_connection_cache(smart_str *plist_key, pcbc_connection_t
         pcbc_log(LOGARGS(NULL, ERROR), "failed to register persistent connection");
         return LCB_ERR_INVALID_ARGUMENT;
     }
+    conn->plist_key = zend_string_init(PCBC_SMARTSTR_VAL(*plist_key), PCBC_SMARTSTR_LEN(*plist_key), 1);
+    PCBCG(pool_live)++;
     pcbc_log(LOGARGS(conn->lcb, DEBUG),
              "cachenew: ptr=%p, type=%d, connstr=%s, bucketname=%s, username=%s, lcb=%p, refs=%d", conn, conn->type,
              conn->connstr, conn->bucketname, conn->username, conn->lcb, conn->refs);
@@ -296,6 +403,14 @@ static void pcbc_destroy_connection_resource(zend_resource *res)
     if (res->ptr) {
         pcbc_connection_t *conn = res->ptr;
         pcbc_log(LOGARGS(NULL, DEBUG), "cachedtor: ptr=%p", conn);
+        if (conn->idle_at) {
+            pcbc_connection_idle_unlink(conn TSRMLS_CC);
+        }
+        if (conn->plist_key) {
+            zend_string_release(conn->plist_key);
+            conn->plist_key = NULL;
+            PCBCG(pool_live)--;
+        }
         if (conn->lcb) {
             pefree(conn->connstr, 1);
             if (conn->bucketname) {
@@ -318,8 +433,45 @@ static void pcbc_destroy_connection_resource(zend_resource *res)
     }
 }
 
-lcb_STATUS pcbc_connection_get(pcbc_connection_t **result, lcb_INSTANCE_TYPE type, const char *connstr,
-                               const char *bucketname, const char *username, const char *password TSRMLS_DC)
+/* removes the connection from EG(persistent_list), the destructor of the resource frees it */
+static void pcbc_connection_evict(pcbc_connection_t *conn TSRMLS_DC)
+{
+    if (conn->plist_key) {
+        zend_string *plist_key = zend_string_copy(conn->plist_key);
+        int rv = zend_hash_del(&EG(persistent_list), plist_key);
+        zend_string_release(plist_key);
+        if (rv == SUCCESS) {
+            return;
+        }
+    }
+    pcbc_connection_destroy(conn TSRMLS_CC);
+}
+
+static void pcbc_connection_destroy(pcbc_connection_t *conn TSRMLS_DC)
+{
+    zend_resource res;
+    res.ptr = conn;
+    pcbc_destroy_connection_resource(&res);
+}
+
+/* waits for the rest of the bootstrap, which was started by the prewarm without lcb_wait() */
+static lcb_STATUS pcbc_connection_finish_bootstrap(pcbc_connection_t *conn TSRMLS_DC)
+{
+    lcb_STATUS err;
+
+    conn->bootstrapping = 0;
+    lcb_wait(conn->lcb, LCB_WAIT_DEFAULT);
+    err = lcb_get_bootstrap_status(conn->lcb);
+    if (err != LCB_SUCCESS) {
+        pcbc_log(LOGARGS(conn->lcb, WARN), "Failed to bootstrap prewarmed connection: connstr=%s, username=%s, rc=%s",
+                 conn->connstr, conn->username, lcb_strerror_short(err));
+    }
+    return err;
+}
+
+static lcb_STATUS pcbc_connection_acquire(pcbc_connection_t **result, lcb_INSTANCE_TYPE type, const char *connstr,
+                                          const char *bucketname, const char *username, const char *password,
+                                          int flags TSRMLS_DC)
 {
     char *cstr = NULL;
     lcb_STATUS rv;
@@ -328,6 +480,9 @@ lcb_STATUS pcbc_connection_get(pcbc_connection_t **result, lcb_INSTANCE_TYPE typ
     smart_str plist_key = {0};
     zend_bool is_persistent = 1; // always persistent connections
     zend_resource *res = NULL;
+    zend_long max_slots = PCBCG(pool_instances_per_key);
+    zend_long slot, free_slot = -1;
+    size_t base_len;
 
     rv = pcbc_normalize_connstr(type, (char *)connstr, bucketname, &cstr TSRMLS_CC);
     if (rv != LCB_SUCCESS) {
@@ -340,36 +495,73 @@ lcb_STATUS pcbc_connection_get(pcbc_connection_t **result, lcb_INSTANCE_TYPE typ
     smart_str_appends(&plist_key, cstr);
     smart_str_appendc(&plist_key, '|');
     smart_str_appends(&plist_key, username);
-    res = pcbc_connection_lookup(&plist_key TSRMLS_CC);
-    if (res) {
-        conn = res->ptr;
-        if (conn) {
-            if (lcb_is_waiting(conn->lcb)) {
-                pcbc_log(LOGARGS(conn->lcb, DEBUG),
-                         "cachestale: type=%d, connstr=%s, bucketname=%s, username=%s, lcb=%p, refs=%d", conn->type,
-                         conn->connstr, conn->bucketname, conn->username, conn->lcb, conn->refs);
-                pcbc_destroy_connection_resource(res);
-            } else {
-                efree(cstr);
-                smart_str_free(&plist_key);
-                pcbc_connection_addref(conn TSRMLS_CC);
-                pcbc_log(LOGARGS(conn->lcb, DEBUG),
-                         "cachehit: type=%d, connstr=%s, bucketname=%s, username=%s, lcb=%p, refs=%d", conn->type,
-                         conn->connstr, conn->bucketname, conn->username, conn->lcb, conn->refs);
-                *result = conn;
-                return LCB_SUCCESS;
+    base_len = ZSTR_LEN(plist_key.s);
+    if (max_slots < 1) {
+        max_slots = 1;
+    }
+    /*
+     * The first slot keeps the plain key, the others get "#N" suffix. The lowest usable slot wins, so that the workers
+     * which never re-enter the library bootstrap only one instance per key.
+     */
+    for (slot = 0; slot < max_slots; slot++) {
+        ZSTR_LEN(plist_key.s) = base_len;
+        if (slot > 0) {
+            smart_str_appendc(&plist_key, '#');
+            smart_str_append_long(&plist_key, slot);
+        }
+        res = pcbc_connection_lookup(&plist_key TSRMLS_CC);
+        conn = res ? res->ptr : NULL;
+        if (conn == NULL) {
+            if (free_slot < 0) {
+                free_slot = slot;
+            }
+            continue;
+        }
+        if (lcb_is_waiting(conn->lcb)) {
+            /* re-entrant call (e.g. from a destructor inside of the callback), the instance is inside lcb_wait */
+            PCBCG(pool_busy)++;
+            pcbc_log(LOGARGS(conn->lcb, DEBUG),
+                     "cachebusy: type=%d, connstr=%s, bucketname=%s, username=%s, lcb=%p, refs=%d, slot=%d",
+                     conn->type, conn->connstr, conn->bucketname, conn->username, conn->lcb, conn->refs, (int)slot);
+            continue;
+        }
+        if ((flags & PCBC_ACQUIRE_EXCLUSIVE) && conn->refs > 0) {
+            continue;
+        }
+        if (conn->bootstrapping && !(flags & PCBC_ACQUIRE_NO_WAIT) &&
+            pcbc_connection_finish_bootstrap(conn TSRMLS_CC) != LCB_SUCCESS) {
+            /* nobody has used the prewarmed connection yet, so replace it with the new one below */
+            pcbc_connection_evict(conn TSRMLS_CC);
+            if (free_slot < 0) {
+                free_slot = slot;
             }
+            continue;
         }
+        efree(cstr);
+        smart_str_free(&plist_key);
+        pcbc_connection_addref(conn TSRMLS_CC);
+        PCBCG(pool_hits)++;
+        pcbc_log(LOGARGS(conn->lcb, DEBUG),
+                 "cachehit: type=%d, connstr=%s, bucketname=%s, username=%s, lcb=%p, refs=%d, slot=%d", conn->type,
+                 conn->connstr, conn->bucketname, conn->username, conn->lcb, conn->refs, (int)slot);
+        *result = conn;
+        return LCB_SUCCESS;
+    }
+    PCBCG(pool_misses)++;
+    ZSTR_LEN(plist_key.s) = base_len;
+    if (free_slot > 0) {
+        smart_str_appendc(&plist_key, '#');
+        smart_str_append_long(&plist_key, free_slot);
     }
 
-    rv = pcbc_establish_connection(type, &lcb, cstr, username, password TSRMLS_CC);
+    rv = pcbc_establish_connection(type, &lcb, cstr, username, password, !(flags & PCBC_ACQUIRE_NO_WAIT) TSRMLS_CC);
     if (rv != LCB_SUCCESS) {
         efree(cstr);
         smart_str_free(&plist_key);
         return rv;
     }
 
-    conn = pemalloc(sizeof(pcbc_connection_t), is_persistent);
+    conn = pecalloc(1, sizeof(pcbc_connection_t), is_persistent);
     conn->refs = 1;
     conn->idle_at = 0;
     conn->type = type;
@@ -385,6 +577,15 @@ lcb_STATUS pcbc_connection_get(pcbc_connection_t **result, lcb_INSTANCE_TYPE typ
         }
     }
     conn->lcb = lcb;
+    conn->bootstrapping = (flags & PCBC_ACQUIRE_NO_WAIT) ? 1 : 0;
+    if (free_slot < 0) {
+        pcbc_log(LOGARGS(lcb, DEBUG),
+                 "cachefull: type=%d, connstr=%s, bucketname=%s, username=%s, lcb=%p, all %d instances are busy",
+                 conn->type, conn->connstr, conn->bucketname, conn->username, conn->lcb, (int)max_slots);
+        smart_str_free(&plist_key);
+        *result = conn;
+        return LCB_SUCCESS;
+    }
     rv = pcbc_connection_cache(&plist_key, conn TSRMLS_CC);
     smart_str_free(&plist_key);
     if (rv != LCB_SUCCESS) {
@@ -395,35 +596,195 @@ lcb_STATUS pcbc_connection_get(pcbc_connection_t **result, lcb_INSTANCE_TYPE typ
     return LCB_SUCCESS;
 }
 
-static int pcbc_destroy_idle_connections(zval *el)
+lcb_STATUS pcbc_connection_get(pcbc_connection_t **result, lcb_INSTANCE_TYPE type, const char *connstr,
+                               const char *bucketname, const char *username, const char *password TSRMLS_DC)
 {
-    zend_resource *res = Z_RES_P(el);
+    return pcbc_connection_acquire(result, type, connstr, bucketname, username, password, 0 TSRMLS_CC);
+}
 
-    if (res->type != pcbc_res_couchbase) {
-        return 0;
+/*
+ * Returns the connection, which is not held by any other object. Streamed results fetch their rows only while the
+ * stream itself runs the event loop. If the instance were shared, a blocking call of another object (for example
+ * Collection::upsert() for every row of a report, as the first bucket shares the cluster instance) would run the loop
+ * until the end of the request, and all rows would be buffered regardless of the window. When all slots of the key
+ * are taken, the connection is created outside of the pool and destroyed with its last reference.
+ */
+lcb_STATUS pcbc_connection_get_exclusive(pcbc_connection_t **result, lcb_INSTANCE_TYPE type, const char *connstr,
+                                         const char *bucketname, const char *username,
+                                         const char *password TSRMLS_DC)
+{
+    return pcbc_connection_acquire(result, type, connstr, bucketname, username, password, PCBC_ACQUIRE_EXCLUSIVE
+                                   TSRMLS_CC);
+}
+
+/* takes the connection out of the pool, its current holders keep using it, and the last of them destroys it */
+static void pcbc_connection_detach(pcbc_connection_t *conn TSRMLS_DC)
+{
+    zend_resource *res;
+
+    if (conn->plist_key == NULL) {
+        return;
+    }
+    res = zend_hash_find_ptr(&EG(persistent_list), conn->plist_key);
+    if (res != NULL && res->type == pcbc_res_couchbase && res->ptr == conn) {
+        res->ptr = NULL;
+        zend_hash_del(&EG(persistent_list), conn->plist_key);
     }
+    zend_string_release(conn->plist_key);
+    conn->plist_key = NULL;
+    PCBCG(pool_live)--;
+}
 
-    if (res->ptr) {
-        pcbc_connection_t *conn = res->ptr;
-        time_t now;
+/*
+ * Opens the bucket on the cluster instance with lcb_open(), so that Cluster::bucket() does not bootstrap yet another
+ * instance with its own configuration and sockets. libcouchbase allows only one bucket per instance, therefore the
+ * first bucket shares the cluster instance (also in the following requests, as it stays in the pool), and the other
+ * buckets get their own pooled connections as before.
+ */
+lcb_STATUS pcbc_connection_get_bucket(pcbc_connection_t **result, pcbc_connection_t *cluster, const char *connstr,
+                                      const char *bucketname, const char *username, const char *password TSRMLS_DC)
+{
+    if (cluster && cluster->lcb && cluster->type == LCB_TYPE_CLUSTER && bucketname && bucketname[0] != '\0') {
+        if (cluster->bucketname == NULL && cluster->plist_key && !lcb_is_waiting(cluster->lcb)) {
+            lcb_STATUS err;
+
+            PCBCG(pool_open_status) = LCB_ERR_GENERIC;
+            err = lcb_open(cluster->lcb, bucketname, strlen(bucketname));
+            if (err == LCB_SUCCESS) {
+                lcb_wait(cluster->lcb, LCB_WAIT_DEFAULT);
+                err = PCBCG(pool_open_status);
+            }
+            if (err == LCB_SUCCESS) {
+                cluster->bucketname = pestrdup(bucketname, 1);
+                cluster->shared = 1;
+                pcbc_log(LOGARGS(cluster->lcb, DEBUG),
+                         "cacheopen: connstr=%s, bucketname=%s, username=%s, lcb=%p, refs=%d", cluster->connstr,
+                         cluster->bucketname, cluster->username, cluster->lcb, cluster->refs);
+            } else {
+                /* the state of the instance is unknown now, so do not give it to the next requests */
+                pcbc_log(LOGARGS(cluster->lcb, WARN), "Failed to open bucket \"%s\" on cluster connection: %s",
+                         bucketname, lcb_strerror_short(err));
+                pcbc_connection_detach(cluster TSRMLS_CC);
+            }
+        }
+        if (cluster->shared && strcmp(cluster->bucketname, bucketname) == 0) {
+            pcbc_connection_addref(cluster TSRMLS_CC);
+            PCBCG(pool_shared)++;
+            *result = cluster;
+            return LCB_SUCCESS;
+        }
+    }
+    return pcbc_connection_get(result, LCB_TYPE_BUCKET, connstr, bucketname, username, password TSRMLS_CC);
+}
+
+/*
+ * Starts the bootstrap of the connections listed in couchbase.pool.prewarm. It runs at the beginning of the first
+ * request of the process rather than in MINIT, because php-fpm forks workers after MINIT and they must not share
+ * sockets of the master. The instances are only connected here, without lcb_wait(), so the script starts right away,
+ * and its first use of the connection waits only for the part of the bootstrap, which is not done yet. The start is
+ * delayed by a random interval up to couchbase.pool.prewarm_jitter_ms, so that the workers spawned together do not
+ * hit the cluster at the same moment. CLI has no next request to benefit, so it is skipped there.
+ *
+ * Entries are separated by ';' and have the form "connstr|username|password", for example
+ * "couchbase://127.0.0.1/travel-sample|Administrator|password". Only the cluster connection is prewarmed, because
+ * the bucket can be opened on it only after the bootstrap, and the first Cluster::bucket() does it on the same
+ * instance anyway.
+ */
+void pcbc_connection_prewarm(TSRMLS_D)
+{
+    char *list, *entry, *saveptr = NULL;
+    smart_str status = {0};
+
+    if (PCBCG(pool_prewarm) == NULL || PCBCG(pool_prewarm)[0] == '\0') {
+        return;
+    }
+    if (strcmp(sapi_module.name, "cli") == 0) {
+        return;
+    }
+    if (PCBCG(pool_prewarm_jitter) > 0) {
+        usleep((php_rand() % (PCBCG(pool_prewarm_jitter) + 1)) * 1000);
+    }
 
-        if (conn->refs > 0) {
-            return 0;
+    list = estrdup(PCBCG(pool_prewarm));
+    for (entry = php_strtok_r(list, ";", &saveptr); entry; entry = php_strtok_r(NULL, ";", &saveptr)) {
+        char *connstr, *username, *password = "";
+        pcbc_connection_t *cluster = NULL;
+        char *sep;
+        lcb_STATUS rv;
+
+        while (*entry == ' ' || *entry == '\t' || *entry == '\n') {
+            entry++;
+        }
+        if (*entry == '\0') {
+            continue;
         }
-        if (conn->idle_at == 0) {
-            return 0;
+        connstr = entry;
+        sep = strchr(entry, '|');
+        if (sep == NULL) {
+            pcbc_log(LOGARGS(NULL, WARN), "Skip prewarm entry without username: %s", connstr);
+            continue;
         }
-        now = time(NULL);
-        if ((now - conn->idle_at) >= PCBCG(pool_max_idle_time)) {
-            pcbc_destroy_connection_resource(res);
+        *sep = '\0';
+        username = sep + 1;
+        sep = strchr(username, '|');
+        if (sep) {
+            *sep = '\0';
+            password = sep + 1;
         }
+
+        /* nothing uses the connection yet, it stays in the pool as idle until the script asks for it */
+        rv = pcbc_connection_acquire(&cluster, LCB_TYPE_CLUSTER, connstr, NULL, username, password,
+                                     PCBC_ACQUIRE_NO_WAIT TSRMLS_CC);
+        if (rv == LCB_SUCCESS) {
+            pcbc_connection_delref(cluster TSRMLS_CC);
+            pcbc_log(LOGARGS(NULL, INFO), "Started prewarm of connection: connstr=%s, username=%s", connstr, username);
+        } else {
+            pcbc_log(LOGARGS(NULL, WARN), "Failed to prewarm connection: connstr=%s, username=%s, rc=%s", connstr,
+                     username, lcb_strerror_short(rv));
+        }
+
+        if (status.s) {
+            smart_str_appendl(&status, ", ", 2);
+        }
+        smart_str_appends(&status, connstr);
+        smart_str_appendc(&status, '|');
+        smart_str_appends(&status, username);
+        smart_str_appendl(&status, ": ", 2);
+        smart_str_appends(&status, rv == LCB_SUCCESS ? "started" : lcb_strerror_short(rv));
+    }
+    efree(list);
+
+    if (status.s) {
+        if (PCBCG(pool_prewarm_status)) {
+            zend_string_release(PCBCG(pool_prewarm_status));
+        }
+        PCBCG(pool_prewarm_status) = zend_string_init(PCBC_SMARTSTR_VAL(status), PCBC_SMARTSTR_LEN(status), 1);
+        smart_str_free(&status);
     }
-    return 0;
 }
 
+/*
+ * Called at the end of every request. The idle list is ordered, so only the expired connections at its head are
+ * visited, and the check itself runs at most once per couchbase.pool.check_interval_sec. When caching is disabled with
+ * zero couchbase.pool.max_idle_time_sec, idle connections are destroyed on every request.
+ */
 void pcbc_connection_cleanup()
 {
-    zend_hash_apply(&EG(persistent_list), (apply_func_t)pcbc_destroy_idle_connections);
+    pcbc_connection_t *conn;
+    time_t now;
+
+    if (PCBCG(pool_idle_head) == NULL) {
+        return;
+    }
+    now = time(NULL);
+    if (PCBCG(pool_max_idle_time) > 0 && (now - PCBCG(pool_checked_at)) < PCBCG(pool_check_interval)) {
+        return;
+    }
+    PCBCG(pool_checked_at) = now;
+    while ((conn = PCBCG(pool_idle_head)) != NULL && (now - conn->idle_at) >= PCBCG(pool_max_idle_time)) {
+        PCBCG(pool_evictions)++;
+        pcbc_connection_evict(conn TSRMLS_CC);
+    }
 }
 
 ZEND_RSRC_DTOR_FUNC(pcbc_connection_dtor)
@@ -431,9 +792,52 @@ ZEND_RSRC_DTOR_FUNC(pcbc_connection_dtor)
     pcbc_destroy_connection_resource(res);
 }
 
+zend_class_entry *pcbc_pool_ce;
+
+PHP_METHOD(Pool, __construct)
+{
+    throw_pcbc_exception("Accessing private constructor.", LCB_ERR_INVALID_ARGUMENT);
+}
+
+PHP_METHOD(Pool, stats)
+{
+    if (zend_parse_parameters_none_throw() == FAILURE) {
+        return;
+    }
+
+    array_init(return_value);
+    add_assoc_long(return_value, "hits", PCBCG(pool_hits));
+    add_assoc_long(return_value, "misses", PCBCG(pool_misses));
+    add_assoc_long(return_value, "evictions", PCBCG(pool_evictions));
+    add_assoc_long(return_value, "live", PCBCG(pool_live));
+    add_assoc_long(return_value, "idle", PCBCG(pool_idle));
+    add_assoc_long(return_value, "busy", PCBCG(pool_busy));
+    add_assoc_long(return_value, "shared", PCBCG(pool_shared));
+}
+
+ZEND_BEGIN_ARG_INFO_EX(ai_Pool_none, 0, 0, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(ai_Pool_stats, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+// clang-format off
+zend_function_entry pool_methods[] = {
+    PHP_ME(Pool, __construct, ai_Pool_none, ZEND_ACC_PRIVATE | ZEND_ACC_FINAL | ZEND_ACC_CTOR)
+    PHP_ME(Pool, stats, ai_Pool_stats, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_FE_END
+};
+// clang-format on
+
 PHP_MINIT_FUNCTION(CouchbasePool)
 {
+    zend_class_entry ce;
+
     pcbc_res_couchbase =
         zend_register_list_destructors_ex(NULL, pcbc_connection_dtor, "Couchbase persistent connection", module_number);
+
+    INIT_NS_CLASS_ENTRY(ce, "Couchbase", "Pool", pool_methods);
+    pcbc_pool_ce = zend_register_internal_class(&ce TSRMLS_CC);
+    pcbc_pool_ce->ce_flags |= ZEND_ACC_FINAL;
     return SUCCESS;
 }
@@ -16,6 +16,8 @@
 
 #include "couchbase.h"
 
+#define LOGARGS(instance, lvl) LCB_LOG_##lvl, instance, "pcbc/result", __FILE__, __LINE__
+
 // clang-format off
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(ai_MutationToken_partitionId, IS_LONG, 1)
 ZEND_END_ARG_INFO()
@@ -195,6 +197,7 @@ static const zend_function_entry pcbc_result_methods[] = {
 };
 
 PHP_METHOD(ResultImpl, cas);
+PHP_METHOD(ResultImpl, expiry);
 
 zend_class_entry *pcbc_result_impl_ce;
 static const zend_function_entry pcbc_result_impl_methods[] = {
@@ -211,14 +214,12 @@ static const zend_function_entry pcbc_get_result_methods[] = {
     PHP_FE_END
 };
 
-PHP_METHOD(GetResultImpl, cas);
-PHP_METHOD(GetResultImpl, expiry);
 PHP_METHOD(GetResultImpl, content);
 
 zend_class_entry *pcbc_get_result_impl_ce;
 static const zend_function_entry pcbc_get_result_impl_methods[] = {
-    PHP_ME(GetResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
-    PHP_ME(GetResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
     PHP_ME(GetResultImpl, content, ai_GetResult_content, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
@@ -236,15 +237,13 @@ static const zend_function_entry pcbc_get_replica_result_methods[] = {
     PHP_FE_END
 };
 
-PHP_METHOD(GetReplicaResultImpl, cas);
-PHP_METHOD(GetReplicaResultImpl, expiry);
 PHP_METHOD(GetReplicaResultImpl, content);
 PHP_METHOD(GetReplicaResultImpl, isReplica);
 
 zend_class_entry *pcbc_get_replica_result_impl_ce;
 static const zend_function_entry pcbc_get_replica_result_impl_methods[] = {
-    PHP_ME(GetReplicaResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
-    PHP_ME(GetReplicaResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
     PHP_ME(GetReplicaResultImpl, content, ai_GetReplicaResult_content, ZEND_ACC_PUBLIC)
     PHP_ME(GetReplicaResultImpl, isReplica, ai_GetReplicaResult_isReplica, ZEND_ACC_PUBLIC)
     PHP_FE_END
@@ -259,14 +258,12 @@ static const zend_function_entry pcbc_exists_result_methods[] = {
     PHP_FE_END
 };
 
-PHP_METHOD(ExistsResultImpl, cas);
-PHP_METHOD(ExistsResultImpl, expiry);
 PHP_METHOD(ExistsResultImpl, exists);
 
 zend_class_entry *pcbc_exists_result_impl_ce;
 static const zend_function_entry pcbc_exists_result_impl_methods[] = {
-    PHP_ME(ExistsResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
-    PHP_ME(ExistsResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
     PHP_ME(ExistsResultImpl, exists, ai_ExistsResult_exists, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
@@ -280,27 +277,21 @@ static const zend_function_entry pcbc_mutation_result_methods[] = {
     PHP_FE_END
 };
 
-PHP_METHOD(MutationResultImpl, cas);
-PHP_METHOD(MutationResultImpl, expiry);
 PHP_METHOD(MutationResultImpl, mutationToken);
 
 zend_class_entry *pcbc_mutation_result_impl_ce;
 static const zend_function_entry pcbc_mutation_result_impl_methods[] = {
-    PHP_ME(MutationResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
-    PHP_ME(MutationResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
     PHP_ME(MutationResultImpl, mutationToken, ai_MutationResult_mutationToken, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
 
-PHP_METHOD(StoreResultImpl, cas);
-PHP_METHOD(StoreResultImpl, expiry);
-PHP_METHOD(StoreResultImpl, mutationToken);
-
 zend_class_entry *pcbc_store_result_impl_ce;
 static const zend_function_entry pcbc_store_result_impl_methods[] = {
-    PHP_ME(StoreResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
-    PHP_ME(StoreResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
-    PHP_ME(StoreResultImpl, mutationToken, ai_MutationResult_mutationToken, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
+    PHP_ME(MutationResultImpl, mutationToken, ai_MutationResult_mutationToken, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
 
@@ -313,16 +304,13 @@ static const zend_function_entry pcbc_counter_result_methods[] = {
     PHP_FE_END
 };
 
-PHP_METHOD(CounterResultImpl, cas);
-PHP_METHOD(CounterResultImpl, expiry);
-PHP_METHOD(CounterResultImpl, mutationToken);
 PHP_METHOD(CounterResultImpl, content);
 
 zend_class_entry *pcbc_counter_result_impl_ce;
 static const zend_function_entry pcbc_counter_result_impl_methods[] = {
-    PHP_ME(CounterResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
-    PHP_ME(CounterResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
-    PHP_ME(CounterResultImpl, mutationToken, ai_MutationResult_mutationToken, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
+    PHP_ME(MutationResultImpl, mutationToken, ai_MutationResult_mutationToken, ZEND_ACC_PUBLIC)
     PHP_ME(CounterResultImpl, content, ai_CounterResult_content, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
@@ -347,16 +335,14 @@ static const zend_function_entry pcbc_lookup_in_result_methods[] = {
     PHP_FE_END
 };
 
-PHP_METHOD(LookupInResultImpl, cas);
-PHP_METHOD(LookupInResultImpl, expiry);
 PHP_METHOD(LookupInResultImpl, content);
 PHP_METHOD(LookupInResultImpl, exists);
 PHP_METHOD(LookupInResultImpl, status);
 
 zend_class_entry *pcbc_lookup_in_result_impl_ce;
 static const zend_function_entry pcbc_lookup_in_result_impl_methods[] = {
-    PHP_ME(LookupInResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
-    PHP_ME(LookupInResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
     PHP_ME(LookupInResultImpl, content, ai_LookupInResult_content, ZEND_ACC_PUBLIC)
     PHP_ME(LookupInResultImpl, exists, ai_LookupInResult_exists, ZEND_ACC_PUBLIC)
     PHP_ME(LookupInResultImpl, status, ai_LookupInResult_status, ZEND_ACC_PUBLIC)
@@ -382,17 +368,14 @@ static const zend_function_entry pcbc_mutate_in_result_methods[] = {
     PHP_FE_END
 };
 
-PHP_METHOD(MutateInResultImpl, cas);
-PHP_METHOD(MutateInResultImpl, expiry);
-PHP_METHOD(MutateInResultImpl, mutationToken);
 PHP_METHOD(MutateInResultImpl, content);
 PHP_METHOD(MutateInResultImpl, status);
 
 zend_class_entry *pcbc_mutate_in_result_impl_ce;
 static const zend_function_entry pcbc_mutate_in_result_impl_methods[] = {
-    PHP_ME(MutateInResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
-    PHP_ME(MutateInResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
-    PHP_ME(MutateInResultImpl, mutationToken, ai_MutationResult_mutationToken, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, cas, ai_Result_cas, ZEND_ACC_PUBLIC)
+    PHP_ME(ResultImpl, expiry, ai_Result_expiry, ZEND_ACC_PUBLIC)
+    PHP_ME(MutationResultImpl, mutationToken, ai_MutationResult_mutationToken, ZEND_ACC_PUBLIC)
     PHP_ME(MutateInResultImpl, content, ai_MutateInResult_content, ZEND_ACC_PUBLIC)
     PHP_ME(MutateInResultImpl, status, ai_MutateInResult_status, ZEND_ACC_PUBLIC)
     PHP_FE_END
@@ -416,13 +399,18 @@ static const zend_function_entry pcbc_query_result_methods[] = {
     PHP_FE_END
 };
 
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO(ai_Result_getIterator, \\Iterator, 0)
+ZEND_END_ARG_INFO()
+
 PHP_METHOD(QueryResultImpl, metaData);
 PHP_METHOD(QueryResultImpl, rows);
+PHP_METHOD(QueryResultImpl, getIterator);
 
 zend_class_entry *pcbc_query_result_impl_ce;
 static const zend_function_entry pcbc_query_result_impl_methods[] = {
     PHP_ME(QueryResultImpl, metaData, ai_QueryResult_metaData, ZEND_ACC_PUBLIC)
     PHP_ME(QueryResultImpl, rows, ai_QueryResult_rows, ZEND_ACC_PUBLIC)
+    PHP_ME(QueryResultImpl, getIterator, ai_Result_getIterator, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
 
@@ -441,11 +429,13 @@ static const zend_function_entry pcbc_analytics_result_methods[] = {
 
 PHP_METHOD(AnalyticsResultImpl, metaData);
 PHP_METHOD(AnalyticsResultImpl, rows);
+PHP_METHOD(AnalyticsResultImpl, getIterator);
 
 zend_class_entry *pcbc_analytics_result_impl_ce;
 static const zend_function_entry pcbc_analytics_result_impl_methods[] = {
     PHP_ME(AnalyticsResultImpl, metaData, ai_AnalyticsResult_metaData, ZEND_ACC_PUBLIC)
     PHP_ME(AnalyticsResultImpl, rows, ai_AnalyticsResult_rows, ZEND_ACC_PUBLIC)
+    PHP_ME(AnalyticsResultImpl, getIterator, ai_Result_getIterator, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
 
@@ -469,12 +459,14 @@ static const zend_function_entry pcbc_search_result_methods[] = {
 PHP_METHOD(SearchResultImpl, metaData);
 PHP_METHOD(SearchResultImpl, facets);
 PHP_METHOD(SearchResultImpl, rows);
+PHP_METHOD(SearchResultImpl, getIterator);
 
 zend_class_entry *pcbc_search_result_impl_ce;
 static const zend_function_entry pcbc_search_result_impl_methods[] = {
     PHP_ME(SearchResultImpl, metaData, ai_SearchResult_metaData, ZEND_ACC_PUBLIC)
     PHP_ME(SearchResultImpl, facets, ai_SearchResult_facets, ZEND_ACC_PUBLIC)
     PHP_ME(SearchResultImpl, rows, ai_SearchResult_rows, ZEND_ACC_PUBLIC)
+    PHP_ME(SearchResultImpl, getIterator, ai_Result_getIterator, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
 
@@ -493,11 +485,13 @@ static const zend_function_entry pcbc_view_result_methods[] = {
 
 PHP_METHOD(ViewResultImpl, metaData);
 PHP_METHOD(ViewResultImpl, rows);
+PHP_METHOD(ViewResultImpl, getIterator);
 
 zend_class_entry *pcbc_view_result_impl_ce;
 static const zend_function_entry pcbc_view_result_impl_methods[] = {
     PHP_ME(ViewResultImpl, metaData, ai_ViewResult_metaData, ZEND_ACC_PUBLIC)
     PHP_ME(ViewResultImpl, rows, ai_ViewResult_rows, ZEND_ACC_PUBLIC)
+    PHP_ME(ViewResultImpl, getIterator, ai_Result_getIterator, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
 
@@ -529,6 +523,137 @@ static const zend_function_entry pcbc_view_result_entry_methods[] = {
 
 // clang-format on
 
+zend_object_handlers pcbc_kv_result_handlers;
+
+static void pcbc_kv_result_free_object(zend_object *object TSRMLS_DC)
+{
+    pcbc_kv_result_t *obj = Z_KV_RESULT_OBJ(object);
+
+    if (obj->err_ctx) {
+        zend_string_release(obj->err_ctx);
+    }
+    if (obj->err_ref) {
+        zend_string_release(obj->err_ref);
+    }
+    if (obj->data) {
+        zend_string_release(obj->data);
+    }
+    zval_ptr_dtor(&obj->content);
+    zval_ptr_dtor(&obj->mutation_token);
+    zend_object_std_dtor(&obj->std TSRMLS_CC);
+}
+
+static zend_object *pcbc_kv_result_create_object(zend_class_entry *class_type TSRMLS_DC)
+{
+    pcbc_kv_result_t *obj = NULL;
+
+    obj = PCBC_ALLOC_OBJECT_T(pcbc_kv_result_t, class_type);
+
+    zend_object_std_init(&obj->std, class_type TSRMLS_CC);
+    object_properties_init(&obj->std, class_type);
+    ZVAL_UNDEF(&obj->content);
+    ZVAL_UNDEF(&obj->mutation_token);
+
+    obj->std.handlers = &pcbc_kv_result_handlers;
+    return &obj->std;
+}
+
+static HashTable *pcbc_kv_result_get_debug_info(zval *object, int *is_temp TSRMLS_DC)
+{
+    pcbc_kv_result_t *obj = NULL;
+    zval retval;
+
+    *is_temp = 1;
+    obj = Z_KV_RESULT_OBJ_P(object);
+
+    array_init(&retval);
+    add_assoc_long(&retval, "status", obj->status);
+    if (obj->err_ctx) {
+        add_assoc_str(&retval, "err_ctx", zend_string_copy(obj->err_ctx));
+    }
+    if (obj->err_ref) {
+        add_assoc_str(&retval, "err_ref", zend_string_copy(obj->err_ref));
+    }
+    if (obj->cas) {
+        add_assoc_str(&retval, "cas", pcbc_cas_encode(obj->cas));
+    }
+    if (obj->data) {
+        add_assoc_long(&retval, "flags", obj->flags);
+        add_assoc_long(&retval, "datatype", obj->datatype);
+        add_assoc_str(&retval, "data", zend_string_copy(obj->data));
+    }
+    if (Z_TYPE(obj->content) != IS_UNDEF) {
+        Z_TRY_ADDREF(obj->content);
+        add_assoc_zval(&retval, "content", &obj->content);
+    }
+    if (Z_TYPE(obj->mutation_token) != IS_UNDEF) {
+        Z_TRY_ADDREF(obj->mutation_token);
+        add_assoc_zval(&retval, "mutation_token", &obj->mutation_token);
+    }
+
+    return Z_ARRVAL(retval);
+}
+
+zend_object_handlers pcbc_mutation_token_handlers;
+
+static void pcbc_mutation_token_free_object(zend_object *object TSRMLS_DC)
+{
+    pcbc_mutation_token_t *obj = Z_MUTATION_TOKEN_OBJ(object);
+
+    if (obj->bucket_name) {
+        zend_string_release(obj->bucket_name);
+    }
+    zend_object_std_dtor(&obj->std TSRMLS_CC);
+}
+
+static zend_object *pcbc_mutation_token_create_object(zend_class_entry *class_type TSRMLS_DC)
+{
+    pcbc_mutation_token_t *obj = NULL;
+
+    obj = PCBC_ALLOC_OBJECT_T(pcbc_mutation_token_t, class_type);
+
+    zend_object_std_init(&obj->std, class_type TSRMLS_CC);
+    object_properties_init(&obj->std, class_type);
+
+    obj->std.handlers = &pcbc_mutation_token_handlers;
+    return &obj->std;
+}
+
+static HashTable *pcbc_mutation_token_get_debug_info(zval *object, int *is_temp TSRMLS_DC)
+{
+    pcbc_mutation_token_t *obj = NULL;
+    zval retval;
+
+    *is_temp = 1;
+    obj = Z_MUTATION_TOKEN_OBJ_P(object);
+
+    array_init(&retval);
+    add_assoc_long(&retval, "partition_id", obj->partition_id);
+    add_assoc_str(&retval, "partition_uuid", pcbc_cas_encode(obj->partition_uuid));
+    add_assoc_str(&retval, "sequence_number", pcbc_cas_encode(obj->sequence_number));
+    if (obj->bucket_name) {
+        add_assoc_str(&retval, "bucket_name", zend_string_copy(obj->bucket_name));
+    }
+
+    return Z_ARRVAL(retval);
+}
+
+void pcbc_mutation_token_init(zval *return_value, lcb_INSTANCE *instance, const lcb_MUTATION_TOKEN *token TSRMLS_DC)
+{
+    pcbc_mutation_token_t *obj;
+    const char *bucket = NULL;
+
+    object_init_ex(return_value, pcbc_mutation_token_impl_ce);
+    obj = Z_MUTATION_TOKEN_OBJ_P(return_value);
+    obj->partition_id = token->vbid_;
+    obj->partition_uuid = token->uuid_;
+    obj->sequence_number = token->seqno_;
+    lcb_cntl(instance, LCB_CNTL_GET, LCB_CNTL_BUCKETNAME, &bucket);
+    if (bucket) {
+        obj->bucket_name = zend_string_init(bucket, strlen(bucket), 0);
+    }
+}
+
 PHP_MINIT_FUNCTION(Result)
 {
     zend_class_entry ce;
@@ -538,11 +663,8 @@ PHP_MINIT_FUNCTION(Result)
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "MutationTokenImpl", pcbc_mutation_token_impl_methods);
     pcbc_mutation_token_impl_ce = zend_register_internal_class(&ce TSRMLS_CC);
+    pcbc_mutation_token_impl_ce->create_object = pcbc_mutation_token_create_object;
     zend_class_implements(pcbc_mutation_token_impl_ce TSRMLS_CC, 1, pcbc_mutation_token_ce);
-    zend_declare_property_null(pcbc_mutation_token_impl_ce, ZEND_STRL("partition_id"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutation_token_impl_ce, ZEND_STRL("partition_uuid"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutation_token_impl_ce, ZEND_STRL("sequence_number"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutation_token_impl_ce, ZEND_STRL("bucket_name"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "QueryMetaData", pcbc_query_meta_data_methods);
     pcbc_query_meta_data_ce = zend_register_internal_interface(&ce TSRMLS_CC);
@@ -572,6 +694,7 @@ PHP_MINIT_FUNCTION(Result)
     zend_declare_property_null(pcbc_search_meta_data_impl_ce, ZEND_STRL("max_score"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_search_meta_data_impl_ce, ZEND_STRL("metrics"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_search_meta_data_impl_ce, ZEND_STRL("status"), ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_null(pcbc_search_meta_data_impl_ce, ZEND_STRL("error"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "ViewMetaData", pcbc_view_meta_data_methods);
     pcbc_view_meta_data_ce = zend_register_internal_interface(&ce TSRMLS_CC);
@@ -587,13 +710,8 @@ PHP_MINIT_FUNCTION(Result)
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "ResultImpl", pcbc_result_impl_methods);
     pcbc_result_impl_ce = zend_register_internal_class(&ce TSRMLS_CC);
+    pcbc_result_impl_ce->create_object = pcbc_kv_result_create_object;
     zend_class_implements(pcbc_result_impl_ce TSRMLS_CC, 1, pcbc_result_ce);
-    zend_declare_property_null(pcbc_result_impl_ce, ZEND_STRL("cas"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_result_impl_ce, ZEND_STRL("expiry"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_result_impl_ce, ZEND_STRL("key"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_result_impl_ce, ZEND_STRL("status"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_result_impl_ce, ZEND_STRL("err_ctx"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_result_impl_ce, ZEND_STRL("err_ref"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "GetResult", pcbc_get_result_methods);
     pcbc_get_result_ce = zend_register_internal_interface(&ce TSRMLS_CC);
@@ -601,14 +719,8 @@ PHP_MINIT_FUNCTION(Result)
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "GetResultImpl", pcbc_get_result_impl_methods);
     pcbc_get_result_impl_ce = zend_register_internal_class(&ce TSRMLS_CC);
+    pcbc_get_result_impl_ce->create_object = pcbc_kv_result_create_object;
     zend_class_implements(pcbc_get_result_impl_ce TSRMLS_CC, 1, pcbc_get_result_ce);
-    zend_declare_property_null(pcbc_get_result_impl_ce, ZEND_STRL("cas"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_get_result_impl_ce, ZEND_STRL("data"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_get_result_impl_ce, ZEND_STRL("expiry"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_get_result_impl_ce, ZEND_STRL("key"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_get_result_impl_ce, ZEND_STRL("status"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_get_result_impl_ce, ZEND_STRL("err_ctx"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_get_result_impl_ce, ZEND_STRL("err_ref"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "GetReplicaResult", pcbc_get_replica_result_methods);
     pcbc_get_replica_result_ce = zend_register_internal_interface(&ce TSRMLS_CC);
@@ -616,15 +728,8 @@ PHP_MINIT_FUNCTION(Result)
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "GetReplicaResultImpl", pcbc_get_replica_result_impl_methods);
     pcbc_get_replica_result_impl_ce = zend_register_internal_class(&ce TSRMLS_CC);
+    pcbc_get_replica_result_impl_ce->create_object = pcbc_kv_result_create_object;
     zend_class_implements(pcbc_get_replica_result_impl_ce TSRMLS_CC, 1, pcbc_get_replica_result_ce);
-    zend_declare_property_null(pcbc_get_replica_result_impl_ce, ZEND_STRL("cas"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_get_replica_result_impl_ce, ZEND_STRL("data"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_get_replica_result_impl_ce, ZEND_STRL("expiry"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_get_replica_result_impl_ce, ZEND_STRL("key"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_get_replica_result_impl_ce, ZEND_STRL("status"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_get_replica_result_impl_ce, ZEND_STRL("err_ctx"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_get_replica_result_impl_ce, ZEND_STRL("err_ref"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_get_replica_result_impl_ce, ZEND_STRL("is_replica"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "ExistsResult", pcbc_exists_result_methods);
     pcbc_exists_result_ce = zend_register_internal_interface(&ce TSRMLS_CC);
@@ -632,14 +737,8 @@ PHP_MINIT_FUNCTION(Result)
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "ExistsResultImpl", pcbc_exists_result_impl_methods);
     pcbc_exists_result_impl_ce = zend_register_internal_class(&ce TSRMLS_CC);
+    pcbc_exists_result_impl_ce->create_object = pcbc_kv_result_create_object;
     zend_class_implements(pcbc_exists_result_impl_ce TSRMLS_CC, 1, pcbc_exists_result_ce);
-    zend_declare_property_null(pcbc_exists_result_impl_ce, ZEND_STRL("cas"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_exists_result_impl_ce, ZEND_STRL("expiry"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_exists_result_impl_ce, ZEND_STRL("key"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_exists_result_impl_ce, ZEND_STRL("status"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_exists_result_impl_ce, ZEND_STRL("err_ctx"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_exists_result_impl_ce, ZEND_STRL("err_ref"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_exists_result_impl_ce, ZEND_STRL("is_found"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "MutationResult", pcbc_mutation_result_methods);
     pcbc_mutation_result_ce = zend_register_internal_interface(&ce TSRMLS_CC);
@@ -647,28 +746,13 @@ PHP_MINIT_FUNCTION(Result)
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "MutationResultImpl", pcbc_mutation_result_impl_methods);
     pcbc_mutation_result_impl_ce = zend_register_internal_class(&ce TSRMLS_CC);
+    pcbc_mutation_result_impl_ce->create_object = pcbc_kv_result_create_object;
     zend_class_implements(pcbc_mutation_result_impl_ce TSRMLS_CC, 1, pcbc_mutation_result_ce);
-    zend_declare_property_null(pcbc_mutation_result_impl_ce, ZEND_STRL("cas"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutation_result_impl_ce, ZEND_STRL("expiry"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutation_result_impl_ce, ZEND_STRL("key"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutation_result_impl_ce, ZEND_STRL("status"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutation_result_impl_ce, ZEND_STRL("err_ctx"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutation_result_impl_ce, ZEND_STRL("err_ref"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutation_result_impl_ce, ZEND_STRL("mutation_token"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "StoreResultImpl", pcbc_store_result_impl_methods);
     pcbc_store_result_impl_ce = zend_register_internal_class(&ce TSRMLS_CC);
+    pcbc_store_result_impl_ce->create_object = pcbc_kv_result_create_object;
     zend_class_implements(pcbc_store_result_impl_ce TSRMLS_CC, 1, pcbc_mutation_result_ce);
-    zend_declare_property_null(pcbc_store_result_impl_ce, ZEND_STRL("cas"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_store_result_impl_ce, ZEND_STRL("expiry"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_store_result_impl_ce, ZEND_STRL("key"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_store_result_impl_ce, ZEND_STRL("status"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_store_result_impl_ce, ZEND_STRL("err_ctx"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_store_result_impl_ce, ZEND_STRL("err_ref"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_store_result_impl_ce, ZEND_STRL("mutation_token"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_store_result_impl_ce, ZEND_STRL("is_stored"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_store_result_impl_ce, ZEND_STRL("num_persisted"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_store_result_impl_ce, ZEND_STRL("num_replicated"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "CounterResult", pcbc_counter_result_methods);
     pcbc_counter_result_ce = zend_register_internal_interface(&ce TSRMLS_CC);
@@ -676,15 +760,8 @@ PHP_MINIT_FUNCTION(Result)
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "CounterResultImpl", pcbc_counter_result_impl_methods);
     pcbc_counter_result_impl_ce = zend_register_internal_class(&ce TSRMLS_CC);
+    pcbc_counter_result_impl_ce->create_object = pcbc_kv_result_create_object;
     zend_class_implements(pcbc_counter_result_impl_ce TSRMLS_CC, 1, pcbc_counter_result_ce);
-    zend_declare_property_null(pcbc_counter_result_impl_ce, ZEND_STRL("cas"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_counter_result_impl_ce, ZEND_STRL("expiry"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_counter_result_impl_ce, ZEND_STRL("key"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_counter_result_impl_ce, ZEND_STRL("status"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_counter_result_impl_ce, ZEND_STRL("err_ctx"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_counter_result_impl_ce, ZEND_STRL("err_ref"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_counter_result_impl_ce, ZEND_STRL("mutation_token"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_counter_result_impl_ce, ZEND_STRL("content"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "LookupInResult", pcbc_lookup_in_result_methods);
     pcbc_lookup_in_result_ce = zend_register_internal_interface(&ce TSRMLS_CC);
@@ -692,14 +769,8 @@ PHP_MINIT_FUNCTION(Result)
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "LookupInResultImpl", pcbc_lookup_in_result_impl_methods);
     pcbc_lookup_in_result_impl_ce = zend_register_internal_class(&ce TSRMLS_CC);
+    pcbc_lookup_in_result_impl_ce->create_object = pcbc_kv_result_create_object;
     zend_class_implements(pcbc_lookup_in_result_impl_ce TSRMLS_CC, 1, pcbc_lookup_in_result_ce);
-    zend_declare_property_null(pcbc_lookup_in_result_impl_ce, ZEND_STRL("cas"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_lookup_in_result_impl_ce, ZEND_STRL("expiry"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_lookup_in_result_impl_ce, ZEND_STRL("key"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_lookup_in_result_impl_ce, ZEND_STRL("status"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_lookup_in_result_impl_ce, ZEND_STRL("err_ctx"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_lookup_in_result_impl_ce, ZEND_STRL("err_ref"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_lookup_in_result_impl_ce, ZEND_STRL("data"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "LookupInResultEntry", pcbc_lookup_in_result_entry_methods);
     pcbc_lookup_in_result_entry_ce = zend_register_internal_class(&ce TSRMLS_CC);
@@ -712,15 +783,8 @@ PHP_MINIT_FUNCTION(Result)
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "MutateInResultImpl", pcbc_mutate_in_result_impl_methods);
     pcbc_mutate_in_result_impl_ce = zend_register_internal_class(&ce TSRMLS_CC);
+    pcbc_mutate_in_result_impl_ce->create_object = pcbc_kv_result_create_object;
     zend_class_implements(pcbc_mutate_in_result_impl_ce TSRMLS_CC, 1, pcbc_mutate_in_result_ce);
-    zend_declare_property_null(pcbc_mutate_in_result_impl_ce, ZEND_STRL("cas"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutate_in_result_impl_ce, ZEND_STRL("expiry"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutate_in_result_impl_ce, ZEND_STRL("key"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutate_in_result_impl_ce, ZEND_STRL("status"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutate_in_result_impl_ce, ZEND_STRL("err_ctx"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutate_in_result_impl_ce, ZEND_STRL("err_ref"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutate_in_result_impl_ce, ZEND_STRL("mutation_token"), ZEND_ACC_PRIVATE TSRMLS_CC);
-    zend_declare_property_null(pcbc_mutate_in_result_impl_ce, ZEND_STRL("data"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "MutateInResultEntry", pcbc_mutate_in_result_entry_methods);
     pcbc_mutate_in_result_entry_ce = zend_register_internal_class(&ce TSRMLS_CC);
@@ -732,44 +796,48 @@ PHP_MINIT_FUNCTION(Result)
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "QueryResultImpl", pcbc_query_result_impl_methods);
     pcbc_query_result_impl_ce = zend_register_internal_class(&ce TSRMLS_CC);
-    zend_class_implements(pcbc_query_result_impl_ce TSRMLS_CC, 1, pcbc_query_result_ce);
+    zend_class_implements(pcbc_query_result_impl_ce TSRMLS_CC, 2, pcbc_query_result_ce, zend_ce_aggregate);
     zend_declare_property_null(pcbc_query_result_impl_ce, ZEND_STRL("status"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_query_result_impl_ce, ZEND_STRL("meta"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_query_result_impl_ce, ZEND_STRL("rows"), ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_null(pcbc_query_result_impl_ce, ZEND_STRL("stream"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "AnalyticsResult", pcbc_analytics_result_methods);
     pcbc_analytics_result_ce = zend_register_internal_interface(&ce TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "AnalyticsResultImpl", pcbc_analytics_result_impl_methods);
     pcbc_analytics_result_impl_ce = zend_register_internal_class(&ce TSRMLS_CC);
-    zend_class_implements(pcbc_analytics_result_impl_ce TSRMLS_CC, 1, pcbc_analytics_result_ce);
+    zend_class_implements(pcbc_analytics_result_impl_ce TSRMLS_CC, 2, pcbc_analytics_result_ce, zend_ce_aggregate);
     zend_declare_property_null(pcbc_analytics_result_impl_ce, ZEND_STRL("status"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_analytics_result_impl_ce, ZEND_STRL("meta"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_analytics_result_impl_ce, ZEND_STRL("rows"), ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_null(pcbc_analytics_result_impl_ce, ZEND_STRL("stream"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "SearchResult", pcbc_search_result_methods);
     pcbc_search_result_ce = zend_register_internal_interface(&ce TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "SearchResultImpl", pcbc_search_result_impl_methods);
     pcbc_search_result_impl_ce = zend_register_internal_class(&ce TSRMLS_CC);
-    zend_class_implements(pcbc_search_result_impl_ce TSRMLS_CC, 1, pcbc_search_result_ce);
+    zend_class_implements(pcbc_search_result_impl_ce TSRMLS_CC, 2, pcbc_search_result_ce, zend_ce_aggregate);
     zend_declare_property_null(pcbc_search_result_impl_ce, ZEND_STRL("status"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_search_result_impl_ce, ZEND_STRL("meta"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_search_result_impl_ce, ZEND_STRL("facets"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_search_result_impl_ce, ZEND_STRL("rows"), ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_null(pcbc_search_result_impl_ce, ZEND_STRL("stream"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "ViewResult", pcbc_view_result_methods);
     pcbc_view_result_ce = zend_register_internal_interface(&ce TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "ViewResultImpl", pcbc_view_result_impl_methods);
     pcbc_view_result_impl_ce = zend_register_internal_class(&ce TSRMLS_CC);
-    zend_class_implements(pcbc_view_result_impl_ce TSRMLS_CC, 1, pcbc_view_result_ce);
+    zend_class_implements(pcbc_view_result_impl_ce TSRMLS_CC, 2, pcbc_view_result_ce, zend_ce_aggregate);
     zend_declare_property_null(pcbc_view_result_impl_ce, ZEND_STRL("status"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_view_result_impl_ce, ZEND_STRL("http_status"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_view_result_impl_ce, ZEND_STRL("body"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_view_result_impl_ce, ZEND_STRL("body_str"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_view_result_impl_ce, ZEND_STRL("meta"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_view_result_impl_ce, ZEND_STRL("rows"), ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_null(pcbc_view_result_impl_ce, ZEND_STRL("stream"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "ViewRow", pcbc_view_result_entry_methods);
     pcbc_view_result_entry_ce = zend_register_internal_class(&ce TSRMLS_CC);
@@ -777,6 +845,19 @@ PHP_MINIT_FUNCTION(Result)
     zend_declare_property_null(pcbc_view_result_entry_ce, ZEND_STRL("key"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_view_result_entry_ce, ZEND_STRL("value"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_view_result_entry_ce, ZEND_STRL("document"), ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_null(pcbc_view_result_entry_ce, ZEND_STRL("document_str"), ZEND_ACC_PRIVATE TSRMLS_CC);
+
+    memcpy(&pcbc_kv_result_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    pcbc_kv_result_handlers.get_debug_info = pcbc_kv_result_get_debug_info;
+    pcbc_kv_result_handlers.free_obj = pcbc_kv_result_free_object;
+    pcbc_kv_result_handlers.clone_obj = NULL;
+    pcbc_kv_result_handlers.offset = XtOffsetOf(pcbc_kv_result_t, std);
+
+    memcpy(&pcbc_mutation_token_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    pcbc_mutation_token_handlers.get_debug_info = pcbc_mutation_token_get_debug_info;
+    pcbc_mutation_token_handlers.free_obj = pcbc_mutation_token_free_object;
+    pcbc_mutation_token_handlers.clone_obj = NULL;
+    pcbc_mutation_token_handlers.offset = XtOffsetOf(pcbc_mutation_token_t, std);
 
     return SUCCESS;
 }
@@ -787,9 +868,7 @@ PHP_METHOD(MutationTokenImpl, partitionId)
         return;
     }
 
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_mutation_token_impl_ce, getThis(), ZEND_STRL("partition_id"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
+    RETURN_LONG(Z_MUTATION_TOKEN_OBJ_P(getThis())->partition_id);
 }
 
 PHP_METHOD(MutationTokenImpl, partitionUuid)
@@ -798,9 +877,7 @@ PHP_METHOD(MutationTokenImpl, partitionUuid)
         return;
     }
 
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_mutation_token_impl_ce, getThis(), ZEND_STRL("partition_uuid"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
+    RETURN_STR(pcbc_cas_encode(Z_MUTATION_TOKEN_OBJ_P(getThis())->partition_uuid));
 }
 
 PHP_METHOD(MutationTokenImpl, sequenceNumber)
@@ -809,9 +886,7 @@ PHP_METHOD(MutationTokenImpl, sequenceNumber)
         return;
     }
 
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_mutation_token_impl_ce, getThis(), ZEND_STRL("sequence_number"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
+    RETURN_STR(pcbc_cas_encode(Z_MUTATION_TOKEN_OBJ_P(getThis())->sequence_number));
 }
 
 PHP_METHOD(MutationTokenImpl, bucketName)
@@ -820,9 +895,11 @@ PHP_METHOD(MutationTokenImpl, bucketName)
         return;
     }
 
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_mutation_token_impl_ce, getThis(), ZEND_STRL("bucket_name"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
+    pcbc_mutation_token_t *obj = Z_MUTATION_TOKEN_OBJ_P(getThis());
+    if (obj->bucket_name == NULL) {
+        RETURN_NULL();
+    }
+    RETURN_STR_COPY(obj->bucket_name);
 }
 
 PHP_METHOD(ResultImpl, cas)
@@ -831,112 +908,79 @@ PHP_METHOD(ResultImpl, cas)
         return;
     }
 
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_result_impl_ce, getThis(), ZEND_STRL("cas"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
-
-PHP_METHOD(GetResultImpl, cas)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
+    pcbc_kv_result_t *obj = Z_KV_RESULT_OBJ_P(getThis());
+    if (obj->cas == 0) {
+        RETURN_NULL();
     }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_get_result_impl_ce, getThis(), ZEND_STRL("cas"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
+    RETURN_STR(pcbc_cas_encode(obj->cas));
 }
 
-PHP_METHOD(GetResultImpl, expiry)
+PHP_METHOD(ResultImpl, expiry)
 {
     if (zend_parse_parameters_none_throw() == FAILURE) {
         return;
     }
 
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_get_result_impl_ce, getThis(), ZEND_STRL("expiry"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
+    /* the expiry is not returned by the server for the key/value operations yet */
+    RETURN_NULL();
 }
 
-PHP_METHOD(GetResultImpl, content)
+PHP_METHOD(MutationResultImpl, mutationToken)
 {
     if (zend_parse_parameters_none_throw() == FAILURE) {
         return;
     }
 
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_get_result_impl_ce, getThis(), ZEND_STRL("data"), 0, &rv);
-    PCBC_JSON_RESET_STATE;
-    if (php_json_decode_ex(return_value, Z_STRVAL_P(prop), Z_STRLEN_P(prop), PHP_JSON_OBJECT_AS_ARRAY,
-                           PHP_JSON_PARSER_DEFAULT_DEPTH TSRMLS_CC)) {
-        ZVAL_COPY(return_value, prop);
+    pcbc_kv_result_t *obj = Z_KV_RESULT_OBJ_P(getThis());
+    if (Z_TYPE(obj->mutation_token) == IS_UNDEF) {
+        RETURN_NULL();
     }
+    ZVAL_COPY(return_value, &obj->mutation_token);
 }
 
-PHP_METHOD(GetReplicaResultImpl, cas)
+PHP_METHOD(GetResultImpl, content)
 {
     if (zend_parse_parameters_none_throw() == FAILURE) {
         return;
     }
 
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_get_replica_result_impl_ce, getThis(), ZEND_STRL("cas"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
-
-PHP_METHOD(GetReplicaResultImpl, expiry)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
+    pcbc_kv_result_t *obj = Z_KV_RESULT_OBJ_P(getThis());
+    if (obj->data == NULL) {
+        RETURN_NULL();
     }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_get_replica_result_impl_ce, getThis(), ZEND_STRL("expiry"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
-
-PHP_METHOD(GetReplicaResultImpl, content)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
+    /* the body never changes after the callback, so it is decoded only once. The arrays are copy-on-write, and the
+     * caller cannot modify the cached value through the returned one */
+    if (Z_TYPE(obj->content) == IS_UNDEF) {
+        PCBC_JSON_RESET_STATE;
+        if (php_json_decode_ex(&obj->content, ZSTR_VAL(obj->data), ZSTR_LEN(obj->data), PHP_JSON_OBJECT_AS_ARRAY,
+                               PHP_JSON_PARSER_DEFAULT_DEPTH TSRMLS_CC)) {
+            zval_ptr_dtor(&obj->content);
+            ZVAL_STR_COPY(&obj->content, obj->data);
+        }
     }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_get_replica_result_impl_ce, getThis(), ZEND_STRL("data"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
+    ZVAL_COPY(return_value, &obj->content);
 }
 
-PHP_METHOD(GetReplicaResultImpl, isReplica)
+PHP_METHOD(GetReplicaResultImpl, content)
 {
     if (zend_parse_parameters_none_throw() == FAILURE) {
         return;
     }
 
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_get_replica_result_impl_ce, getThis(), ZEND_STRL("is_replica"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
-
-PHP_METHOD(ExistsResultImpl, cas)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
+    pcbc_kv_result_t *obj = Z_KV_RESULT_OBJ_P(getThis());
+    if (obj->data == NULL) {
+        RETURN_NULL();
     }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_exists_result_impl_ce, getThis(), ZEND_STRL("cas"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
+    RETURN_STR_COPY(obj->data);
 }
 
-PHP_METHOD(ExistsResultImpl, expiry)
+PHP_METHOD(GetReplicaResultImpl, isReplica)
 {
     if (zend_parse_parameters_none_throw() == FAILURE) {
         return;
     }
 
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_exists_result_impl_ce, getThis(), ZEND_STRL("expiry"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
+    RETURN_BOOL(Z_KV_RESULT_OBJ_P(getThis())->is_replica);
 }
 
 PHP_METHOD(ExistsResultImpl, exists)
@@ -945,141 +989,35 @@ PHP_METHOD(ExistsResultImpl, exists)
         return;
     }
 
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_exists_result_impl_ce, getThis(), ZEND_STRL("is_found"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
-
-PHP_METHOD(MutationResultImpl, cas)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
-    }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_mutation_result_impl_ce, getThis(), ZEND_STRL("cas"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
-
-PHP_METHOD(MutationResultImpl, expiry)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
-    }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_mutation_result_impl_ce, getThis(), ZEND_STRL("expiry"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
-
-PHP_METHOD(MutationResultImpl, mutationToken)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
-    }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_mutation_result_impl_ce, getThis(), ZEND_STRL("mutation_token"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
-
-PHP_METHOD(StoreResultImpl, cas)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
-    }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_store_result_impl_ce, getThis(), ZEND_STRL("cas"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
-
-PHP_METHOD(StoreResultImpl, expiry)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
-    }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_store_result_impl_ce, getThis(), ZEND_STRL("expiry"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
-
-PHP_METHOD(StoreResultImpl, mutationToken)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
-    }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_store_result_impl_ce, getThis(), ZEND_STRL("mutation_token"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
-
-PHP_METHOD(CounterResultImpl, cas)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
-    }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_counter_result_impl_ce, getThis(), ZEND_STRL("cas"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
+    RETURN_BOOL(Z_KV_RESULT_OBJ_P(getThis())->is_found);
 }
 
-PHP_METHOD(CounterResultImpl, expiry)
+PHP_METHOD(CounterResultImpl, content)
 {
     if (zend_parse_parameters_none_throw() == FAILURE) {
         return;
     }
 
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_counter_result_impl_ce, getThis(), ZEND_STRL("expiry"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
-
-PHP_METHOD(CounterResultImpl, mutationToken)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
+    pcbc_kv_result_t *obj = Z_KV_RESULT_OBJ_P(getThis());
+    if (Z_TYPE(obj->content) == IS_UNDEF) {
+        RETURN_NULL();
     }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_counter_result_impl_ce, getThis(), ZEND_STRL("mutation_token"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
+    ZVAL_COPY(return_value, &obj->content);
 }
 
-PHP_METHOD(CounterResultImpl, content)
+static zval *pcbc_kv_result_entry(zval *result, zend_long idx, zend_class_entry *entry_ce)
 {
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
-    }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_counter_result_impl_ce, getThis(), ZEND_STRL("content"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
+    pcbc_kv_result_t *obj = Z_KV_RESULT_OBJ_P(result);
+    zval *entry;
 
-PHP_METHOD(LookupInResultImpl, cas)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
+    if (Z_TYPE(obj->content) != IS_ARRAY) {
+        return NULL;
     }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_lookup_in_result_impl_ce, getThis(), ZEND_STRL("cas"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
-
-PHP_METHOD(LookupInResultImpl, expiry)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
+    entry = zend_hash_index_find(Z_ARRVAL(obj->content), idx);
+    if (entry == NULL || Z_TYPE_P(entry) != IS_OBJECT || Z_OBJCE_P(entry) != entry_ce) {
+        return NULL;
     }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_lookup_in_result_impl_ce, getThis(), ZEND_STRL("expiry"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
+    return entry;
 }
 
 PHP_METHOD(LookupInResultImpl, content)
@@ -1089,18 +1027,15 @@ PHP_METHOD(LookupInResultImpl, content)
     if (rc == FAILURE) {
         RETURN_NULL();
     }
-    zval *data, rv1, rv2;
-    data = zend_read_property(pcbc_lookup_in_result_impl_ce, getThis(), ZEND_STRL("data"), 0, &rv1);
-    if (idx < zend_hash_num_elements(Z_ARRVAL_P(data))) {
-        zval *entry = zend_hash_index_find(Z_ARRVAL_P(data), idx);
-        if (Z_OBJCE_P(entry) == pcbc_lookup_in_result_entry_ce) {
-            zval *value = zend_read_property(pcbc_lookup_in_result_entry_ce, entry, ZEND_STRL("value"), 0, &rv2);
-            ZVAL_DEREF(value);
-            ZVAL_COPY(return_value, value);
-            return;
-        }
-    }
 
+    zval *entry = pcbc_kv_result_entry(getThis(), idx, pcbc_lookup_in_result_entry_ce);
+    if (entry) {
+        zval rv;
+        zval *value = zend_read_property(pcbc_lookup_in_result_entry_ce, entry, ZEND_STRL("value"), 0, &rv);
+        ZVAL_DEREF(value);
+        ZVAL_COPY(return_value, value);
+        return;
+    }
     RETURN_NULL();
 }
 
@@ -1112,15 +1047,12 @@ PHP_METHOD(LookupInResultImpl, exists)
         RETURN_NULL();
     }
 
-    zval *data, rv1, rv2;
-    data = zend_read_property(pcbc_lookup_in_result_impl_ce, getThis(), ZEND_STRL("data"), 0, &rv1);
-    if (idx < zend_hash_num_elements(Z_ARRVAL_P(data))) {
-        zval *entry = zend_hash_index_find(Z_ARRVAL_P(data), idx);
-        if (Z_OBJCE_P(entry) == pcbc_lookup_in_result_entry_ce) {
-            zval *code = zend_read_property(pcbc_lookup_in_result_entry_ce, entry, ZEND_STRL("code"), 0, &rv2);
-            if (Z_LVAL_P(code) == 0) {
-                RETURN_TRUE;
-            }
+    zval *entry = pcbc_kv_result_entry(getThis(), idx, pcbc_lookup_in_result_entry_ce);
+    if (entry) {
+        zval rv;
+        zval *code = zend_read_property(pcbc_lookup_in_result_entry_ce, entry, ZEND_STRL("code"), 0, &rv);
+        if (Z_LVAL_P(code) == 0) {
+            RETURN_TRUE;
         }
     }
     RETURN_FALSE;
@@ -1134,51 +1066,15 @@ PHP_METHOD(LookupInResultImpl, status)
         RETURN_NULL();
     }
 
-    zval *data, rv1, rv2;
-    data = zend_read_property(pcbc_lookup_in_result_impl_ce, getThis(), ZEND_STRL("data"), 0, &rv1);
-    if (idx < zend_hash_num_elements(Z_ARRVAL_P(data))) {
-        zval *entry = zend_hash_index_find(Z_ARRVAL_P(data), idx);
-        if (Z_OBJCE_P(entry) == pcbc_lookup_in_result_entry_ce) {
-            zval *code = zend_read_property(pcbc_lookup_in_result_entry_ce, entry, ZEND_STRL("code"), 0, &rv2);
-            ZVAL_DEREF(code);
-            ZVAL_COPY(return_value, code);
-            return;
-        }
-    }
-    RETURN_NULL();
-}
-
-PHP_METHOD(MutateInResultImpl, mutationToken)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
-    }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_mutate_in_result_impl_ce, getThis(), ZEND_STRL("mutation_token"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
-
-PHP_METHOD(MutateInResultImpl, cas)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
+    zval *entry = pcbc_kv_result_entry(getThis(), idx, pcbc_lookup_in_result_entry_ce);
+    if (entry) {
+        zval rv;
+        zval *code = zend_read_property(pcbc_lookup_in_result_entry_ce, entry, ZEND_STRL("code"), 0, &rv);
+        ZVAL_DEREF(code);
+        ZVAL_COPY(return_value, code);
         return;
     }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_mutate_in_result_impl_ce, getThis(), ZEND_STRL("cas"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
-}
-
-PHP_METHOD(MutateInResultImpl, expiry)
-{
-    if (zend_parse_parameters_none_throw() == FAILURE) {
-        return;
-    }
-
-    zval *prop, rv;
-    prop = zend_read_property(pcbc_mutate_in_result_impl_ce, getThis(), ZEND_STRL("expiry"), 0, &rv);
-    ZVAL_COPY(return_value, prop);
+    RETURN_NULL();
 }
 
 PHP_METHOD(MutateInResultImpl, content)
@@ -1188,18 +1084,15 @@ PHP_METHOD(MutateInResultImpl, content)
     if (rc == FAILURE) {
         RETURN_NULL();
     }
-    zval *data, rv1, rv2;
-    data = zend_read_property(pcbc_mutate_in_result_impl_ce, getThis(), ZEND_STRL("data"), 0, &rv1);
-    if (idx < zend_hash_num_elements(Z_ARRVAL_P(data))) {
-        zval *entry = zend_hash_index_find(Z_ARRVAL_P(data), idx);
-        if (Z_OBJCE_P(entry) == pcbc_mutate_in_result_entry_ce) {
-            zval *value = zend_read_property(pcbc_mutate_in_result_entry_ce, entry, ZEND_STRL("value"), 0, &rv2);
-            ZVAL_DEREF(value);
-            ZVAL_COPY(return_value, value);
-            return;
-        }
-    }
 
+    zval *entry = pcbc_kv_result_entry(getThis(), idx, pcbc_mutate_in_result_entry_ce);
+    if (entry) {
+        zval rv;
+        zval *value = zend_read_property(pcbc_mutate_in_result_entry_ce, entry, ZEND_STRL("value"), 0, &rv);
+        ZVAL_DEREF(value);
+        ZVAL_COPY(return_value, value);
+        return;
+    }
     RETURN_NULL();
 }
 
@@ -1211,16 +1104,13 @@ PHP_METHOD(MutateInResultImpl, status)
         RETURN_NULL();
     }
 
-    zval *data, rv1, rv2;
-    data = zend_read_property(pcbc_mutate_in_result_impl_ce, getThis(), ZEND_STRL("data"), 0, &rv1);
-    if (idx < zend_hash_num_elements(Z_ARRVAL_P(data))) {
-        zval *entry = zend_hash_index_find(Z_ARRVAL_P(data), idx);
-        if (Z_OBJCE_P(entry) == pcbc_mutate_in_result_entry_ce) {
-            zval *code = zend_read_property(pcbc_mutate_in_result_entry_ce, entry, ZEND_STRL("code"), 0, &rv2);
-            ZVAL_DEREF(code);
-            ZVAL_COPY(return_value, code);
-            return;
-        }
+    zval *entry = pcbc_kv_result_entry(getThis(), idx, pcbc_mutate_in_result_entry_ce);
+    if (entry) {
+        zval rv;
+        zval *code = zend_read_property(pcbc_mutate_in_result_entry_ce, entry, ZEND_STRL("code"), 0, &rv);
+        ZVAL_DEREF(code);
+        ZVAL_COPY(return_value, code);
+        return;
     }
     RETURN_NULL();
 }
@@ -1232,7 +1122,7 @@ PHP_METHOD(QueryResultImpl, metaData)
     }
 
     zval *prop, rv;
-    prop = zend_read_property(pcbc_query_result_impl_ce, getThis(), ZEND_STRL("meta"), 0, &rv);
+    prop = pcbc_result_read_property(getThis(), pcbc_query_result_impl_ce, ZEND_STRL("meta"), &rv TSRMLS_CC);
     ZVAL_COPY(return_value, prop);
 }
 
@@ -1247,6 +1137,15 @@ PHP_METHOD(QueryResultImpl, rows)
     ZVAL_COPY(return_value, prop);
 }
 
+PHP_METHOD(QueryResultImpl, getIterator)
+{
+    if (zend_parse_parameters_none_throw() == FAILURE) {
+        return;
+    }
+
+    pcbc_result_get_iterator(getThis(), pcbc_query_result_impl_ce, return_value TSRMLS_CC);
+}
+
 PHP_METHOD(QueryMetaDataImpl, status)
 {
     if (zend_parse_parameters_none_throw() == FAILURE) {
@@ -1342,10 +1241,19 @@ PHP_METHOD(AnalyticsResultImpl, metaData)
     }
 
     zval *prop, rv;
-    prop = zend_read_property(pcbc_analytics_result_impl_ce, getThis(), ZEND_STRL("meta"), 0, &rv);
+    prop = pcbc_result_read_property(getThis(), pcbc_analytics_result_impl_ce, ZEND_STRL("meta"), &rv TSRMLS_CC);
     ZVAL_COPY(return_value, prop);
 }
 
+PHP_METHOD(AnalyticsResultImpl, getIterator)
+{
+    if (zend_parse_parameters_none_throw() == FAILURE) {
+        return;
+    }
+
+    pcbc_result_get_iterator(getThis(), pcbc_analytics_result_impl_ce, return_value TSRMLS_CC);
+}
+
 PHP_METHOD(AnalyticsResultImpl, rows)
 {
     if (zend_parse_parameters_none_throw() == FAILURE) {
@@ -1430,7 +1338,7 @@ PHP_METHOD(SearchResultImpl, metaData)
     }
 
     zval *prop, rv;
-    prop = zend_read_property(pcbc_search_result_impl_ce, getThis(), ZEND_STRL("meta"), 0, &rv);
+    prop = pcbc_result_read_property(getThis(), pcbc_search_result_impl_ce, ZEND_STRL("meta"), &rv TSRMLS_CC);
     ZVAL_COPY(return_value, prop);
 }
 
@@ -1441,10 +1349,19 @@ PHP_METHOD(SearchResultImpl, facets)
     }
 
     zval *prop, rv;
-    prop = zend_read_property(pcbc_search_result_impl_ce, getThis(), ZEND_STRL("facets"), 0, &rv);
+    prop = pcbc_result_read_property(getThis(), pcbc_search_result_impl_ce, ZEND_STRL("facets"), &rv TSRMLS_CC);
     ZVAL_COPY(return_value, prop);
 }
 
+PHP_METHOD(SearchResultImpl, getIterator)
+{
+    if (zend_parse_parameters_none_throw() == FAILURE) {
+        return;
+    }
+
+    pcbc_result_get_iterator(getThis(), pcbc_search_result_impl_ce, return_value TSRMLS_CC);
+}
+
 PHP_METHOD(SearchResultImpl, rows)
 {
     if (zend_parse_parameters_none_throw() == FAILURE) {
@@ -1489,6 +1406,15 @@ PHP_METHOD(ViewResultImpl, rows)
     ZVAL_COPY(return_value, prop);
 }
 
+PHP_METHOD(ViewResultImpl, getIterator)
+{
+    if (zend_parse_parameters_none_throw() == FAILURE) {
+        return;
+    }
+
+    pcbc_result_get_iterator(getThis(), pcbc_view_result_impl_ce, return_value TSRMLS_CC);
+}
+
 PHP_METHOD(ViewResultImpl, metaData)
 {
     if (zend_parse_parameters_none_throw() == FAILURE) {
@@ -1496,7 +1422,7 @@ PHP_METHOD(ViewResultImpl, metaData)
     }
 
     zval *prop, rv;
-    prop = zend_read_property(pcbc_view_result_impl_ce, getThis(), ZEND_STRL("meta"), 0, &rv);
+    prop = pcbc_result_read_property(getThis(), pcbc_view_result_impl_ce, ZEND_STRL("meta"), &rv TSRMLS_CC);
     ZVAL_COPY(return_value, prop);
 }
 
@@ -1541,6 +1467,25 @@ PHP_METHOD(ViewRow, document)
 
     zval *prop, rv;
     prop = zend_read_property(pcbc_view_result_entry_ce, getThis(), ZEND_STRL("document"), 0, &rv);
+    if (Z_TYPE_P(prop) == IS_NULL) {
+        zval *raw, rv2;
+        raw = zend_read_property(pcbc_view_result_entry_ce, getThis(), ZEND_STRL("document_str"), 0, &rv2);
+        if (Z_TYPE_P(raw) == IS_STRING) {
+            zval document;
+            int last_error;
+            PCBC_JSON_COPY_DECODE(&document, Z_STRVAL_P(raw), Z_STRLEN_P(raw), PHP_JSON_OBJECT_AS_ARRAY, last_error);
+            if (last_error) {
+                pcbc_log(LOGARGS(NULL, WARN), "Failed to decode VIEW document as JSON: json_last_error=%d",
+                         last_error);
+            } else {
+                /* keep the decoded document only, the raw bytes are not needed anymore */
+                zend_update_property(pcbc_view_result_entry_ce, getThis(), ZEND_STRL("document"), &document TSRMLS_CC);
+                zend_update_property_null(pcbc_view_result_entry_ce, getThis(), ZEND_STRL("document_str") TSRMLS_CC);
+                zval_ptr_dtor(&document);
+                prop = zend_read_property(pcbc_view_result_entry_ce, getThis(), ZEND_STRL("document"), 0, &rv);
+            }
+        }
+    }
     ZVAL_COPY(return_value, prop);
 }
 
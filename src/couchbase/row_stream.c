@@ -0,0 +1,315 @@
+/**
+ *     Copyright 2019 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "couchbase.h"
+#include <ext/spl/spl_array.h>
+
+#define LOGARGS(instance, lvl) LCB_LOG_##lvl, instance, "pcbc/row_stream", __FILE__, __LINE__
+
+zend_class_entry *pcbc_row_stream_ce;
+
+pcbc_row_stream_t *pcbc_row_stream_init(zval *result, pcbc_connection_t *conn, zend_class_entry *result_ce,
+                                        zend_long window TSRMLS_DC)
+{
+    pcbc_row_stream_t *obj;
+    zval stream;
+
+    object_init_ex(&stream, pcbc_row_stream_ce);
+    obj = Z_ROW_STREAM_OBJ_P(&stream);
+    object_init_ex(&obj->result, result_ce);
+    obj->cookie.rc = LCB_SUCCESS;
+    obj->cookie.return_value = &obj->result;
+    obj->cookie.stream = obj;
+    obj->window = window > 0 ? window : PCBC_ROW_STREAM_DEFAULT_WINDOW;
+    obj->conn = conn;
+    pcbc_connection_addref(conn TSRMLS_CC);
+
+    /* the user-facing result only points to the stream, which holds the object updated by the callbacks */
+    object_init_ex(result, result_ce);
+    zend_update_property(result_ce, result, ZEND_STRL("stream"), &stream TSRMLS_CC);
+    zval_ptr_dtor(&stream);
+    return obj;
+}
+
+void pcbc_row_stream_push(pcbc_row_stream_t *stream, zval *row)
+{
+    zend_hash_index_update(&stream->rows, stream->tail++, row);
+    if (stream->waiting && zend_hash_num_elements(&stream->rows) >= (uint32_t)stream->window) {
+        lcb_breakout(stream->conn->lcb);
+    }
+}
+
+void pcbc_row_stream_finish(pcbc_row_stream_t *stream)
+{
+    stream->done = 1;
+    if (stream->waiting) {
+        /* do not wait for the other requests scheduled on the same instance */
+        lcb_breakout(stream->conn->lcb);
+    }
+    if (stream->started_at) {
+        pcbc_metrics_record(stream->metrics_op, stream->started_at, stream->cookie.rc TSRMLS_CC);
+        stream->started_at = 0;
+    }
+    if (stream->span) {
+        lcbtrace_span_finish(stream->span, LCBTRACE_NOW);
+        stream->span = NULL;
+    }
+}
+
+/*
+ * Runs the event loop when all buffered rows have been consumed, until the callbacks fill the window or complete the
+ * request and break out of it. While the application consumes the rows, the loop does not run, so the next rows stay
+ * in the socket buffers, and TCP flow control throttles the server.
+ */
+static void pcbc_row_stream_fill(pcbc_row_stream_t *stream TSRMLS_DC)
+{
+    if (stream->done || zend_hash_num_elements(&stream->rows) > 0) {
+        return;
+    }
+    stream->waiting = 1;
+    lcb_wait(stream->conn->lcb, LCB_WAIT_DEFAULT);
+    stream->waiting = 0;
+}
+
+static zend_bool pcbc_row_stream_valid(pcbc_row_stream_t *stream TSRMLS_DC)
+{
+    pcbc_row_stream_fill(stream TSRMLS_CC);
+    if (zend_hash_index_exists(&stream->rows, stream->head)) {
+        return 1;
+    }
+    if (stream->done && stream->cookie.rc != LCB_SUCCESS && !stream->error_thrown) {
+        stream->error_thrown = 1;
+        if (stream->error) {
+            stream->error(&stream->result, stream->cookie.rc TSRMLS_CC);
+        } else {
+            throw_http_exception(stream->cookie.rc, 0, NULL);
+        }
+    }
+    return 0;
+}
+
+PHP_METHOD(RowStream, __construct)
+{
+    throw_pcbc_exception("Accessing private constructor.", LCB_ERR_INVALID_ARGUMENT);
+}
+
+PHP_METHOD(RowStream, rewind)
+{
+    if (zend_parse_parameters_none_throw() == FAILURE) {
+        RETURN_NULL();
+    }
+
+    pcbc_row_stream_t *obj = Z_ROW_STREAM_OBJ_P(getThis());
+    if (obj->head > 0) {
+        throw_pcbc_exception("Rows of the streaming result cannot be iterated more than once",
+                             LCB_ERR_INVALID_ARGUMENT);
+        RETURN_NULL();
+    }
+    pcbc_row_stream_valid(obj TSRMLS_CC);
+}
+
+PHP_METHOD(RowStream, valid)
+{
+    if (zend_parse_parameters_none_throw() == FAILURE) {
+        RETURN_NULL();
+    }
+
+    RETURN_BOOL(pcbc_row_stream_valid(Z_ROW_STREAM_OBJ_P(getThis()) TSRMLS_CC));
+}
+
+PHP_METHOD(RowStream, current)
+{
+    if (zend_parse_parameters_none_throw() == FAILURE) {
+        RETURN_NULL();
+    }
+
+    pcbc_row_stream_t *obj = Z_ROW_STREAM_OBJ_P(getThis());
+    if (pcbc_row_stream_valid(obj TSRMLS_CC)) {
+        zval *row = zend_hash_index_find(&obj->rows, obj->head);
+        ZVAL_COPY(return_value, row);
+        return;
+    }
+    RETURN_NULL();
+}
+
+PHP_METHOD(RowStream, key)
+{
+    if (zend_parse_parameters_none_throw() == FAILURE) {
+        RETURN_NULL();
+    }
+
+    RETURN_LONG(Z_ROW_STREAM_OBJ_P(getThis())->head);
+}
+
+PHP_METHOD(RowStream, next)
+{
+    if (zend_parse_parameters_none_throw() == FAILURE) {
+        RETURN_NULL();
+    }
+
+    pcbc_row_stream_t *obj = Z_ROW_STREAM_OBJ_P(getThis());
+    if (zend_hash_index_del(&obj->rows, obj->head) == SUCCESS) {
+        obj->head++;
+    }
+}
+
+PHP_METHOD(RowStream, isCompleted)
+{
+    if (zend_parse_parameters_none_throw() == FAILURE) {
+        RETURN_NULL();
+    }
+
+    RETURN_BOOL(Z_ROW_STREAM_OBJ_P(getThis())->done);
+}
+
+/*
+ * Reads property of the result. In streaming mode "status", "meta", "facets" etc. are stored in the object owned by
+ * the stream, because the callbacks keep updating it while the rows are being iterated.
+ */
+zval *pcbc_result_read_property(zval *result, zend_class_entry *result_ce, const char *name, size_t name_len,
+                                zval *rv TSRMLS_DC)
+{
+    zval *stream = zend_read_property(result_ce, result, ZEND_STRL("stream"), 0, rv);
+    if (Z_TYPE_P(stream) == IS_OBJECT) {
+        result = &Z_ROW_STREAM_OBJ_P(stream)->result;
+    }
+    return zend_read_property(result_ce, result, name, name_len, 0, rv);
+}
+
+void pcbc_result_get_iterator(zval *result, zend_class_entry *result_ce, zval *return_value TSRMLS_DC)
+{
+    zval *prop, rv;
+
+    prop = zend_read_property(result_ce, result, ZEND_STRL("stream"), 0, &rv);
+    if (Z_TYPE_P(prop) == IS_OBJECT) {
+        ZVAL_COPY(return_value, prop);
+        return;
+    }
+
+    prop = zend_read_property(result_ce, result, ZEND_STRL("rows"), 0, &rv);
+    object_init_ex(return_value, spl_ce_ArrayIterator);
+    if (Z_TYPE_P(prop) == IS_ARRAY) {
+        zend_call_method_with_1_params(return_value, spl_ce_ArrayIterator, &spl_ce_ArrayIterator->constructor,
+                                       "__construct", NULL, prop);
+    }
+}
+
+ZEND_BEGIN_ARG_INFO_EX(ai_RowStream_none, 0, 0, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(ai_RowStream_valid, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(ai_RowStream_key, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO(ai_RowStream_isCompleted, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+// clang-format off
+zend_function_entry row_stream_methods[] = {
+    PHP_ME(RowStream, __construct, ai_RowStream_none, ZEND_ACC_PRIVATE | ZEND_ACC_FINAL | ZEND_ACC_CTOR)
+    PHP_ME(RowStream, rewind, ai_RowStream_none, ZEND_ACC_PUBLIC)
+    PHP_ME(RowStream, valid, ai_RowStream_valid, ZEND_ACC_PUBLIC)
+    PHP_ME(RowStream, current, ai_RowStream_none, ZEND_ACC_PUBLIC)
+    PHP_ME(RowStream, key, ai_RowStream_key, ZEND_ACC_PUBLIC)
+    PHP_ME(RowStream, next, ai_RowStream_none, ZEND_ACC_PUBLIC)
+    PHP_ME(RowStream, isCompleted, ai_RowStream_isCompleted, ZEND_ACC_PUBLIC)
+    PHP_FE_END
+};
+// clang-format on
+
+zend_object_handlers pcbc_row_stream_handlers;
+
+static void pcbc_row_stream_free_object(zend_object *object TSRMLS_DC)
+{
+    pcbc_row_stream_t *obj = Z_ROW_STREAM_OBJ(object);
+
+    if (obj->conn) {
+        if (!obj->done) {
+            /* libcouchbase will not invoke the callback for the cancelled request, so the cookie can be released */
+            if (obj->cancel && obj->handle) {
+                obj->cancel(obj->conn->lcb, obj->handle);
+            } else {
+                lcb_wait(obj->conn->lcb, LCB_WAIT_DEFAULT);
+            }
+            /* the application has abandoned the stream, so the latency would not be meaningful */
+            obj->started_at = 0;
+            pcbc_row_stream_finish(obj);
+        }
+        pcbc_connection_delref(obj->conn TSRMLS_CC);
+        obj->conn = NULL;
+    }
+    zend_hash_destroy(&obj->rows);
+    zval_ptr_dtor(&obj->result);
+    zend_object_std_dtor(&obj->std TSRMLS_CC);
+}
+
+static zend_object *pcbc_row_stream_create_object(zend_class_entry *class_type TSRMLS_DC)
+{
+    pcbc_row_stream_t *obj = NULL;
+
+    obj = PCBC_ALLOC_OBJECT_T(pcbc_row_stream_t, class_type);
+
+    zend_object_std_init(&obj->std, class_type TSRMLS_CC);
+    object_properties_init(&obj->std, class_type);
+    zend_hash_init(&obj->rows, 8, NULL, ZVAL_PTR_DTOR, 0);
+    ZVAL_UNDEF(&obj->result);
+
+    obj->std.handlers = &pcbc_row_stream_handlers;
+    return &obj->std;
+}
+
+static HashTable *pcbc_row_stream_get_debug_info(zval *object, int *is_temp TSRMLS_DC)
+{
+    pcbc_row_stream_t *obj = NULL;
+    zval retval;
+
+    *is_temp = 1;
+    obj = Z_ROW_STREAM_OBJ_P(object);
+
+    array_init(&retval);
+    add_assoc_bool(&retval, "completed", obj->done);
+    add_assoc_long(&retval, "position", obj->head);
+    add_assoc_long(&retval, "buffered", zend_hash_num_elements(&obj->rows));
+    add_assoc_long(&retval, "window", obj->window);
+
+    return Z_ARRVAL(retval);
+}
+
+PHP_MINIT_FUNCTION(RowStream)
+{
+    zend_class_entry ce;
+
+    INIT_NS_CLASS_ENTRY(ce, "Couchbase", "RowStream", row_stream_methods);
+    pcbc_row_stream_ce = zend_register_internal_class(&ce TSRMLS_CC);
+    pcbc_row_stream_ce->create_object = pcbc_row_stream_create_object;
+    pcbc_row_stream_ce->ce_flags |= ZEND_ACC_FINAL;
+    PCBC_CE_DISABLE_SERIALIZATION(pcbc_row_stream_ce);
+    zend_class_implements(pcbc_row_stream_ce TSRMLS_CC, 1, zend_ce_iterator);
+
+    memcpy(&pcbc_row_stream_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    pcbc_row_stream_handlers.get_debug_info = pcbc_row_stream_get_debug_info;
+    pcbc_row_stream_handlers.free_obj = pcbc_row_stream_free_object;
+    pcbc_row_stream_handlers.clone_obj = NULL;
+    pcbc_row_stream_handlers.offset = XtOffsetOf(pcbc_row_stream_t, std);
+
+    return SUCCESS;
+}
+
+/*
+ * vim: et ts=4 sw=4 sts=4
+ */
@@ -194,6 +194,21 @@ PHP_METHOD(SearchOptions, highlight)
     RETURN_ZVAL(getThis(), 1, 0);
 }
 
+PHP_METHOD(SearchOptions, streaming)
+{
+    zend_bool arg;
+    zend_long window = 0;
+    int rv = zend_parse_parameters_throw(ZEND_NUM_ARGS() TSRMLS_CC, "b|l", &arg, &window);
+    if (rv == FAILURE) {
+        RETURN_NULL();
+    }
+    zend_update_property_bool(pcbc_search_options_ce, getThis(), ZEND_STRL("streaming"), arg TSRMLS_CC);
+    if (window > 0) {
+        zend_update_property_long(pcbc_search_options_ce, getThis(), ZEND_STRL("stream_window"), window TSRMLS_CC);
+    }
+    RETURN_ZVAL(getThis(), 1, 0);
+}
+
 PHP_METHOD(SearchOptions, jsonSerialize)
 {
     int rv;
@@ -334,6 +349,11 @@ ZEND_ARG_TYPE_INFO(0, style, IS_STRING, 1)
 ZEND_ARG_TYPE_INFO(0, fields, IS_ARRAY, 1)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(ai_SearchOptions_streaming, 0, 1, \\Couchbase\\SearchOptions, 0)
+ZEND_ARG_TYPE_INFO(0, enabled, _IS_BOOL, 0)
+ZEND_ARG_TYPE_INFO(0, rowWindow, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
 // clang-format off
 zend_function_entry search_options_methods[] = {
     PHP_ME(SearchOptions, jsonSerialize, ai_SearchOptions_none, ZEND_ACC_PUBLIC)
@@ -346,6 +366,7 @@ zend_function_entry search_options_methods[] = {
     PHP_ME(SearchOptions, facets, ai_SearchOptions_facets, ZEND_ACC_PUBLIC)
     PHP_ME(SearchOptions, sort, ai_SearchOptions_sort, ZEND_ACC_PUBLIC)
     PHP_ME(SearchOptions, highlight, ai_SearchOptions_highlight, ZEND_ACC_PUBLIC)
+    PHP_ME(SearchOptions, streaming, ai_SearchOptions_streaming, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
 // clang-format on
@@ -371,6 +392,8 @@ PHP_MINIT_FUNCTION(SearchOptions)
     zend_declare_property_null(pcbc_search_options_ce, ZEND_STRL("facets"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_search_options_ce, ZEND_STRL("highlight_style"), ZEND_ACC_PRIVATE TSRMLS_CC);
     zend_declare_property_null(pcbc_search_options_ce, ZEND_STRL("highlight_fields"), ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_null(pcbc_search_options_ce, ZEND_STRL("streaming"), ZEND_ACC_PRIVATE TSRMLS_CC);
+    zend_declare_property_null(pcbc_search_options_ce, ZEND_STRL("stream_window"), ZEND_ACC_PRIVATE TSRMLS_CC);
 
     INIT_NS_CLASS_ENTRY(ce, "Couchbase", "SearchHighlightMode", pcbc_search_highlight_mode_methods);
     pcbc_search_highlight_mode_ce = zend_register_internal_interface(&ce TSRMLS_CC);
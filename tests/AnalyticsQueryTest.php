@@ -0,0 +1,40 @@
+<?php
+require_once('CouchbaseTestCase.php');
+
+class AnalyticsQueryTest extends CouchbaseTestCase {
+    private $cluster;
+
+    protected function setUp() {
+        parent::setUp();
+        $options = new \Couchbase\ClusterOptions();
+        $options->credentials($this->testUser, $this->testPassword);
+        $this->cluster = new \Couchbase\Cluster($this->testDsn, $options);
+    }
+
+    function testStreaming() {
+        if ($this->usingMock()) {
+            $this->markTestSkipped('Analytics queries are not supported by the CouchbaseMock');
+        }
+        $options = (new \Couchbase\AnalyticsOptions())->streaming(true, 2);
+        $res = $this->cluster->analyticsQuery("SELECT VALUE v FROM [1, 2, 3, 4, 5] AS v", $options);
+        $this->assertNull($res->rows());
+        $rows = [];
+        foreach ($res as $row) {
+            $rows[] = $row;
+        }
+        $this->assertEquals([1, 2, 3, 4, 5], $rows);
+        $this->assertEquals("success", $res->metaData()->status());
+    }
+
+    function testStreamingErrorCarriesServerMessage() {
+        if ($this->usingMock()) {
+            $this->markTestSkipped('Analytics queries are not supported by the CouchbaseMock');
+        }
+        $options = (new \Couchbase\AnalyticsOptions())->streaming(true, 2);
+        $res = $this->cluster->analyticsQuery("SELEC 42", $options);
+        $this->wrapException(function() use($res) {
+            foreach ($res as $row) {
+            }
+        }, '\Couchbase\BaseException', 24000, '/Syntax error/');
+    }
+}
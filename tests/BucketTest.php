@@ -47,6 +47,206 @@ class BucketTest extends CouchbaseTestCase {
         return $b->defaultCollection();
     }
 
+    /**
+     * Test that the second connection with the same details is taken from the pool
+     *
+     * @depends testConnect
+     */
+    function testPoolStats($c) {
+        $before = \Couchbase\Pool::stats();
+        $this->assertGreaterThan(0, $before['live']);
+
+        $options = new \Couchbase\ClusterOptions();
+        $options->credentials($this->testUser, $this->testPassword);
+        $h = new \Couchbase\Cluster($this->testDsn, $options);
+        $h->bucket($this->testBucket);
+
+        $after = \Couchbase\Pool::stats();
+        // the bucket either shares the instance of the cluster or has its own pooled connection
+        $this->assertEquals($before['hits'] + $before['shared'] + 2, $after['hits'] + $after['shared']);
+        $this->assertEquals($before['misses'], $after['misses']);
+        $this->assertEquals($before['live'], $after['live']);
+    }
+
+    /**
+     * Test that the connections listed in couchbase.pool.prewarm are started at the beginning of the first request
+     */
+    function testPoolPrewarm() {
+        $docroot = sys_get_temp_dir() . '/' . $this->makeKey('prewarm');
+        mkdir($docroot);
+        file_put_contents("$docroot/stats.php", sprintf('<?php
+            $before = \Couchbase\Pool::stats();
+            $options = new \Couchbase\ClusterOptions();
+            $options->credentials(%s, %s);
+            $cluster = new \Couchbase\Cluster(%s, $options);
+            echo json_encode([$before, \Couchbase\Pool::stats()]);',
+            var_export($this->testUser, true), var_export($this->testPassword, true),
+            var_export($this->testDsn, true)));
+        $port = 20000 + getmypid() % 10000;
+        $prewarm = "{$this->testDsn}|{$this->testUser}|{$this->testPassword}";
+        $server = proc_open(sprintf('exec %s -d couchbase.pool.prewarm=%s -S 127.0.0.1:%d -t %s',
+                                    escapeshellarg(PHP_BINARY), escapeshellarg($prewarm), $port,
+                                    escapeshellarg($docroot)),
+                            [1 => ['file', '/dev/null', 'w'], 2 => ['file', '/dev/null', 'w']], $pipes);
+        try {
+            $first = null;
+            for ($i = 0; $i < 50 && $first === null; $i++) {
+                usleep(100000);
+                $body = @file_get_contents("http://127.0.0.1:$port/stats.php");
+                if ($body !== false) {
+                    $first = json_decode($body, true);
+                }
+            }
+            if ($first === null) {
+                $this->markTestSkipped('Cannot run the extension in PHP built-in web server');
+            }
+        } finally {
+            proc_terminate($server);
+            proc_close($server);
+            unlink("$docroot/stats.php");
+            rmdir($docroot);
+        }
+
+        // the prewarm has already put the connection into the pool, when the script of the first request starts
+        list($before, $after) = $first;
+        $this->assertEquals(1, $before['live']);
+        $this->assertEquals($before['hits'] + 1, $after['hits']);
+        $this->assertEquals($before['misses'], $after['misses']);
+    }
+
+    /**
+     * Test that phpinfo() does not reveal the passwords of couchbase.pool.prewarm
+     */
+    function testPoolPrewarmPasswordIsMasked() {
+        $prewarm = 'couchbase://127.0.0.1/default|Administrator|s3cret;couchbase://127.0.0.2|user';
+        $output = shell_exec(sprintf('%s -d couchbase.pool.prewarm=%s -r %s', escapeshellarg(PHP_BINARY),
+                                     escapeshellarg($prewarm), escapeshellarg('phpinfo(INFO_MODULES);')));
+        if (strpos($output, 'couchbase.pool.prewarm') === false) {
+            $this->markTestSkipped('The extension is not loaded by PHP CLI');
+        }
+        $this->assertNotContains('s3cret', $output);
+        $this->assertContains('couchbase://127.0.0.1/default|Administrator|***;couchbase://127.0.0.2|user', $output);
+    }
+
+    function testJsonLogLinesAreValidJson() {
+        foreach (['0', '65536'] as $bufferSize) {
+            $logFile = tempnam(sys_get_temp_dir(), 'pcbc-log');
+            shell_exec(sprintf('%s -d couchbase.log_format=json -d couchbase.log_buffer_size=%s -d error_log=%s ' .
+                               '-d date.timezone=Asia/Kolkata -r %s', escapeshellarg(PHP_BINARY), $bufferSize,
+                               escapeshellarg($logFile),
+                               escapeshellarg('\Couchbase\defaultDecoder("{", COUCHBASE_CFFMT_JSON, 0);')));
+            $lines = file($logFile, FILE_IGNORE_NEW_LINES | FILE_SKIP_EMPTY_LINES);
+            unlink($logFile);
+            if (empty($lines)) {
+                $this->markTestSkipped('The extension is not loaded by PHP CLI');
+            }
+            foreach ($lines as $line) {
+                $entry = json_decode($line, true);
+                $this->assertEquals(JSON_ERROR_NONE, json_last_error(), "Invalid JSON line: $line");
+                $this->assertStringEndsWith('+05:30', $entry['time']);
+            }
+        }
+    }
+
+    /**
+     * @depends testConnect
+     */
+    function testMetricsSnapshot($c) {
+        \Couchbase\Metrics::snapshot(true);
+        $key = $this->makeKey('metricsSnapshot');
+        $c->upsert($key, ['name' => 'bob']);
+        $c->get($key);
+        $c->get($key);
+
+        $snapshot = \Couchbase\Metrics::snapshot();
+        $this->assertEquals(1, $snapshot['upsert']['success']['count']);
+        $this->assertEquals(2, $snapshot['get']['success']['count']);
+        $this->assertLessThanOrEqual($snapshot['get']['success']['p99_us'], $snapshot['get']['success']['p50_us']);
+        $this->assertLessThanOrEqual($snapshot['get']['success']['max_us'], $snapshot['get']['success']['p99_us']);
+        $this->assertEmpty($snapshot['query']);
+    }
+
+    /**
+     * @depends testConnect
+     */
+    function testMetricsCoverBatchesAndFutures($c) {
+        \Couchbase\Metrics::snapshot(true);
+        $key1 = $this->makeKey('metricsBatch');
+        $key2 = $this->makeKey('metricsBatch');
+        $c->upsertMulti([$key1 => ['n' => 1], $key2 => ['n' => 2]]);
+        $c->getMulti([$key1, $key2]);
+        $c->upsertAsync($key1, ['n' => 3])->wait();
+        $c->getAsync($key1)->wait();
+
+        $snapshot = \Couchbase\Metrics::snapshot();
+        $this->assertEquals(3, $snapshot['upsert']['success']['count']);
+        $this->assertEquals(3, $snapshot['get']['success']['count']);
+    }
+
+    function testCompressionSampleSkipsRandomData() {
+        ini_set('couchbase.encoder.compression_sample', 256);
+        \Couchbase\Metrics::snapshot(true);
+        $options = ['cmprtype' => COUCHBASE_CMPRTYPE_FASTLZ, 'cmprthresh' => 0, 'cmprfactor' => 1.0];
+
+        $random = \Couchbase\basicEncoderV1(random_bytes(4096), $options);
+        $this->assertEquals(0, $random[1] & COUCHBASE_COMPRESSION_MCISCOMPRESSED);
+        $repeated = \Couchbase\basicEncoderV1(str_repeat('couchbase ', 400), $options);
+        $this->assertNotEquals(0, $repeated[1] & COUCHBASE_COMPRESSION_MCISCOMPRESSED);
+        ini_restore('couchbase.encoder.compression_sample');
+
+        $stats = \Couchbase\Metrics::snapshot()['compression'];
+        $this->assertEquals(2, $stats['attempts']);
+        $this->assertEquals(1, $stats['skipped']);
+        $this->assertEquals(1, $stats['compressed']);
+    }
+
+    function testDecompressionRejectsForgedSize() {
+        $methods = [
+            'zlib' => COUCHBASE_COMPRESSION_ZLIB,
+            'fastlz' => COUCHBASE_COMPRESSION_FASTLZ,
+            'lz4' => COUCHBASE_COMPRESSION_LZ4,
+            'zstd' => COUCHBASE_COMPRESSION_ZSTD,
+        ];
+        foreach ($methods as $name => $cmprflags) {
+            try {
+                $compressed = call_user_func("\\Couchbase\\{$name}Compress", str_repeat('couchbase ', 100));
+            } catch (\Exception $e) {
+                continue; /* the library was not available when the extension was built */
+            }
+            $this->assertEquals(str_repeat('couchbase ', 100), call_user_func("\\Couchbase\\{$name}Decompress", $compressed));
+
+            $forged = pack('V', 0xfffffff0) . substr($compressed, 4);
+            foreach (['abc', $forged] as $bytes) {
+                $this->wrapException(function() use($name, $bytes) {
+                    call_user_func("\\Couchbase\\{$name}Decompress", $bytes);
+                }, 'Exception', NULL, '/Invalid size/');
+                $flags = COUCHBASE_COMPRESSION_MCISCOMPRESSED | $cmprflags;
+                $this->assertNull(\Couchbase\defaultDecoder($bytes, $flags, 0));
+            }
+        }
+    }
+
+    function testBinarySerializersRoundTrip() {
+        $formats = [];
+        if (\Couchbase\HAVE_IGBINARY) {
+            $formats[COUCHBASE_SERTYPE_IGBINARY] = COUCHBASE_VAL_IS_IGBINARY;
+        }
+        if (\Couchbase\HAVE_MSGPACK) {
+            $formats[COUCHBASE_SERTYPE_MSGPACK] = COUCHBASE_VAL_IS_MSGPACK;
+        }
+        if (empty($formats)) {
+            $this->markTestSkipped('Neither igbinary nor msgpack serializer is available');
+        }
+
+        $value = ['name' => 'bob', 'tags' => ['a', 'b'], 'nested' => ['level' => 2, 'ratio' => 0.5]];
+        foreach ($formats as $sertype => $valtype) {
+            $res = \Couchbase\basicEncoderV1($value, ['sertype' => $sertype]);
+            $this->assertEquals($valtype, $res[1] & COUCHBASE_VAL_MASK);
+            $this->assertEquals(COUCHBASE_CFFMT_PRIVATE, $res[1] & COUCHBASE_CFFMT_MASK);
+            $this->assertEquals($value, \Couchbase\basicDecoderV1($res[0], $res[1], $res[2]));
+        }
+    }
+
     /**
      * Test basic upsert
      *
@@ -73,6 +273,21 @@ class BucketTest extends CouchbaseTestCase {
         return $key;
     }
 
+    /**
+     * The decoded body is cached, and must not be affected by modifications of the returned value
+     *
+     * @depends testConnect
+     * @depends testBasicUpsert
+     */
+    function testContentIsDecodedOnce($c, $key) {
+        $res = $c->get($key);
+
+        $content = $res->content();
+        $content['name'] = 'alice';
+        $this->assertEquals(['name' => 'bob'], $res->content());
+        $this->assertEquals(['name' => 'bob'], $res->content());
+    }
+
     /**
      * Test basic remove
      *
@@ -88,6 +303,148 @@ class BucketTest extends CouchbaseTestCase {
         }, '\Couchbase\KeyNotFoundException', COUCHBASE_ERR_DOCUMENT_NOT_FOUND);
     }
 
+    /**
+     * Test fetching several keys at once
+     *
+     * @depends testConnect
+     */
+    function testGetMulti($c) {
+        $key1 = $this->makeKey('getMulti1');
+        $key2 = $this->makeKey('getMulti2');
+        $missing = $this->makeKey('getMultiMissing');
+        $c->upsert($key1, ['name' => 'alice']);
+        $c->upsert($key2, ['name' => 'bob']);
+
+        $res = $c->getMulti([$key1, $key2, $missing]);
+        $this->assertCount(3, $res);
+        $this->assertEquals(['name' => 'alice'], $res[$key1]->content());
+        $this->assertEquals(['name' => 'bob'], $res[$key2]->content());
+        $this->assertInstanceOf('\Couchbase\KeyNotFoundException', $res[$missing]);
+        $this->assertEquals(COUCHBASE_ERR_DOCUMENT_NOT_FOUND, $res[$missing]->getCode());
+    }
+
+    /**
+     * Test storing several keys at once
+     *
+     * @depends testConnect
+     */
+    function testStoreMulti($c) {
+        $key1 = $this->makeKey('storeMulti1');
+        $key2 = $this->makeKey('storeMulti2');
+
+        $res = $c->insertMulti([$key1 => ['name' => 'alice']]);
+        $this->assertNotNull($res[$key1]->cas());
+
+        $res = $c->upsertMulti([$key1 => ['name' => 'bob'], $key2 => ['name' => 'carol']]);
+        $this->assertCount(2, $res);
+        $this->assertNotNull($res[$key1]->cas());
+        $this->assertNotNull($res[$key2]->cas());
+
+        $res = $c->insertMulti([$key1 => 'dave']);
+        $this->assertInstanceOf('\Couchbase\KeyExistsException', $res[$key1]);
+
+        $res = $c->getMulti([$key1, $key2]);
+        $this->assertEquals(['name' => 'bob'], $res[$key1]->content());
+        $this->assertEquals(['name' => 'carol'], $res[$key2]->content());
+    }
+
+    /**
+     * Test exception of the transcoder fails only its document of the batch
+     */
+    function testStoreMultiKeepsTranscoderException() {
+        $options = new \Couchbase\ClusterOptions();
+        $options->credentials($this->testUser, $this->testPassword);
+        $bucket = (new \Couchbase\Cluster($this->testDsn, $options))->bucket($this->testBucket);
+        $bucket->setTranscoder(function ($value) {
+            if ($value == 'poison') {
+                throw new \InvalidArgumentException('Cannot encode poison');
+            }
+            return \Couchbase\defaultEncoder($value);
+        }, '\Couchbase\defaultDecoder');
+        $c = $bucket->defaultCollection();
+
+        $key1 = $this->makeKey('storeMultiEncoder1');
+        $key2 = $this->makeKey('storeMultiEncoder2');
+        $key3 = $this->makeKey('storeMultiEncoder3');
+        $res = $c->upsertMulti([$key1 => 'alice', $key2 => 'poison', $key3 => 'carol']);
+        $this->assertCount(3, $res);
+        $this->assertNotNull($res[$key1]->cas());
+        $this->assertInstanceOf('\InvalidArgumentException', $res[$key2]);
+        $this->assertEquals('Cannot encode poison', $res[$key2]->getMessage());
+        $this->assertNotNull($res[$key3]->cas());
+    }
+
+    /**
+     * Test touching and removing several keys at once
+     *
+     * @depends testConnect
+     */
+    function testTouchRemoveMulti($c) {
+        $key1 = $this->makeKey('removeMulti1');
+        $key2 = $this->makeKey('removeMulti2');
+        $missing = $this->makeKey('removeMultiMissing');
+        $c->upsertMulti([$key1 => 'foo', $key2 => 'bar']);
+
+        $res = $c->touchMulti([$key1, $key2, $missing], 60);
+        $this->assertNotNull($res[$key1]->cas());
+        $this->assertNotNull($res[$key2]->cas());
+        $this->assertInstanceOf('\Couchbase\KeyNotFoundException', $res[$missing]);
+
+        $res = $c->existsMulti([$key1, $key2]);
+        $this->assertTrue($res[$key1]->exists());
+        $this->assertTrue($res[$key2]->exists());
+
+        $res = $c->removeMulti([$key1, $missing, $key2]);
+        $this->assertCount(3, $res);
+        $this->assertNotNull($res[$key1]->cas());
+        $this->assertNotNull($res[$key2]->cas());
+        $this->assertInstanceOf('\Couchbase\KeyNotFoundException', $res[$missing]);
+    }
+
+    /**
+     * The encoded value must be handed to libcouchbase without intermediate copies in the PHP heap
+     *
+     * @depends testConnect
+     */
+    function testUpsertDoesNotCopyValue($c) {
+        if (!function_exists('memory_reset_peak_usage')) {
+            $this->markTestSkipped('memory_reset_peak_usage() requires PHP 8.2');
+        }
+        $key = $this->makeKey('upsertNoCopy');
+        $size = 4 * 1024 * 1024;
+        $value = str_repeat('x', $size);
+
+        memory_reset_peak_usage();
+        $before = memory_get_usage();
+        $c->upsert($key, $value);
+        $this->assertLessThan($size / 2, memory_get_peak_usage() - $before);
+
+        $res = $c->get($key);
+        $this->assertEquals($size, strlen($res->content()));
+    }
+
+    /**
+     * @depends testConnect
+     */
+    function testAsync($c) {
+        $key = $this->makeKey('async');
+        $missing = $this->makeKey('asyncMissing');
+
+        $res = $c->upsertAsync($key, ['answer' => 42])->wait();
+        $this->assertNotNull($res->cas());
+
+        $found = $c->getAsync($key);
+        $notFound = $c->getAsync($missing);
+        $this->assertEquals(['answer' => 42], $found->wait()->content());
+        $this->assertTrue($notFound->isReady());
+        try {
+            $notFound->wait();
+            $this->fail("expected exception");
+        } catch (\Couchbase\KeyNotFoundException $e) {
+            $this->assertEquals(COUCHBASE_ERR_DOCUMENT_NOT_FOUND, $e->getCode());
+        }
+    }
+
     /**
      * Test basic counter operations w/ an initial value
      *
@@ -174,6 +531,87 @@ class BucketTest extends CouchbaseTestCase {
         }, '\Couchbase\KeyExistsException', COUCHBASE_KEYALREADYEXISTS);
     }
 
+    /**
+     * Returns scan vectors of the MutationState as they are sent to the query service
+     */
+    private function scanVectors($state) {
+        $options = (new \Couchbase\QueryOptions())->consistentWith($state);
+        $property = new \ReflectionProperty($options, 'consistent_with');
+        $property->setAccessible(true);
+        return json_decode($property->getValue($options), true);
+    }
+
+    private function decodeNumber($encoded) {
+        return unpack('P', base64_decode($encoded))[1];
+    }
+
+    /**
+     * Test MutationState keeps only the latest position of the partition
+     *
+     * @depends testConnect
+     */
+    function testMutationStateKeepsLatestPosition($c) {
+        $key = $this->makeKey('mutationState');
+
+        $first = $c->upsert($key, 'dog');
+        $second = $c->upsert($key, 'cat');
+        if ($first->mutationToken() == null) {
+            $this->markTestSkipped('Mutation tokens are not enabled');
+        }
+        $token = $second->mutationToken();
+        $this->assertEquals($first->mutationToken()->partitionId(), $token->partitionId());
+
+        $state = new \Couchbase\MutationState();
+        for ($i = 0; $i < 100; $i++) {
+            $state->add($second)->add($first);
+        }
+        $this->assertEquals(
+            [$token->bucketName() => [
+                $token->partitionId() => [
+                    $this->decodeNumber($token->sequenceNumber()),
+                    (string)$this->decodeNumber($token->partitionUuid()),
+                ],
+            ]],
+            $this->scanVectors($state)
+        );
+    }
+
+    /**
+     * Test MutationState replaces the position of the partition, which has new UUID after failover
+     */
+    function testMutationStateReplacesPositionAfterFailover() {
+        $result = function ($uuid, $seqno) {
+            $token = new class($uuid, $seqno) implements \Couchbase\MutationToken {
+                private $uuid;
+                private $seqno;
+                public function __construct($uuid, $seqno) {
+                    $this->uuid = $uuid;
+                    $this->seqno = $seqno;
+                }
+                public function bucketName(): ?string { return 'default'; }
+                public function partitionId(): ?int { return 42; }
+                public function partitionUuid(): ?string { return base64_encode(pack('P', $this->uuid)); }
+                public function sequenceNumber(): ?string { return base64_encode(pack('P', $this->seqno)); }
+            };
+            return new class($token) implements \Couchbase\MutationResult {
+                private $token;
+                public function __construct($token) { $this->token = $token; }
+                public function cas(): ?string { return null; }
+                public function mutationToken(): ?\Couchbase\MutationToken { return $this->token; }
+            };
+        };
+
+        $state = new \Couchbase\MutationState();
+        $state->add($result(1111, 500))->add($result(1111, 400));
+        $this->assertEquals(['default' => [42 => [500, '1111']]], $this->scanVectors($state));
+
+        $state->add($result(2222, 10));
+        $this->assertEquals(['default' => [42 => [10, '2222']]], $this->scanVectors($state));
+
+        $state->add($result(2222, 5));
+        $this->assertEquals(['default' => [42 => [10, '2222']]], $this->scanVectors($state));
+    }
+
     /**
      * Test Locks work
      *
@@ -102,4 +102,86 @@ class N1qlQueryTest extends CouchbaseTestCase {
         }
         $this->assertTrue($found, "The record \"$key\" is missing in the result set");
     }
+
+    function testStreaming() {
+        if ($this->usingMock()) {
+            $this->markTestSkipped('N1QL queries are not supported by the CouchbaseMock');
+        }
+        $key = $this->makeKey("n1qlStreaming");
+        $bucketName = $this->testBucket;
+        $collection = $this->cluster->bucket($bucketName)->defaultCollection();
+        $collection->upsert($key, ["bar" => 42]);
+
+        $options = (new \Couchbase\QueryOptions())
+                    ->scanConsistency(\Couchbase\QueryScanConsistency::REQUEST_PLUS)
+                    ->streaming(true, 10);
+        $res = $this->cluster->query("SELECT * FROM `$bucketName` USE KEYS \"$key\"", $options);
+        $this->assertNull($res->rows());
+        $rows = [];
+        foreach ($res as $row) {
+            $rows[] = $row;
+        }
+        $this->assertCount(1, $rows);
+        $this->assertEquals(42, $rows[0][$bucketName]['bar']);
+        $this->assertEquals("success", $res->metaData()->status());
+    }
+
+    function testStreamingIsNotDrainedByOtherOperations() {
+        if ($this->usingMock()) {
+            $this->markTestSkipped('N1QL queries are not supported by the CouchbaseMock');
+        }
+        $key = $this->makeKey("n1qlStreamingUpsert");
+        $collection = $this->cluster->bucket($this->testBucket)->defaultCollection();
+
+        $res = $this->cluster->query("SELECT RAW v FROM ARRAY_RANGE(0, 10000) AS v",
+                                     (new \Couchbase\QueryOptions())->streaming(true, 10));
+        $property = new \ReflectionProperty($res, 'stream');
+        $property->setAccessible(true);
+        $stream = $property->getValue($res);
+        $count = 0;
+        $maxBuffered = 0;
+        foreach ($res as $row) {
+            /* the upsert waits on the bucket connection, which must not receive the rest of the rows */
+            $collection->upsert($key, $row);
+            preg_match('/\[buffered\] => (\d+)/', print_r($stream, true), $matches);
+            $maxBuffered = max($maxBuffered, (int)$matches[1]);
+            $count++;
+        }
+        $this->assertEquals(10000, $count);
+        $this->assertLessThan(5000, $maxBuffered);
+    }
+
+    function testAsync() {
+        if ($this->usingMock()) {
+            $this->markTestSkipped('N1QL queries are not supported by the CouchbaseMock');
+        }
+        $key = $this->makeKey("n1qlAsync");
+        $bucketName = $this->testBucket;
+        $bucket = $this->cluster->bucket($bucketName);
+        $collection = $bucket->defaultCollection();
+        $collection->upsert($key, ["bar" => 42]);
+
+        \Couchbase\Metrics::snapshot(true);
+        $options = (new \Couchbase\QueryOptions())->scanConsistency(\Couchbase\QueryScanConsistency::REQUEST_PLUS);
+        $futures = [
+            'query' => $this->cluster->queryAsync("SELECT * FROM `$bucketName` USE KEYS \"$key\"", $options),
+            'get' => $collection->getAsync($key),
+            'invalid' => $this->cluster->queryAsync("SELEC 42"),
+        ];
+        $ready = $bucket->waitAny($futures);
+        $this->assertArrayHasKey($ready, $futures);
+        $this->assertTrue($futures[$ready]->isReady());
+
+        $results = $bucket->wait($futures);
+        $this->assertEquals(42, $results['query']->rows()[0][$bucketName]['bar']);
+        $this->assertEquals("success", $results['query']->metaData()->status());
+        $this->assertEquals(["bar" => 42], $results['get']->content());
+        $this->assertInstanceOf('\Couchbase\HttpException', $results['invalid']);
+        $this->assertEquals(3000, $results['invalid']->getCode());
+
+        $snapshot = \Couchbase\Metrics::snapshot();
+        $this->assertEquals(1, $snapshot['query']['success']['count']);
+        $this->assertEquals(1, $snapshot['query']['error']['count']);
+        $this->assertEquals(1, $snapshot['get']['success']['count']);
+    }
 }
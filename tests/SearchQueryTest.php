@@ -57,6 +57,13 @@ class SearchQueryTest extends CouchbaseTestCase {
         $this->assertEquals('{"match":"foo"}', $result);
     }
 
+    function testStreamingIsNotSerialized() {
+        $options = (new \Couchbase\SearchOptions())->limit(10)->streaming(true, 100);
+        $result = json_encode($options);
+        $this->assertEquals(JSON_ERROR_NONE, json_last_error());
+        $this->assertEquals('{"size":10}', $result);
+    }
+
     function testAdvancedSort() {
         $options = new \Couchbase\SearchOptions();
         $options->sort([
@@ -80,4 +87,76 @@ class SearchQueryTest extends CouchbaseTestCase {
                                 $result);
 
     }
+
+    private function connect() {
+        $options = new \Couchbase\ClusterOptions();
+        $options->credentials($this->testUser, $this->testPassword);
+        return new \Couchbase\Cluster($this->testDsn, $options);
+    }
+
+    function testStreamingHits() {
+        if ($this->usingMock()) {
+            $this->markTestSkipped('Search queries are not supported by the CouchbaseMock');
+        }
+        $cluster = $this->connect();
+        $bucket = $cluster->bucket($this->testBucket);
+        $indexName = 'pcbc-streaming-' . getmypid();
+        $definition = json_encode([
+            'type' => 'fulltext-index',
+            'name' => $indexName,
+            'sourceType' => 'couchbase',
+            'sourceName' => $this->testBucket,
+        ]);
+        $manager = $bucket->manager()->searchIndexManager();
+        $manager->createIndex($indexName, $definition);
+
+        try {
+            $tag = $this->makeKey('ftsStreaming');
+            $collection = $bucket->defaultCollection();
+            for ($i = 0; $i < 5; $i++) {
+                $collection->upsert("$tag-$i", ['tag' => $tag]);
+            }
+
+            $query = new \Couchbase\MatchSearchQuery($tag);
+            $hits = [];
+            for ($attempt = 0; $attempt < 60 && count($hits) < 5; $attempt++) {
+                if ($attempt > 0) {
+                    sleep(1);
+                }
+                $hits = [];
+                try {
+                    $res = $cluster->searchQuery($indexName, $query, (new \Couchbase\SearchOptions())->streaming(true, 2));
+                    $this->assertNull($res->rows());
+                    foreach ($res as $hit) {
+                        $hits[] = $hit['id'];
+                    }
+                } catch (\Couchbase\BaseException $e) {
+                    /* the index is not ready yet */
+                }
+            }
+            if (count($hits) < 5) {
+                $this->markTestSkipped('The documents have not been indexed in time');
+            }
+            sort($hits);
+            $this->assertEquals(["$tag-0", "$tag-1", "$tag-2", "$tag-3", "$tag-4"], $hits);
+            $this->assertEquals(5, $res->metaData()->totalHits());
+        } finally {
+            $manager->deleteIndex($indexName);
+        }
+    }
+
+    function testStreamingErrorCarriesServerMessage() {
+        if ($this->usingMock()) {
+            $this->markTestSkipped('Search queries are not supported by the CouchbaseMock');
+        }
+        $cluster = $this->connect();
+        $indexName = 'pcbc-missing-' . getmypid();
+        $options = (new \Couchbase\SearchOptions())->streaming(true, 2);
+
+        $res = $cluster->searchQuery($indexName, new \Couchbase\MatchAllSearchQuery(), $options);
+        $this->wrapException(function() use($res) {
+            foreach ($res as $hit) {
+            }
+        }, '\Couchbase\BaseException', NULL, "/$indexName/");
+    }
 }
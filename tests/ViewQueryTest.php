@@ -99,4 +99,43 @@ class ViewQueryTest extends CouchbaseTestCase {
 
         $this->manager->dropDesignDocument($ddocName);
     }
+
+    function testStreamingWithDocuments() {
+        if ($this->usingMock()) {
+            $this->markTestSkipped('View consistency is not supported by the CouchbaseMock');
+        }
+        $ddocName = $this->makeKey('testStreaming');
+        $ddoc = [
+            'views' => [
+                'test' => [
+                    'map' => "function(doc, meta) { if (meta.id.startsWith(\"{$ddocName}\")) emit(meta.id); }"
+                ],
+            ]
+        ];
+        $this->manager->upsertDesignDocument($ddocName, $ddoc);
+        sleep(1); // give design document a second to settle
+
+        $keys = [];
+        for ($i = 0; $i < 5; $i++) {
+            $keys[] = $key = $this->makeKey($ddocName);
+            $this->collection->upsert($key, ['foo' => $i]);
+        }
+        sort($keys);
+
+        $options = new \Couchbase\ViewOptions();
+        $options->scanConsistency(\Couchbase\ViewScanConsistency::REQUEST_PLUS);
+        $options->includeDocuments(true);
+        $options->streaming(true, 2);
+        $res = $this->bucket->viewQuery($ddocName, 'test', $options);
+        $this->assertNull($res->rows());
+        $ids = [];
+        foreach ($res as $row) {
+            $ids[] = $row->id();
+            $this->assertArrayHasKey('foo', $row->document());
+        }
+        $this->assertEquals($keys, $ids);
+        $this->assertEquals(5, $res->metaData()->totalRows());
+
+        $this->manager->dropDesignDocument($ddocName);
+    }
 }
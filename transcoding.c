@@ -18,6 +18,33 @@
 
 #define LOGARGS(lvl) LCB_LOG_##lvl, NULL, "pcbc/transcoding", __FILE__, __LINE__
 
+static zend_bool pcbc_is_internal_function(zval *callable, void (*handler)(INTERNAL_FUNCTION_PARAMETERS))
+{
+    zend_fcall_info_cache fcc;
+
+    if (!zend_is_callable_ex(callable, NULL, 0, NULL, &fcc, NULL)) {
+        return 0;
+    }
+    return fcc.function_handler && fcc.function_handler->type == ZEND_INTERNAL_FUNCTION &&
+           fcc.function_handler->internal_function.handler == handler;
+}
+
+void pcbc_bucket_set_transcoder(pcbc_bucket_t *bucket, zval *encoder, zval *decoder TSRMLS_DC)
+{
+    if (!Z_ISUNDEF(bucket->encoder)) {
+        zval_ptr_dtor(&bucket->encoder);
+        ZVAL_UNDEF(&bucket->encoder);
+    }
+    ZVAL_ZVAL(&bucket->encoder, encoder, 1, 0);
+    bucket->default_encoder = pcbc_is_internal_function(encoder, ZEND_FN(defaultEncoder));
+
+    if (!Z_ISUNDEF(bucket->decoder)) {
+        zval_ptr_dtor(&bucket->decoder);
+        ZVAL_UNDEF(&bucket->decoder);
+    }
+    ZVAL_ZVAL(&bucket->decoder, decoder, 1, 0);
+}
+
 int pcbc_decode_value(zval *return_value, pcbc_bucket_t *bucket, const char *bytes, int bytes_len, uint32_t flags,
                       uint8_t datatype TSRMLS_DC)
 {
@@ -40,12 +67,32 @@ int pcbc_decode_value(zval *return_value, pcbc_bucket_t *bucket, const char *byt
     return rv;
 }
 
-int pcbc_encode_value(pcbc_bucket_t *bucket, zval *value, void **bytes, lcb_size_t *nbytes, lcb_uint32_t *flags,
+/*
+ * On success *bytes holds a reference to the encoded string, which has to be released by the caller once the
+ * command has been scheduled (libcouchbase copies the value into its own buffers).
+ */
+int pcbc_encode_value(pcbc_bucket_t *bucket, zval *value, zend_string **bytes, lcb_uint32_t *flags,
                       uint8_t *datatype TSRMLS_DC)
 {
     zval retval;
     int rv;
 
+    if (bucket->default_encoder) {
+        uint32_t encoded_flags = 0;
+
+        ZVAL_UNDEF(&retval);
+        pcbc_basic_encoder_v1(value, PCBCG(enc_format_i), PCBCG(enc_cmpr_i), PCBCG(enc_cmpr_threshold),
+                              PCBCG(enc_cmpr_factor), &retval, &encoded_flags TSRMLS_CC);
+        if (Z_TYPE(retval) != IS_STRING) {
+            zval_ptr_dtor(&retval);
+            return FAILURE;
+        }
+        *bytes = Z_STR(retval);
+        *flags = encoded_flags;
+        *datatype = 0;
+        return SUCCESS;
+    }
+
     ZVAL_UNDEF(&retval);
     ZVAL_NULL(&retval);
 
@@ -77,8 +124,7 @@ int pcbc_encode_value(pcbc_bucket_t *bucket, zval *value, void **bytes, lcb_size
             return FAILURE;
         }
 
-        *nbytes = Z_STRLEN_P(zbytes);
-        *bytes = estrndup(Z_STRVAL_P(zbytes), *nbytes);
+        *bytes = zend_string_copy(Z_STR_P(zbytes));
         *flags = (uint32_t)Z_LVAL_P(zflags);
         *datatype = (uint8_t)Z_LVAL_P(zdatatype);
     }